@@ -4,20 +4,32 @@ out vec4 FragColor;
 // Entradas del Vertex Shader
 in vec3 FragPos;
 in vec2 TexCoords;
+#ifdef NORMAL_MAP
 in mat3 TBN;
+#else
+in vec3 Normal;
+#endif
+flat in float Ao;   // oclusión ambiental por instancia
 
 // Mapas de Texturas PBR
 uniform sampler2D albedoMap;
 uniform sampler2D normalMap;
+#if defined(ORM_MAP) || defined(METALLIC_ROUGHNESS_MAP)
+// r = oclusión, g = rugosidad, b = metálico (MaterialLayout::PackedORM). Con
+// METALLIC_ROUGHNESS_MAP (MaterialLayout::MetallicRoughness) el canal r no se usa.
+uniform sampler2D ormMap;
+#else
 uniform sampler2D metallicMap;
 uniform sampler2D roughnessMap;
-uniform float     ao;
+#endif
+// Factores del material (Material::baseColorFactor...): multiplican lo leído de los mapas
+uniform vec3 baseColorFactor = vec3(1.0);
+uniform float metallicFactor = 1.0;
+uniform float roughnessFactor = 1.0;
 
-// Uniforms de la escena
-uniform vec3 viewPos;
-#define NR_LIGHTS 1 
-uniform vec3 lightPositions[NR_LIGHTS];
-uniform vec3 lightColors[NR_LIGHTS];
+// Datos de la escena compartidos por todos los programas (puntos de enlace 0 y 1)
+#include "common/frame.glsl"
+#include "common/lights.glsl"
 
 const float PI = 3.14159265359;
 
@@ -53,31 +65,77 @@ vec3 fresnelSchlick(float cosTheta, vec3 F0) {
     return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
 }
 
+// Dirección hacia la luz (L) y cuánto llega de ella a FragPos: 1/d² recortado
+// suavemente a cero en el alcance y, en los focos, el cono.
+float lightAttenuation(PackedLight light, out vec3 L) {
+    int type = int(light.direction.w);
+    if (type == LIGHT_DIRECTIONAL) {
+        L = -light.direction.xyz;
+        return 1.0;
+    }
+
+    vec3 toLight = light.position.xyz - FragPos;
+    float distance2 = dot(toLight, toLight);
+    L = toLight * inversesqrt(distance2);
+    float attenuation = 1.0 / distance2;
+    if (light.position.w > 0.0) {
+        float ratio = distance2 / (light.position.w * light.position.w);
+        float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+        attenuation *= window * window;
+    }
+    if (type == LIGHT_SPOT)
+        attenuation *= smoothstep(light.cone.y, light.cone.x, dot(-L, light.direction.xyz));
+    return attenuation;
+}
+
 
 void main()
 {		
     // Obtener propiedades del material usando las coordenadas de textura originales
-    vec3 albedo     = pow(texture(albedoMap, TexCoords).rgb, vec3(2.2));
+    vec3 albedo     = pow(texture(albedoMap, TexCoords).rgb, vec3(2.2)) * baseColorFactor;
+#ifdef ORM_MAP
+    vec3 orm        = texture(ormMap, TexCoords).rgb;
+    float ao        = orm.r * Ao;
+    float roughness = orm.g;
+    float metallic  = orm.b;
+#elif defined(METALLIC_ROUGHNESS_MAP)
+    vec2 mr         = texture(ormMap, TexCoords).gb;
+    float ao        = Ao;
+    float roughness = mr.x;
+    float metallic  = mr.y;
+#else
     float metallic  = texture(metallicMap, TexCoords).r;
     float roughness = texture(roughnessMap, TexCoords).r;
-
-    vec3 normal_tangent_space = texture(normalMap, TexCoords).rgb * 2.0 - 1.0;
+    float ao        = Ao;
+#endif
+    metallic  *= metallicFactor;
+    roughness *= roughnessFactor;
+
+#ifdef NORMAL_MAP
+    // Solo se leen x e y: z se reconstruye, así sirven también los normal maps BC5 de
+    // dos canales que genera chaos-texcook.
+    vec2 normal_xy = texture(normalMap, TexCoords).rg * 2.0 - 1.0;
+    vec3 normal_tangent_space = vec3(normal_xy, sqrt(max(1.0 - dot(normal_xy, normal_xy), 0.0)));
     vec3 N = normalize(TBN * normal_tangent_space);
+#else
+    vec3 N = normalize(Normal);
+#endif
     
-    vec3 V = normalize(viewPos - FragPos);
+    vec3 V = normalize(viewPos.xyz - FragPos);
 
     vec3 F0 = vec3(0.04); 
     F0 = mix(F0, albedo, metallic);
 
-    // Bucle de luces
+    // Bucle de luces: tantas como haya en LightData este frame
     vec3 Lo = vec3(0.0);
-    for(int i = 0; i < NR_LIGHTS; ++i) 
+    for(int i = 0; i < lightCount; ++i) 
     {
-        vec3 L = normalize(lightPositions[i] - FragPos);
+        vec3 L;
+        float attenuation = lightAttenuation(lights[i], L);
+        if (attenuation <= 0.0)
+            continue;
         vec3 H = normalize(V + L);
-        float distance = length(lightPositions[i] - FragPos);
-        float attenuation = 1.0 / (distance * distance);
-        vec3 radiance = lightColors[i] * attenuation;
+        vec3 radiance = lights[i].color.rgb * attenuation;
 
         float NDF = DistributionGGX(N, H, roughness);
         float G   = GeometrySmith(N, V, L, roughness);
@@ -1,29 +1,37 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aTexCoords;
-layout (location = 3) in vec3 aTangent;
+#include "common/vertex.glsl"
 
 out vec3 FragPos;
 out vec2 TexCoords;
+#ifdef NORMAL_MAP
 out mat3 TBN;
+#else
+out vec3 Normal;
+#endif
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "common/transform.glsl"
+
+// instanceParams.x: oclusión ambiental
+flat out float Ao;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    TexCoords = aTexCoords;
+    vec4 worldPos = worldPosition(vertexPosition());
+    FragPos = worldPos.xyz;
+    TexCoords = vertexTexCoords();
+    Ao = instanceParams.x;
 
-    vec3 T = normalize(mat3(model) * aTangent);
-    vec3 N = normalize(mat3(model) * aNormal);
+    vec3 N = normalize(mat3(instanceModel) * vertexNormal());
+#ifdef NORMAL_MAP
+    vec4 tangent = vertexTangent();
+    vec3 T = normalize(mat3(instanceModel) * tangent.xyz);
     T = normalize(T - dot(T, N) * N);
-    vec3 B = cross(N, T);
+    vec3 B = cross(N, T) * tangent.w;
     
     TBN = mat3(T, B, N);
+#else
+    Normal = N;
+#endif
 
-    // CORRECCIÓN: Usar el método estándar para calcular la posición en el espacio de recorte.
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * worldPos;
 }
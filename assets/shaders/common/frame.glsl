@@ -0,0 +1,8 @@
+// Datos por frame compartidos por todos los programas (punto de enlace 0).
+// Espejo de FrameData en src/UniformBuffer.h.
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+};
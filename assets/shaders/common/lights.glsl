@@ -0,0 +1,20 @@
+// Luces de la escena (punto de enlace 1). Espejo de LightData en src/UniformBuffer.h;
+// MAX_LIGHTS lo inyecta el preprocesador desde el mismo valor que usa C++.
+struct PackedLight
+{
+    vec4 position;      // xyz en mundo, w alcance (0 = sin límite)
+    vec4 direction;     // xyz hacia donde apunta, w tipo (LIGHT_*)
+    vec4 color;         // rgb color por intensidad, w 1 si proyecta sombras
+    vec4 cone;          // x coseno del cono interior, y del exterior
+};
+
+// LightType en src/Components.h.
+#define LIGHT_POINT 0
+#define LIGHT_SPOT 1
+#define LIGHT_DIRECTIONAL 2
+
+layout (std140) uniform LightData
+{
+    int lightCount;
+    PackedLight lights[MAX_LIGHTS];
+};
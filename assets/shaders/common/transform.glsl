@@ -0,0 +1,17 @@
+// Transformación estándar objeto -> recorte usada por los shaders de malla.
+#include "common/frame.glsl"
+
+// Datos por instancia (ver InstanceData en src/RenderQueue.h). La matriz ocupa las
+// ubicaciones 4-7; 'instanceParams' depende del programa.
+layout (location = 4) in mat4 instanceModel;
+layout (location = 8) in vec4 instanceParams;
+
+vec4 worldPosition(vec3 localPosition)
+{
+    return instanceModel * vec4(localPosition, 1.0);
+}
+
+vec4 clipPosition(vec3 localPosition)
+{
+    return projection * view * worldPosition(localPosition);
+}
@@ -0,0 +1,33 @@
+// Entrada de vértices de malla (ver VertexFormat en src/Mesh.h). Por defecto se lee el
+// formato comprimido; FLOAT_VERTEX selecciona el de floats sin comprimir.
+#ifdef FLOAT_VERTEX
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in vec4 aTangent;
+
+vec3 vertexPosition() { return aPos; }
+vec3 vertexNormal() { return aNormal; }
+vec4 vertexTangent() { return aTangent; }
+vec2 vertexTexCoords() { return aTexCoords; }
+#else
+layout (location = 0) in vec4 aPackedPos;       // unorm16 en la caja; w: signo de la tangente
+layout (location = 1) in vec4 aPackedFrame;     // snorm16: xy normal, zw tangente (octaédricas)
+layout (location = 2) in vec2 aTexCoords;       // half
+// Valores constantes por malla, fijados al cambiar de malla.
+layout (location = 9) in vec3 meshBoundsMin;
+layout (location = 10) in vec3 meshBoundsExtent;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (v.z < 0.0)
+        v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(v);
+}
+
+vec3 vertexPosition() { return meshBoundsMin + aPackedPos.xyz * meshBoundsExtent; }
+vec3 vertexNormal() { return octDecode(aPackedFrame.xy); }
+vec4 vertexTangent() { return vec4(octDecode(aPackedFrame.zw), aPackedPos.w > 0.5 ? 1.0 : -1.0); }
+vec2 vertexTexCoords() { return aTexCoords; }
+#endif
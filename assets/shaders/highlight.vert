@@ -1,11 +1,9 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
+#include "common/vertex.glsl"
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "common/transform.glsl"
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = clipPosition(vertexPosition());
 }
@@ -1,11 +1,13 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
+#include "common/vertex.glsl"
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "common/transform.glsl"
+
+// instanceParams.rgb: color de la luz
+flat out vec3 LightColor;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    LightColor = instanceParams.rgb;
+    gl_Position = clipPosition(vertexPosition());
 }
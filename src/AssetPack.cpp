@@ -0,0 +1,285 @@
+#include "AssetPack.h"
+#include "JobSystem.h"
+#include "Lz4.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    // Entradas mayores no caben en los campos de 32 bits de AssetPackEntry.
+    const uint64_t MAX_ENTRY_SIZE = 0xFFFFFFFFull;
+
+    uint64_t align(uint64_t offset)
+    {
+        return (offset + ASSET_PACK_ALIGNMENT - 1) & ~(uint64_t)(ASSET_PACK_ALIGNMENT - 1);
+    }
+
+    // Contenido de una entrada ya decidido: comprimido en memoria o, con Store, se copia
+    // del archivo fuente al escribir el paquete.
+    struct PreparedEntry {
+        uint64_t size = 0;
+        PackCompression compression = PackCompression::Store;
+        std::vector<uint8_t> compressed;
+        std::string error;
+    };
+
+    void prepare(const AssetPackSource& source, PreparedEntry& entry)
+    {
+        MappedFile file;
+        if (!file.open(source.path))
+        {
+            entry.error = "cannot open " + source.path;
+            return;
+        }
+        entry.size = file.size();
+        if (entry.size > MAX_ENTRY_SIZE)
+        {
+            entry.error = source.path + " is larger than 4 GB";
+            return;
+        }
+        if (source.store || entry.size == 0)
+            return;
+
+        entry.compressed.resize(Lz4::compressBound(file.size()));
+        const size_t compressedSize = Lz4::compress(file.data(), file.size(), entry.compressed.data(), entry.compressed.size());
+        if (compressedSize > 0 && compressedSize <= file.size() - file.size() / 8)
+        {
+            entry.compressed.resize(compressedSize);
+            entry.compressed.shrink_to_fit();
+            entry.compression = PackCompression::Lz4;
+        }
+        else
+        {
+            entry.compressed = std::vector<uint8_t>();
+        }
+    }
+}
+
+std::string AssetPack::normalizePath(const std::string& path)
+{
+    std::string normalized;
+    normalized.reserve(path.size());
+    for (char c : path)
+    {
+        c = c == '\\' ? '/' : (char)std::tolower((unsigned char)c);
+        // "//" y "/./" se quedan en una sola barra.
+        if (c == '/' && !normalized.empty() && normalized.back() == '/')
+            continue;
+        if (c == '/' && normalized.size() >= 2 && normalized.compare(normalized.size() - 2, 2, "/.") == 0)
+        {
+            normalized.pop_back();
+            continue;
+        }
+        normalized += c;
+    }
+    while (normalized.compare(0, 2, "./") == 0)
+        normalized.erase(0, 2);
+    return normalized;
+}
+
+uint64_t AssetPack::hashPath(const std::string& normalizedPath)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : normalizedPath)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool AssetPack::write(const std::string& path, const std::vector<AssetPackSource>& sources, std::string& error)
+{
+    std::vector<PreparedEntry> prepared(sources.size());
+    JobSystem::parallelFor(sources.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            prepare(sources[i], prepared[i]);
+    });
+    for (const PreparedEntry& entry : prepared)
+    {
+        if (!entry.error.empty())
+        {
+            error = entry.error;
+            return false;
+        }
+    }
+
+    // Tabla ordenada por hash (y por nombre entre colisiones), como la recorre find().
+    std::vector<std::string> names(sources.size());
+    std::vector<uint64_t> hashes(sources.size());
+    std::vector<size_t> order(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        names[i] = normalizePath(sources[i].name);
+        hashes[i] = hashPath(names[i]);
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return hashes[a] != hashes[b] ? hashes[a] < hashes[b] : names[a] < names[b];
+    });
+    for (size_t i = 1; i < order.size(); ++i)
+    {
+        if (names[order[i]] == names[order[i - 1]])
+        {
+            error = "duplicate entry " + names[order[i]];
+            return false;
+        }
+    }
+
+    AssetPackHeader header = {};
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = (uint32_t)sources.size();
+    header.entries = sizeof(AssetPackHeader);
+
+    std::vector<AssetPackEntry> entries(sources.size());
+    std::string nameSection;
+    for (size_t slot = 0; slot < order.size(); ++slot)
+    {
+        const size_t i = order[slot];
+        AssetPackEntry& entry = entries[slot];
+        entry.hash = hashes[i];
+        entry.size = (uint32_t)prepared[i].size;
+        entry.compression = (uint32_t)prepared[i].compression;
+        entry.storedSize = prepared[i].compression == PackCompression::Store ? entry.size : (uint32_t)prepared[i].compressed.size();
+        entry.name = (uint32_t)nameSection.size();
+        nameSection += names[i];
+        nameSection += '\0';
+    }
+    header.names = header.entries + entries.size() * sizeof(AssetPackEntry);
+    header.namesSize = nameSection.size();
+
+    uint64_t offset = header.names + header.namesSize;
+    for (AssetPackEntry& entry : entries)
+    {
+        entry.offset = align(offset);
+        offset = entry.offset + entry.storedSize;
+    }
+    header.fileSize = offset;
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        error = "cannot write " + path;
+        return false;
+    }
+    uint64_t written = 0;
+    auto put = [&](const void* bytes, size_t size) {
+        std::fwrite(bytes, 1, size, file);
+        written += size;
+    };
+    auto padTo = [&](uint64_t position) {
+        static const unsigned char zeros[ASSET_PACK_ALIGNMENT] = {};
+        while (written < position)
+            put(zeros, (size_t)std::min<uint64_t>(position - written, ASSET_PACK_ALIGNMENT));
+    };
+
+    put(&header, sizeof(header));
+    put(entries.data(), entries.size() * sizeof(AssetPackEntry));
+    put(nameSection.data(), nameSection.size());
+    bool ok = true;
+    for (size_t slot = 0; slot < order.size(); ++slot)
+    {
+        const PreparedEntry& entry = prepared[order[slot]];
+        padTo(entries[slot].offset);
+        if (entry.compression == PackCompression::Lz4)
+        {
+            put(entry.compressed.data(), entry.compressed.size());
+            continue;
+        }
+        // Sin comprimir se copia del archivo fuente, que puede haber cambiado desde prepare().
+        MappedFile source;
+        if (entry.size > 0 && (!source.open(sources[order[slot]].path) || source.size() != entry.size))
+        {
+            error = sources[order[slot]].path + " changed while packing";
+            ok = false;
+            break;
+        }
+        put(source.data(), source.size());
+    }
+    ok = ok && std::ferror(file) == 0;
+    std::fclose(file);
+    if (ok && written != header.fileSize)
+    {
+        error = "error writing " + path;
+        ok = false;
+    }
+    if (!ok)
+    {
+        std::remove(path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::parse(const unsigned char* data, size_t size, AssetPackView& view, std::string& error)
+{
+    if (size < sizeof(AssetPackHeader))
+    {
+        error = "file too small";
+        return false;
+    }
+    const AssetPackHeader& header = *reinterpret_cast<const AssetPackHeader*>(data);
+    if (header.magic != ASSET_PACK_MAGIC)
+    {
+        error = "not an asset pack";
+        return false;
+    }
+    if (header.version != ASSET_PACK_VERSION)
+    {
+        error = "unsupported asset pack version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.fileSize != size)
+    {
+        error = "truncated file";
+        return false;
+    }
+    const uint64_t tableSize = (uint64_t)header.entryCount * sizeof(AssetPackEntry);
+    if (header.entries > size || tableSize > size - header.entries || header.entries % alignof(AssetPackEntry) != 0 ||
+        header.names > size || header.namesSize > size - header.names ||
+        (header.namesSize > 0 && data[header.names + header.namesSize - 1] != '\0'))
+    {
+        error = "invalid entry table";
+        return false;
+    }
+
+    view.data = data;
+    view.header = &header;
+    view.entries = reinterpret_cast<const AssetPackEntry*>(data + header.entries);
+    view.names = reinterpret_cast<const char*>(data + header.names);
+
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        const AssetPackEntry& entry = view.entries[i];
+        const bool compressionValid = entry.compression == (uint32_t)PackCompression::Store ? entry.storedSize == entry.size
+                                                                                             : entry.compression == (uint32_t)PackCompression::Lz4;
+        if (entry.name >= header.namesSize || entry.offset > size || entry.storedSize > size - entry.offset || !compressionValid ||
+            (i > 0 && entry.hash < view.entries[i - 1].hash))
+        {
+            error = "invalid entry " + std::to_string(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+const AssetPackEntry* AssetPack::find(const AssetPackView& view, const std::string& normalizedPath)
+{
+    if (!view.header)
+        return nullptr;
+    const uint64_t hash = hashPath(normalizedPath);
+    const AssetPackEntry* end = view.entries + view.header->entryCount;
+    const AssetPackEntry* entry = std::lower_bound(view.entries, end, hash,
+        [](const AssetPackEntry& candidate, uint64_t key) { return candidate.hash < key; });
+    for (; entry != end && entry->hash == hash; ++entry)
+    {
+        if (std::strcmp(view.name(*entry), normalizedPath.c_str()) == 0)
+            return entry;
+    }
+    return nullptr;
+}
@@ -0,0 +1,91 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Paquete de assets (.pak, versión 1): muchos archivos pequeños en uno solo, para que el
+// arranque abra un archivo en vez de cientos. Se proyecta en memoria y las estructuras
+// se leen en el sitio (little-endian).
+//
+//   AssetPackHeader    cabecera
+//   AssetPackEntry[]   una por archivo, ordenadas por hash de la ruta
+//   nombres            rutas normalizadas terminadas en nulo
+//   datos              contenido de cada entrada, alineado a 64 bytes
+//
+// Cada entrada se guarda tal cual o comprimida con LZ4. Las guardadas tal cual (imágenes
+// ya comprimidas, .ktx2, .cmesh...) se leen directamente de la proyección, sin copia.
+const uint32_t ASSET_PACK_MAGIC = 0x4B415043;   // "CPAK"
+const uint32_t ASSET_PACK_VERSION = 1;
+const size_t ASSET_PACK_ALIGNMENT = 64;
+
+enum class PackCompression : uint32_t {
+    Store = 0,
+    Lz4 = 1
+};
+
+struct AssetPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fileSize;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t entries;       // desplazamiento de la tabla de entradas
+    uint64_t names;         // desplazamiento y tamaño de la sección de nombres
+    uint64_t namesSize;
+    uint64_t padding[2];
+};
+static_assert(sizeof(AssetPackHeader) == 64, "AssetPackHeader debe ocupar 64 bytes");
+
+struct AssetPackEntry {
+    uint64_t hash;          // AssetPack::hashPath de la ruta normalizada
+    uint64_t offset;        // del contenido guardado, desde el principio del archivo
+    uint32_t size;          // tamaño del archivo original
+    uint32_t storedSize;    // tamaño dentro del paquete (igual a size con Store)
+    uint32_t name;          // desplazamiento en la sección de nombres
+    uint32_t compression;   // PackCompression
+};
+static_assert(sizeof(AssetPackEntry) == 32, "AssetPackEntry debe ocupar 32 bytes");
+
+// Vista de un paquete ya validado: punteros dentro de los bytes proyectados.
+struct AssetPackView {
+    const unsigned char* data = nullptr;
+    const AssetPackHeader* header = nullptr;
+    const AssetPackEntry* entries = nullptr;
+    const char* names = nullptr;
+
+    const char* name(const AssetPackEntry& entry) const { return names + entry.name; }
+};
+
+// Archivo que se añade a un paquete: 'name' es la ruta con la que se pedirá en tiempo de
+// ejecución y 'path' el archivo del disco del que se lee.
+struct AssetPackSource {
+    std::string name;
+    std::string path;
+    bool store = false;     // no intentar comprimirlo
+};
+
+class AssetPack
+{
+public:
+    // Ruta en la forma en que se guarda y se busca: separadores '/', sin "./" ni "//" y en
+    // minúsculas (las rutas de los assets no distinguen mayúsculas, como en Windows).
+    static std::string normalizePath(const std::string& path);
+
+    // FNV-1a de 64 bits de una ruta ya normalizada.
+    static uint64_t hashPath(const std::string& normalizedPath);
+
+    // Comprime las entradas en paralelo con JobSystem. Una entrada se queda sin comprimir
+    // si lo pide su fuente o si LZ4 no ahorra al menos un octavo de su tamaño.
+    static bool write(const std::string& path, const std::vector<AssetPackSource>& sources, std::string& error);
+
+    // Valida la cabecera y que cada entrada y su nombre estén dentro del archivo.
+    static bool parse(const unsigned char* data, size_t size, AssetPackView& view, std::string& error);
+
+    // Búsqueda binaria por hash; las colisiones se resuelven comparando el nombre.
+    static const AssetPackEntry* find(const AssetPackView& view, const std::string& normalizedPath);
+};
+
+#endif // ASSET_PACK_H
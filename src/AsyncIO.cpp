@@ -0,0 +1,649 @@
+#include "AsyncIO.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CHAOS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+namespace
+{
+    // Hilos de E/S del respaldo sin io_uring: lecturas bloqueantes en paralelo para que
+    // el disco tenga varias peticiones en cola.
+    const unsigned IO_THREADS = 4;
+
+    // Las lecturas más largas se parten: el tamaño de una petición es de 32 bits.
+    const uint64_t MAX_CHUNK = (uint64_t)1 << 30;
+
+#ifdef _WIN32
+    using FileHandle = HANDLE;
+    const FileHandle INVALID_FILE = INVALID_HANDLE_VALUE;
+#else
+    using FileHandle = int;
+    const FileHandle INVALID_FILE = -1;
+#endif
+
+    FileHandle openFile(const std::string& path, uint64_t& size)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return INVALID_FILE;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            return INVALID_FILE;
+        }
+        size = (uint64_t)fileSize.QuadPart;
+        return file;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return INVALID_FILE;
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return INVALID_FILE;
+        }
+        size = (uint64_t)info.st_size;
+        return fd;
+#endif
+    }
+
+    void closeFile(FileHandle file)
+    {
+#ifdef _WIN32
+        CloseHandle(file);
+#else
+        ::close(file);
+#endif
+    }
+
+    // Lectura posicional bloqueante de un trozo. Devuelve los bytes leídos, 0 al final
+    // del archivo o -1 si falla.
+    int64_t readAt(FileHandle file, unsigned char* buffer, uint64_t count, uint64_t offset)
+    {
+        count = std::min(count, MAX_CHUNK);
+#ifdef _WIN32
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD)offset;
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD read = 0;
+        if (!ReadFile(file, buffer, (DWORD)count, &read, &overlapped))
+            return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+        return read;
+#else
+        for (;;)
+        {
+            const ssize_t read = pread(file, buffer, (size_t)count, (off_t)offset);
+            if (read >= 0 || errno != EINTR)
+                return read;
+        }
+#endif
+    }
+
+    struct Request {
+        uint64_t id = 0;
+        std::string path;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        IOPriority priority = IOPriority::Normal;
+        AsyncIO::Callback done;
+        std::atomic<bool> cancelled{ false };
+        FileHandle file = INVALID_FILE;
+        std::vector<unsigned char> bytes;
+        uint64_t completed = 0;     // bytes ya leídos
+#ifdef CHAOS_IO_URING
+        iovec chunk;                // destino del trozo en vuelo; el kernel lo lee al enviarlo
+#endif
+    };
+    using RequestPtr = std::shared_ptr<Request>;
+
+    std::mutex mutex;
+    std::condition_variable work;       // hay lecturas encoladas o hay que parar
+    std::condition_variable idle;       // 'requests' se ha vaciado
+    std::deque<RequestPtr> queues[3];   // una cola por IOPriority
+    std::unordered_map<uint64_t, RequestPtr> requests;  // encoladas y en vuelo, para cancel()
+    unsigned admitted = 0;              // sacadas de las colas y sin terminar
+    uint64_t nextId = 1;
+    bool running = false;
+    bool stopping = false;
+    unsigned queueDepth = 64;
+    const char* backend = "sync";
+    std::vector<std::thread> threads;
+
+    // Archivos abiertos, compartidos por las lecturas pendientes del mismo archivo. Se
+    // cierran cuando no queda ninguna lectura.
+    struct OpenFile {
+        FileHandle handle;
+        uint64_t size;
+        int users;
+    };
+    std::mutex fileMutex;
+    std::unordered_map<std::string, OpenFile> openFiles;
+
+    bool acquireFile(const std::string& path, FileHandle& handle, uint64_t& size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            auto it = openFiles.find(path);
+            if (it != openFiles.end())
+            {
+                it->second.users++;
+                handle = it->second.handle;
+                size = it->second.size;
+                return true;
+            }
+        }
+        // La apertura puede ser lenta (p. ej. en red): se hace sin bloquear a los demás.
+        uint64_t fileSize = 0;
+        FileHandle opened = openFile(path, fileSize);
+        if (opened == INVALID_FILE)
+            return false;
+        std::lock_guard<std::mutex> lock(fileMutex);
+        auto inserted = openFiles.emplace(path, OpenFile{ opened, fileSize, 0 });
+        if (!inserted.second)
+            closeFile(opened);
+        OpenFile& file = inserted.first->second;
+        file.users++;
+        handle = file.handle;
+        size = file.size;
+        return true;
+    }
+
+    void releaseFile(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        auto it = openFiles.find(path);
+        if (it != openFiles.end())
+            it->second.users--;
+    }
+
+    void closeIdleFiles()
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        for (auto it = openFiles.begin(); it != openFiles.end();)
+        {
+            if (it->second.users > 0)
+            {
+                ++it;
+                continue;
+            }
+            closeFile(it->second.handle);
+            it = openFiles.erase(it);
+        }
+    }
+
+    bool hasQueued()
+    {
+        return !queues[0].empty() || !queues[1].empty() || !queues[2].empty();
+    }
+
+    // Siguiente lectura por prioridad. Llamar con 'mutex' tomado y hasQueued().
+    RequestPtr popNext()
+    {
+        for (int priority = 2; priority >= 0; --priority)
+        {
+            if (queues[priority].empty())
+                continue;
+            RequestPtr request = std::move(queues[priority].front());
+            queues[priority].pop_front();
+            admitted++;
+            return request;
+        }
+        return nullptr;
+    }
+
+    // Abre el archivo y reserva el buffer del rango pedido.
+    bool prepare(Request& request)
+    {
+        uint64_t fileSize = 0;
+        if (!acquireFile(request.path, request.file, fileSize))
+            return false;
+        if (request.offset > fileSize)
+            return false;
+        if (request.size == AsyncIO::WHOLE_FILE)
+            request.size = fileSize - request.offset;
+        if (request.size > fileSize - request.offset)
+            return false;
+        request.bytes.resize((size_t)request.size);
+        return true;
+    }
+
+    bool readAll(Request& request)
+    {
+        while (request.completed < request.size)
+        {
+            if (request.cancelled)
+                return false;
+            const int64_t read = readAt(request.file, request.bytes.data() + request.completed, request.size - request.completed,
+                                        request.offset + request.completed);
+            if (read <= 0)
+                return false;
+            request.completed += (uint64_t)read;
+        }
+        return true;
+    }
+
+    // Cierra una lectura: suelta su archivo y, salvo que se haya cancelado o se esté
+    // parando, encola su callback en JobSystem.
+    void complete(const RequestPtr& request, bool ok)
+    {
+        if (request->file != INVALID_FILE)
+            releaseFile(request->path);
+
+        bool deliver;
+        bool nowIdle;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            deliver = !request->cancelled && !stopping;
+            requests.erase(request->id);
+            admitted--;
+            nowIdle = requests.empty();
+        }
+        // Con io_uring los hilos de E/S esperan a que baje 'admitted'.
+        work.notify_one();
+        if (nowIdle)
+        {
+            closeIdleFiles();
+            idle.notify_all();
+        }
+        if (deliver)
+            JobSystem::submit([request, ok] { request->done(ok, request->bytes); });
+    }
+
+    void ioThread()
+    {
+        for (;;)
+        {
+            RequestPtr request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work.wait(lock, [] { return stopping || hasQueued(); });
+                if (stopping)
+                    return;
+                request = popNext();
+            }
+            const bool ok = prepare(*request) && readAll(*request);
+            complete(request, ok);
+        }
+    }
+
+#ifdef CHAOS_IO_URING
+    // Anillos de io_uring proyectados del kernel, sin liburing.
+    struct Ring {
+        int fd = -1;
+        unsigned entries = 0;
+        unsigned* sqHead = nullptr;
+        unsigned* sqTail = nullptr;
+        unsigned* sqMask = nullptr;
+        unsigned* sqArray = nullptr;
+        io_uring_sqe* sqes = nullptr;
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned* cqMask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+        void* sqRing = MAP_FAILED;
+        void* cqRing = MAP_FAILED;
+        size_t sqRingSize = 0;
+        size_t cqRingSize = 0;
+        size_t sqesSize = 0;
+        unsigned pending = 0;       // SQEs escritas que aún no se han enviado
+    };
+    Ring ring;
+
+    void destroyRing()
+    {
+        if (ring.sqes && (void*)ring.sqes != MAP_FAILED)
+            munmap(ring.sqes, ring.sqesSize);
+        if (ring.cqRing != MAP_FAILED && ring.cqRing != ring.sqRing)
+            munmap(ring.cqRing, ring.cqRingSize);
+        if (ring.sqRing != MAP_FAILED)
+            munmap(ring.sqRing, ring.sqRingSize);
+        if (ring.fd >= 0)
+            ::close(ring.fd);
+        ring = Ring();
+    }
+
+    bool setupRing(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring.fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (ring.fd < 0)
+            return false;
+        ring.entries = params.sq_entries;
+
+        ring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        ring.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+            ring.sqRingSize = ring.cqRingSize = std::max(ring.sqRingSize, ring.cqRingSize);
+
+        ring.sqRing = mmap(nullptr, ring.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQ_RING);
+        if (ring.sqRing == MAP_FAILED)
+        {
+            destroyRing();
+            return false;
+        }
+        ring.cqRing = singleMap ? ring.sqRing
+                                : mmap(nullptr, ring.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_CQ_RING);
+        ring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+        if (ring.cqRing == MAP_FAILED || sqes == MAP_FAILED)
+        {
+            destroyRing();
+            return false;
+        }
+        ring.sqes = (io_uring_sqe*)sqes;
+
+        char* sq = (char*)ring.sqRing;
+        ring.sqHead = (unsigned*)(sq + params.sq_off.head);
+        ring.sqTail = (unsigned*)(sq + params.sq_off.tail);
+        ring.sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+        ring.sqArray = (unsigned*)(sq + params.sq_off.array);
+        char* cq = (char*)ring.cqRing;
+        ring.cqHead = (unsigned*)(cq + params.cq_off.head);
+        ring.cqTail = (unsigned*)(cq + params.cq_off.tail);
+        ring.cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+        ring.cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // Escribe la SQE del siguiente trozo de la lectura. Como mucho hay una SQE por lectura
+    // en vuelo y nunca más lecturas que entradas, así que siempre hay sitio.
+    void queueChunk(Request& request)
+    {
+        request.chunk.iov_base = request.bytes.data() + request.completed;
+        request.chunk.iov_len = (size_t)std::min(request.size - request.completed, MAX_CHUNK);
+
+        const unsigned tail = *ring.sqTail;
+        const unsigned index = tail & *ring.sqMask;
+        io_uring_sqe& sqe = ring.sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = request.file;
+        sqe.addr = (uint64_t)(uintptr_t)&request.chunk;
+        sqe.len = 1;
+        sqe.off = request.offset + request.completed;
+        sqe.user_data = request.id;
+        ring.sqArray[index] = index;
+        __atomic_store_n(ring.sqTail, tail + 1, __ATOMIC_RELEASE);
+        ring.pending++;
+    }
+
+    // Lecturas ya preparadas por los hilos de E/S, a la espera del despachador.
+    std::deque<RequestPtr> prepared;
+    std::condition_variable ready;      // hay lecturas preparadas o hay que parar
+
+    // Hilo de E/S con io_uring: abre el archivo y reserva el buffer (lo lento y lo que
+    // bloquea) y pasa la lectura al despachador. No saca de las colas más lecturas de las
+    // que caben en el anillo, para que las urgentes que lleguen después no esperen detrás
+    // de buffers ya reservados.
+    void prepareThread()
+    {
+        for (;;)
+        {
+            RequestPtr request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work.wait(lock, [] { return stopping || (hasQueued() && admitted < queueDepth); });
+                if (stopping)
+                    return;
+                request = popNext();
+            }
+            if (!prepare(*request))
+            {
+                complete(request, false);
+                continue;
+            }
+            if (request->size == 0)
+            {
+                complete(request, true);
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!stopping)
+                {
+                    prepared.push_back(std::move(request));
+                    request = nullptr;
+                }
+            }
+            if (request)
+                complete(request, false);
+            else
+                ready.notify_one();
+        }
+    }
+
+    // Un hilo despachador: escribe una SQE por cada lectura preparada, las envía todas
+    // con una llamada y recoge las terminadas en la misma. No abre ni reserva nada.
+    void dispatcherLoop()
+    {
+        std::unordered_map<uint64_t, RequestPtr> inFlight;
+        for (;;)
+        {
+            std::deque<RequestPtr> started;
+            bool stop;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (inFlight.empty())
+                    ready.wait(lock, [] { return stopping || !prepared.empty(); });
+                started.swap(prepared);
+                stop = stopping;
+            }
+            // Al parar ya no se envía nada nuevo: solo se espera a lo que está en vuelo.
+            for (RequestPtr& request : started)
+            {
+                if (stop || request->cancelled)
+                    complete(request, false);
+                else
+                {
+                    queueChunk(*request);
+                    inFlight.emplace(request->id, std::move(request));
+                }
+            }
+            if (inFlight.empty())
+            {
+                if (stop)
+                    return;
+                continue;
+            }
+
+            const int submitted = (int)syscall(__NR_io_uring_enter, ring.fd, ring.pending, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                    continue;
+                std::cerr << "ERROR::ASYNC_IO::IO_URING_ENTER " << errno << std::endl;
+                for (auto& entry : inFlight)
+                    complete(entry.second, false);
+                inFlight.clear();
+                ring.pending = 0;
+                continue;
+            }
+            ring.pending -= std::min(ring.pending, (unsigned)submitted);
+
+            unsigned head = *ring.cqHead;
+            const unsigned tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& cqe = ring.cqes[head & *ring.cqMask];
+                auto it = inFlight.find(cqe.user_data);
+                if (it == inFlight.end())
+                    continue;
+                RequestPtr request = it->second;
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+                {
+                    queueChunk(*request);
+                    continue;
+                }
+                if (cqe.res > 0)
+                    request->completed += (uint64_t)cqe.res;
+                // Un trozo corto no es un error: se pide el resto, salvo que se haya cancelado.
+                if (cqe.res > 0 && request->completed < request->size && !request->cancelled)
+                {
+                    queueChunk(*request);
+                    continue;
+                }
+                inFlight.erase(it);
+                complete(request, cqe.res > 0 && request->completed == request->size);
+            }
+            __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+        }
+    }
+#endif
+}
+
+void AsyncIO::init(unsigned depth, IOBackend preferred)
+{
+    if (running)
+        return;
+    queueDepth = std::max(1u, depth);
+    stopping = false;
+    running = true;
+
+#ifdef CHAOS_IO_URING
+    if (preferred == IOBackend::IoUring && setupRing(queueDepth))
+    {
+        queueDepth = std::min(queueDepth, ring.entries);
+        backend = "io_uring";
+        threads.emplace_back(dispatcherLoop);
+        for (unsigned i = 0; i < IO_THREADS; ++i)
+            threads.emplace_back(prepareThread);
+        return;
+    }
+#endif
+    (void)preferred;
+    backend = "threads";
+    for (unsigned i = 0; i < IO_THREADS; ++i)
+        threads.emplace_back(ioThread);
+}
+
+void AsyncIO::shutdown()
+{
+    if (!running)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (std::deque<RequestPtr>& queue : queues)
+        {
+            for (const RequestPtr& request : queue)
+                requests.erase(request->id);
+            queue.clear();
+        }
+    }
+    work.notify_all();
+#ifdef CHAOS_IO_URING
+    ready.notify_all();
+#endif
+    for (std::thread& thread : threads)
+        thread.join();
+    threads.clear();
+#ifdef CHAOS_IO_URING
+    destroyRing();
+#endif
+    closeIdleFiles();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.clear();
+        admitted = 0;
+        stopping = false;
+        running = false;
+    }
+    idle.notify_all();
+    backend = "sync";
+}
+
+const char* AsyncIO::backendName()
+{
+    return backend;
+}
+
+uint64_t AsyncIO::read(const std::string& path, uint64_t offset, uint64_t size, IOPriority priority, Callback done)
+{
+    auto request = std::make_shared<Request>();
+    request->path = path;
+    request->offset = offset;
+    request->size = size;
+    request->priority = priority;
+    request->done = std::move(done);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    request->id = nextId++;
+    const uint64_t id = request->id;
+    if (!running)
+    {
+        lock.unlock();
+        const bool ok = prepare(*request) && readAll(*request);
+        if (request->file != INVALID_FILE)
+            releaseFile(request->path);
+        closeIdleFiles();
+        JobSystem::submit([request, ok] { request->done(ok, request->bytes); });
+        return id;
+    }
+    requests.emplace(id, request);
+    queues[(int)priority].push_back(std::move(request));
+    lock.unlock();
+    work.notify_one();
+    return id;
+}
+
+bool AsyncIO::cancel(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = requests.find(id);
+    if (it == requests.end())
+        return false;
+    RequestPtr request = it->second;
+    request->cancelled = true;
+
+    // Si aún está en su cola se quita ya; si está en vuelo, complete() lo descartará.
+    std::deque<RequestPtr>& queue = queues[(int)request->priority];
+    auto queued = std::find(queue.begin(), queue.end(), request);
+    if (queued != queue.end())
+    {
+        queue.erase(queued);
+        requests.erase(it);
+        if (requests.empty())
+            idle.notify_all();
+    }
+    return true;
+}
+
+void AsyncIO::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [] { return requests.empty(); });
+}
@@ -0,0 +1,66 @@
+#ifndef ASYNC_IO_H
+#define ASYNC_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Prioridad de una lectura. Las más altas se envían antes; dentro de una prioridad, en
+// orden de llegada.
+enum class IOPriority : uint8_t {
+    Background,     // p. ej. recargar mips liberados por el presupuesto
+    Normal,
+    Urgent
+};
+
+enum class IOBackend : uint8_t {
+    Auto,       // de momento, hilos: io_uring no les gana en las medidas de chaos-bench io
+    Threads,    // hilos de E/S con lecturas bloqueantes
+    IoUring     // io_uring si el sistema lo permite; si no, hilos
+};
+
+// Lee rangos de archivos fuera de los hilos del motor. Por defecto lo hacen varios hilos
+// de E/S con lecturas posicionales bloqueantes. Con IOBackend::IoUring (solo Linux) esos
+// hilos solo abren los archivos y reservan los buffers, y un hilo despachador mantiene
+// hasta queueDepth lecturas en vuelo y envía todas las preparadas al kernel con una sola
+// llamada al sistema. Los hilos de E/S no son los de JobSystem, que quedan libres para
+// decodificar.
+//
+// Cada lectura termina con su callback encolado en JobSystem, con los bytes leídos. Los
+// archivos se mantienen abiertos mientras haya lecturas pendientes, así que muchas
+// entradas de un mismo paquete comparten un solo descriptor.
+//
+// Sin init() (p. ej. en las herramientas) read() lee en el hilo que llama.
+class AsyncIO
+{
+public:
+    // Todo el archivo desde 'offset'.
+    static const uint64_t WHOLE_FILE = ~0ull;
+
+    using Callback = std::function<void(bool ok, std::vector<unsigned char>& bytes)>;
+
+    // Llamar tras JobSystem::init().
+    static void init(unsigned queueDepth = 64, IOBackend backend = IOBackend::Auto);
+
+    // Descarta las lecturas que aún no han empezado, espera a las que están en vuelo (sin
+    // llamar a sus callbacks) y une los hilos. Llamar antes de JobSystem::shutdown().
+    static void shutdown();
+
+    static const char* backendName();
+
+    // Encola la lectura de [offset, offset + size) de 'path' y devuelve su identificador.
+    // Un archivo más corto que el rango cuenta como error.
+    static uint64_t read(const std::string& path, uint64_t offset, uint64_t size, IOPriority priority, Callback done);
+
+    // Cancela una lectura: si aún no se ha enviado se descarta y, si está en vuelo, su
+    // resultado se tira al llegar. Su callback ya no se llama. Devuelve false si ya había
+    // terminado.
+    static bool cancel(uint64_t request);
+
+    // Bloquea hasta que no queda ninguna lectura pendiente ni en vuelo.
+    static void waitIdle();
+};
+
+#endif // ASYNC_IO_H
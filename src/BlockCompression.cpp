@@ -0,0 +1,276 @@
+#include "BlockCompression.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    struct Color {
+        float r, g, b;
+    };
+
+    uint16_t packColor565(const Color& color)
+    {
+        const int r = std::clamp((int)std::lround(color.r * 31.0f / 255.0f), 0, 31);
+        const int g = std::clamp((int)std::lround(color.g * 63.0f / 255.0f), 0, 63);
+        const int b = std::clamp((int)std::lround(color.b * 31.0f / 255.0f), 0, 31);
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    Color unpackColor565(uint16_t packed)
+    {
+        const int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        return { (float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2)) };
+    }
+
+    float distanceSquared(const Color& a, const Color& b)
+    {
+        const float dr = a.r - b.r, dg = a.g - b.g, db = a.b - b.b;
+        return dr * dr + dg * dg + db * db;
+    }
+
+    // Elige para cada texel el color más cercano de la paleta de 4 y devuelve el error.
+    float selectIndices(const Color texels[16], uint16_t color0, uint16_t color1, uint32_t& indices)
+    {
+        const Color c0 = unpackColor565(color0), c1 = unpackColor565(color1);
+        const Color palette[4] = {
+            c0, c1,
+            { (2 * c0.r + c1.r) / 3, (2 * c0.g + c1.g) / 3, (2 * c0.b + c1.b) / 3 },
+            { (c0.r + 2 * c1.r) / 3, (c0.g + 2 * c1.g) / 3, (c0.b + 2 * c1.b) / 3 },
+        };
+        indices = 0;
+        float error = 0.0f;
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = 0;
+            float bestDistance = distanceSquared(texels[i], palette[0]);
+            for (int p = 1; p < 4; ++p)
+            {
+                const float distance = distanceSquared(texels[i], palette[p]);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= (uint32_t)best << (i * 2);
+            error += bestDistance;
+        }
+        return error;
+    }
+
+    // Modo de 4 colores: exige color0 > color1. Si son iguales todos los índices son 0.
+    void orderEndpoints(uint16_t& color0, uint16_t& color1)
+    {
+        if (color0 < color1)
+            std::swap(color0, color1);
+    }
+
+    void writeBC1(uint16_t color0, uint16_t color1, uint32_t indices, uint8_t out[8])
+    {
+        out[0] = (uint8_t)(color0 & 0xFF);
+        out[1] = (uint8_t)(color0 >> 8);
+        out[2] = (uint8_t)(color1 & 0xFF);
+        out[3] = (uint8_t)(color1 >> 8);
+        for (int i = 0; i < 4; ++i)
+            out[4 + i] = (uint8_t)(indices >> (i * 8));
+    }
+
+    // Lee un bloque de 4x4 repitiendo el borde y expande a RGBA.
+    void fetchBlock(const unsigned char* pixels, int width, int height, int channels, int blockX, int blockY, uint8_t rgba[64])
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            const int py = std::min(blockY * 4 + y, height - 1);
+            for (int x = 0; x < 4; ++x)
+            {
+                const int px = std::min(blockX * 4 + x, width - 1);
+                const unsigned char* texel = pixels + ((size_t)py * width + px) * channels;
+                uint8_t* dst = rgba + (y * 4 + x) * 4;
+                dst[0] = texel[0];
+                dst[1] = channels > 1 ? texel[1] : 0;
+                dst[2] = channels > 2 ? texel[2] : 0;
+                dst[3] = channels > 3 ? texel[3] : 255;
+            }
+        }
+    }
+}
+
+size_t BlockCompression::blockBytes(BlockFormat format)
+{
+    return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+}
+
+size_t BlockCompression::compressedSize(BlockFormat format, int width, int height)
+{
+    return (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * blockBytes(format);
+}
+
+void BlockCompression::encodeBC1(const uint8_t rgba[64], uint8_t out[8])
+{
+    Color texels[16];
+    Color mean = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i)
+    {
+        texels[i] = { (float)rgba[i * 4], (float)rgba[i * 4 + 1], (float)rgba[i * 4 + 2] };
+        mean.r += texels[i].r / 16.0f;
+        mean.g += texels[i].g / 16.0f;
+        mean.b += texels[i].b / 16.0f;
+    }
+
+    // Eje principal de los colores del bloque (iteración de potencia sobre la covarianza).
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };
+    for (const Color& texel : texels)
+    {
+        const float r = texel.r - mean.r, g = texel.g - mean.g, b = texel.b - mean.b;
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+    Color axis = { 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        const Color next = {
+            cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b,
+            cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b,
+            cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b,
+        };
+        const float length = std::max({ std::abs(next.r), std::abs(next.g), std::abs(next.b) });
+        if (length < 1e-6f)
+            break;
+        axis = { next.r / length, next.g / length, next.b / length };
+    }
+
+    // Extremos: proyecciones mínima y máxima sobre el eje, recortadas 1/16 hacia dentro.
+    float minT = 0.0f, maxT = 0.0f;
+    for (const Color& texel : texels)
+    {
+        const float t = (texel.r - mean.r) * axis.r + (texel.g - mean.g) * axis.g + (texel.b - mean.b) * axis.b;
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    const float axisLength2 = axis.r * axis.r + axis.g * axis.g + axis.b * axis.b;
+    const float inset = (maxT - minT) / 16.0f;
+    minT = (minT + inset) / axisLength2;
+    maxT = (maxT - inset) / axisLength2;
+
+    uint16_t color0 = packColor565({ mean.r + axis.r * maxT, mean.g + axis.g * maxT, mean.b + axis.b * maxT });
+    uint16_t color1 = packColor565({ mean.r + axis.r * minT, mean.g + axis.g * minT, mean.b + axis.b * minT });
+    orderEndpoints(color0, color1);
+    if (color0 == color1)
+    {
+        writeBC1(color0, color1, 0, out);
+        return;
+    }
+    uint32_t indices;
+    const float error = selectIndices(texels, color0, color1, indices);
+
+    // Un paso de mínimos cuadrados: con los índices fijados, los extremos que minimizan
+    // el error. Se queda con él solo si mejora.
+    static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    float aa = 0, bb = 0, ab = 0;
+    Color ax = { 0, 0, 0 }, bx = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i)
+    {
+        const float a = weights[(indices >> (i * 2)) & 3], b = 1.0f - a;
+        aa += a * a; bb += b * b; ab += a * b;
+        ax.r += a * texels[i].r; ax.g += a * texels[i].g; ax.b += a * texels[i].b;
+        bx.r += b * texels[i].r; bx.g += b * texels[i].g; bx.b += b * texels[i].b;
+    }
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) > 1e-6f)
+    {
+        const Color end0 = { (ax.r * bb - bx.r * ab) / determinant, (ax.g * bb - bx.g * ab) / determinant, (ax.b * bb - bx.b * ab) / determinant };
+        const Color end1 = { (bx.r * aa - ax.r * ab) / determinant, (bx.g * aa - ax.g * ab) / determinant, (bx.b * aa - ax.b * ab) / determinant };
+        uint16_t refined0 = packColor565(end0), refined1 = packColor565(end1);
+        orderEndpoints(refined0, refined1);
+        if (refined0 != refined1)
+        {
+            uint32_t refinedIndices;
+            const float refinedError = selectIndices(texels, refined0, refined1, refinedIndices);
+            if (refinedError < error)
+            {
+                color0 = refined0;
+                color1 = refined1;
+                indices = refinedIndices;
+            }
+        }
+    }
+    writeBC1(color0, color1, indices, out);
+}
+
+void BlockCompression::encodeBC4(const uint8_t rgba[64], int channel, uint8_t out[8])
+{
+    int minValue = 255, maxValue = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        minValue = std::min(minValue, (int)rgba[i * 4 + channel]);
+        maxValue = std::max(maxValue, (int)rgba[i * 4 + channel]);
+    }
+
+    // Modo de 8 valores (extremo 0 > extremo 1): los dos extremos y 6 interpolados.
+    out[0] = (uint8_t)maxValue;
+    out[1] = (uint8_t)minValue;
+    uint64_t bits = 0;
+    if (maxValue != minValue)
+    {
+        int palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for (int j = 2; j < 8; ++j)
+            palette[j] = ((8 - j) * maxValue + (j - 1) * minValue) / 7;
+        for (int i = 0; i < 16; ++i)
+        {
+            const int value = rgba[i * 4 + channel];
+            int best = 0;
+            for (int j = 1; j < 8; ++j)
+            {
+                if (std::abs(palette[j] - value) < std::abs(palette[best] - value))
+                    best = j;
+            }
+            bits |= (uint64_t)best << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = (uint8_t)(bits >> (i * 8));
+}
+
+void BlockCompression::encodeBC3(const uint8_t rgba[64], uint8_t out[16])
+{
+    encodeBC4(rgba, 3, out);
+    encodeBC1(rgba, out + 8);
+}
+
+void BlockCompression::encodeBC5(const uint8_t rgba[64], uint8_t out[16])
+{
+    encodeBC4(rgba, 0, out);
+    encodeBC4(rgba, 1, out + 8);
+}
+
+std::vector<uint8_t> BlockCompression::compress(const unsigned char* pixels, int width, int height, int channels, BlockFormat format)
+{
+    const int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    const size_t bytesPerBlock = blockBytes(format);
+    std::vector<uint8_t> result(compressedSize(format, width, height));
+
+    JobSystem::parallelFor((size_t)blocksY, 4, [&](size_t begin, size_t end) {
+        uint8_t rgba[64];
+        for (size_t blockY = begin; blockY < end; ++blockY)
+        {
+            for (int blockX = 0; blockX < blocksX; ++blockX)
+            {
+                fetchBlock(pixels, width, height, channels, blockX, (int)blockY, rgba);
+                uint8_t* out = result.data() + (blockY * blocksX + blockX) * bytesPerBlock;
+                switch (format)
+                {
+                case BlockFormat::BC1: encodeBC1(rgba, out); break;
+                case BlockFormat::BC3: encodeBC3(rgba, out); break;
+                case BlockFormat::BC4: encodeBC4(rgba, 0, out); break;
+                case BlockFormat::BC5: encodeBC5(rgba, out); break;
+                }
+            }
+        }
+    });
+    return result;
+}
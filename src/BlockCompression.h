@@ -0,0 +1,34 @@
+#ifndef BLOCK_COMPRESSION_H
+#define BLOCK_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Formatos de compresión por bloques de 4x4 texels que cocina chaos-texcook.
+enum class BlockFormat : uint8_t {
+    BC1,    // RGB, 8 bytes por bloque (albedo opaco)
+    BC3,    // RGBA, 16 bytes: alfa como BC4 + color como BC1 (albedo con alfa)
+    BC4,    // un canal, 8 bytes (metallic, roughness, oclusión)
+    BC5     // dos canales, 16 bytes (normal maps: xy, z se reconstruye en el shader)
+};
+
+// Codificadores de CPU. Los bloques de entrada son 16 texels RGBA8 en orden de filas.
+class BlockCompression
+{
+public:
+    static size_t blockBytes(BlockFormat format);
+    static size_t compressedSize(BlockFormat format, int width, int height);
+
+    static void encodeBC1(const uint8_t rgba[64], uint8_t out[8]);
+    static void encodeBC3(const uint8_t rgba[64], uint8_t out[16]);
+    // 'channel' elige el componente de los texels RGBA que se codifica.
+    static void encodeBC4(const uint8_t rgba[64], int channel, uint8_t out[8]);
+    static void encodeBC5(const uint8_t rgba[64], uint8_t out[16]);
+
+    // Comprime una imagen de 1-4 canales. Los bordes que no completan un bloque repiten
+    // el último texel. Reparte las filas de bloques entre los hilos de JobSystem.
+    static std::vector<uint8_t> compress(const unsigned char* pixels, int width, int height, int channels, BlockFormat format);
+};
+
+#endif // BLOCK_COMPRESSION_H
@@ -0,0 +1,448 @@
+#include "CMeshFile.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const size_t CHECKSUM_BLOCK = 1024 * 1024;
+    // Índices por tarea al comprobar rangos en parse(): cada LOD se parte en trozos así.
+    const uint64_t INDEX_CHUNK = 256 * 1024;
+
+    const uint64_t PRIME64_1 = 11400714785074694791ull;
+    const uint64_t PRIME64_2 = 14029467366897019727ull;
+    const uint64_t PRIME64_3 = 1609587929392839161ull;
+    const uint64_t PRIME64_4 = 9650029242287828579ull;
+    const uint64_t PRIME64_5 = 2870177450012600261ull;
+
+    uint64_t rotl(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t read64(const unsigned char* p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t read32(const unsigned char* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint64_t xxRound(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * PRIME64_2;
+        return rotl(accumulator, 31) * PRIME64_1;
+    }
+
+    uint64_t xxMerge(uint64_t hash, uint64_t accumulator)
+    {
+        hash ^= xxRound(0, accumulator);
+        return hash * PRIME64_1 + PRIME64_4;
+    }
+
+    // xxHash64 (Yann Collet): cuatro acumuladores independientes de 8 bytes, así el bucle
+    // va al ritmo de la memoria.
+    uint64_t xxHash64(const unsigned char* data, size_t size, uint64_t seed)
+    {
+        const unsigned char* p = data;
+        const unsigned char* end = data + size;
+        uint64_t hash;
+        if (size >= 32)
+        {
+            uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+            uint64_t v2 = seed + PRIME64_2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - PRIME64_1;
+            for (; p + 32 <= end; p += 32)
+            {
+                v1 = xxRound(v1, read64(p));
+                v2 = xxRound(v2, read64(p + 8));
+                v3 = xxRound(v3, read64(p + 16));
+                v4 = xxRound(v4, read64(p + 24));
+            }
+            hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            hash = xxMerge(hash, v1);
+            hash = xxMerge(hash, v2);
+            hash = xxMerge(hash, v3);
+            hash = xxMerge(hash, v4);
+        }
+        else
+        {
+            hash = seed + PRIME64_5;
+        }
+
+        hash += size;
+        for (; p + 8 <= end; p += 8)
+            hash = rotl(hash ^ xxRound(0, read64(p)), 27) * PRIME64_1 + PRIME64_4;
+        if (p + 4 <= end)
+        {
+            hash = rotl(hash ^ (read32(p) * PRIME64_1), 23) * PRIME64_2 + PRIME64_3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+            hash = rotl(hash ^ (*p * PRIME64_5), 11) * PRIME64_1;
+
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    uint64_t align(uint64_t value)
+    {
+        return (value + CMESH_ALIGNMENT - 1) & ~(uint64_t)(CMESH_ALIGNMENT - 1);
+    }
+
+    // Submalla lista para escribir: vértices comprimidos e índices de cada LOD.
+    struct PreparedMesh {
+        std::vector<CompactVertex> vertices;
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsExtent = glm::vec3(0.0f);
+        glm::vec4 sphere = glm::vec4(0.0f);
+        std::vector<std::vector<uint32_t>> lods;
+        std::vector<float> errors;
+    };
+
+    void prepare(const CMeshSource& source, int maxLods, PreparedMesh& prepared)
+    {
+        const MeshData& data = source.data;
+        prepared.vertices = compressVertices(data.vertices, prepared.boundsMin, prepared.boundsExtent);
+
+        const glm::vec3 center = prepared.boundsMin + prepared.boundsExtent * 0.5f;
+        float radius = 0.0f;
+        for (const Vertex& vertex : data.vertices)
+            radius = std::max(radius, glm::length(vertex.position - center));
+        prepared.sphere = glm::vec4(center, radius);
+
+        prepared.lods.push_back(data.indices);
+        prepared.errors.push_back(0.0f);
+
+        // La primera rejilla tiene del orden de una celda por vértice en una superficie.
+        const float maxExtent = std::max(prepared.boundsExtent.x, std::max(prepared.boundsExtent.y, prepared.boundsExtent.z));
+        int grid = 1;
+        while ((size_t)grid * grid < data.vertices.size())
+            grid *= 2;
+        while ((int)prepared.lods.size() < maxLods && grid > 1 && maxExtent > 0.0f)
+        {
+            grid /= 2;
+            std::vector<uint32_t> simplified = MeshBuilder::simplifyClustered(data, grid);
+            if (simplified.empty())
+                break;
+            if (simplified.size() * 4 > prepared.lods.back().size() * 3)
+                continue;
+            MeshBuilder::optimizeVertexCache(simplified, data.vertices.size());
+            prepared.lods.push_back(std::move(simplified));
+            prepared.errors.push_back(maxExtent / grid);
+        }
+    }
+
+    bool sectionInside(const CMeshSection& section, size_t fileSize)
+    {
+        return section.offset % CMESH_ALIGNMENT == 0 && section.offset >= sizeof(CMeshHeader) && section.offset <= fileSize &&
+               section.size <= fileSize - section.offset;
+    }
+
+    // Por bloques de 64 de longitud fija, que el compilador vectoriza también en -O2; el
+    // resto va uno a uno.
+    template <typename Index>
+    uint32_t maxIndex(const Index* indices, size_t count)
+    {
+        Index highest = 0;
+        size_t i = 0;
+        for (; i + 64 <= count; i += 64)
+        {
+            Index block = 0;
+            for (size_t j = 0; j < 64; ++j)
+                block = std::max(block, indices[i + j]);
+            highest = std::max(highest, block);
+        }
+        for (; i < count; ++i)
+            highest = std::max(highest, indices[i]);
+        return highest;
+    }
+
+    // Trozo de índices de un LOD de un submesh que se recorre en una tarea.
+    struct IndexRange {
+        uint32_t submesh;
+        uint32_t lod;
+        uint64_t first;
+        uint64_t count;
+    };
+}
+
+bool CMeshFile::write(const std::string& path, const std::vector<CMeshSource>& meshes, std::string& error, const CMeshWriteOptions& options)
+{
+    std::vector<PreparedMesh> prepared(meshes.size());
+    JobSystem::parallelFor(meshes.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            prepare(meshes[i], std::max(options.maxLods, 1), prepared[i]);
+    });
+
+    // Índices de 16 bits si todas las submallas caben.
+    uint32_t indexSize = 2;
+    for (const CMeshSource& mesh : meshes)
+    {
+        if (mesh.data.vertices.size() > 0x10000)
+            indexSize = 4;
+    }
+
+    CMeshHeader header = {};
+    header.magic = CMESH_MAGIC;
+    header.version = CMESH_VERSION;
+    header.indexSize = indexSize;
+    header.submeshCount = (uint32_t)meshes.size();
+
+    std::vector<CMeshSubmesh> submeshes(meshes.size());
+    std::vector<CMeshLod> lods;
+    std::string names;
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const PreparedMesh& mesh = prepared[i];
+        CMeshSubmesh& submesh = submeshes[i];
+        submesh.name = (uint32_t)names.size();
+        names += meshes[i].name;
+        names += '\0';
+        submesh.firstLod = (uint32_t)lods.size();
+        submesh.lodCount = (uint32_t)mesh.lods.size();
+        submesh.vertexCount = (uint32_t)mesh.vertices.size();
+        submesh.firstVertex = vertexCount;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            submesh.boundsMin[axis] = mesh.boundsMin[axis];
+            submesh.boundsExtent[axis] = mesh.boundsExtent[axis];
+        }
+        for (int c = 0; c < 4; ++c)
+            submesh.sphere[c] = mesh.sphere[c];
+        vertexCount += mesh.vertices.size();
+
+        for (size_t level = 0; level < mesh.lods.size(); ++level)
+        {
+            CMeshLod lod = {};
+            lod.firstIndex = indexCount;
+            lod.indexCount = (uint32_t)mesh.lods[level].size();
+            lod.error = mesh.errors[level];
+            lods.push_back(lod);
+            indexCount += mesh.lods[level].size();
+        }
+    }
+    header.lodCount = (uint32_t)lods.size();
+
+    uint64_t offset = sizeof(CMeshHeader);
+    auto place = [&offset](CMeshSection& section, uint64_t size) {
+        section.offset = align(offset);
+        section.size = size;
+        offset = section.offset + size;
+    };
+    place(header.submeshes, submeshes.size() * sizeof(CMeshSubmesh));
+    place(header.lods, lods.size() * sizeof(CMeshLod));
+    place(header.names, names.size());
+    place(header.vertices, vertexCount * sizeof(CompactVertex));
+    place(header.indices, indexCount * indexSize);
+    header.fileSize = offset;
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        error = "cannot write " + path;
+        return false;
+    }
+    uint64_t written = 0;
+    auto put = [&](const void* bytes, size_t size) {
+        std::fwrite(bytes, 1, size, file);
+        written += size;
+    };
+    auto padTo = [&](uint64_t position) {
+        static const unsigned char zeros[CMESH_ALIGNMENT] = {};
+        while (written < position)
+            put(zeros, (size_t)std::min<uint64_t>(position - written, CMESH_ALIGNMENT));
+    };
+
+    put(&header, sizeof(header));
+    padTo(header.submeshes.offset);
+    put(submeshes.data(), submeshes.size() * sizeof(CMeshSubmesh));
+    padTo(header.lods.offset);
+    put(lods.data(), lods.size() * sizeof(CMeshLod));
+    padTo(header.names.offset);
+    put(names.data(), names.size());
+    padTo(header.vertices.offset);
+    for (const PreparedMesh& mesh : prepared)
+        put(mesh.vertices.data(), mesh.vertices.size() * sizeof(CompactVertex));
+    padTo(header.indices.offset);
+    for (const PreparedMesh& mesh : prepared)
+    {
+        for (const std::vector<uint32_t>& indices : mesh.lods)
+        {
+            if (indexSize == 4)
+            {
+                put(indices.data(), indices.size() * sizeof(uint32_t));
+            }
+            else
+            {
+                std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+                put(shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+            }
+        }
+    }
+    const bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    if (!ok || written != header.fileSize)
+    {
+        error = "error writing " + path;
+        return false;
+    }
+
+    // El checksum se calcula sobre el archivo ya escrito y se guarda en la cabecera.
+    {
+        MappedFile mapped;
+        if (!mapped.open(path))
+        {
+            error = "cannot reopen " + path;
+            return false;
+        }
+        header.checksum = checksum(mapped.data() + sizeof(CMeshHeader), mapped.size() - sizeof(CMeshHeader));
+    }
+    file = std::fopen(path.c_str(), "r+b");
+    if (!file)
+    {
+        error = "cannot reopen " + path;
+        return false;
+    }
+    const bool headerWritten = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    if (std::fclose(file) != 0 || !headerWritten)
+    {
+        error = "error writing header of " + path;
+        return false;
+    }
+    return true;
+}
+
+bool CMeshFile::parse(const unsigned char* data, size_t size, CMeshView& view, std::string& error, bool verifyChecksum)
+{
+    if (size < sizeof(CMeshHeader))
+    {
+        error = "file too small";
+        return false;
+    }
+    const CMeshHeader& header = *reinterpret_cast<const CMeshHeader*>(data);
+    if (header.magic != CMESH_MAGIC)
+    {
+        error = "not a .cmesh file";
+        return false;
+    }
+    if (header.version != CMESH_VERSION)
+    {
+        error = "unsupported .cmesh version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.fileSize != size)
+    {
+        error = "truncated file";
+        return false;
+    }
+    if ((header.indexSize != 2 && header.indexSize != 4) ||
+        !sectionInside(header.submeshes, size) || header.submeshes.size != (uint64_t)header.submeshCount * sizeof(CMeshSubmesh) ||
+        !sectionInside(header.lods, size) || header.lods.size != (uint64_t)header.lodCount * sizeof(CMeshLod) ||
+        !sectionInside(header.names, size) || (header.names.size > 0 && data[header.names.offset + header.names.size - 1] != '\0') ||
+        !sectionInside(header.vertices, size) || header.vertices.size % sizeof(CompactVertex) != 0 ||
+        !sectionInside(header.indices, size) || header.indices.size % header.indexSize != 0)
+    {
+        error = "invalid section table";
+        return false;
+    }
+
+    view.header = &header;
+    view.submeshes = reinterpret_cast<const CMeshSubmesh*>(data + header.submeshes.offset);
+    view.lods = reinterpret_cast<const CMeshLod*>(data + header.lods.offset);
+    view.names = reinterpret_cast<const char*>(data + header.names.offset);
+    view.vertices = reinterpret_cast<const CompactVertex*>(data + header.vertices.offset);
+    view.indices = data + header.indices.offset;
+
+    const uint64_t totalVertices = header.vertices.size / sizeof(CompactVertex);
+    const uint64_t totalIndices = header.indices.size / header.indexSize;
+    for (uint32_t i = 0; i < header.lodCount; ++i)
+    {
+        const CMeshLod& lod = view.lods[i];
+        if (lod.firstIndex > totalIndices || lod.indexCount > totalIndices - lod.firstIndex || lod.indexCount % 3 != 0)
+        {
+            error = "invalid LOD " + std::to_string(i);
+            return false;
+        }
+    }
+    std::vector<IndexRange> ranges;
+    for (uint32_t i = 0; i < header.submeshCount; ++i)
+    {
+        const CMeshSubmesh& submesh = view.submeshes[i];
+        if (submesh.name >= header.names.size || submesh.lodCount == 0 ||
+            (uint64_t)submesh.firstLod + submesh.lodCount > header.lodCount || submesh.firstVertex > totalVertices ||
+            submesh.vertexCount > totalVertices - submesh.firstVertex || (header.indexSize == 2 && submesh.vertexCount > 0x10000))
+        {
+            error = "invalid submesh " + std::to_string(i);
+            return false;
+        }
+
+        // Los índices son relativos al primer vértice del submesh. El checksum solo dice
+        // que el archivo está entero, no que quien lo cocinó acertara: un índice fuera de
+        // rango llegaría a la GPU, así que se recorren una vez, en trozos repartidos entre
+        // los hilos como el checksum.
+        for (uint32_t l = submesh.firstLod; l < submesh.firstLod + submesh.lodCount; ++l)
+        {
+            const CMeshLod& lod = view.lods[l];
+            for (uint64_t offset = 0; offset < lod.indexCount; offset += INDEX_CHUNK)
+                ranges.push_back({ i, l, lod.firstIndex + offset, std::min<uint64_t>(INDEX_CHUNK, lod.indexCount - offset) });
+        }
+    }
+
+    std::vector<uint32_t> highest(ranges.size());
+    JobSystem::parallelFor(ranges.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r)
+        {
+            const unsigned char* first = view.indices + ranges[r].first * header.indexSize;
+            highest[r] = header.indexSize == 2 ? maxIndex(reinterpret_cast<const uint16_t*>(first), ranges[r].count)
+                                               : maxIndex(reinterpret_cast<const uint32_t*>(first), ranges[r].count);
+        }
+    });
+    for (size_t r = 0; r < ranges.size(); ++r)
+    {
+        const CMeshSubmesh& submesh = view.submeshes[ranges[r].submesh];
+        if (highest[r] >= submesh.vertexCount)
+        {
+            error = "index out of range in submesh " + std::to_string(ranges[r].submesh) + " LOD " + std::to_string(ranges[r].lod - submesh.firstLod);
+            return false;
+        }
+    }
+
+    if (verifyChecksum && checksum(data + sizeof(CMeshHeader), size - sizeof(CMeshHeader)) != header.checksum)
+    {
+        error = "checksum mismatch";
+        return false;
+    }
+    return true;
+}
+
+uint64_t CMeshFile::checksum(const unsigned char* data, size_t size)
+{
+    const size_t blocks = (size + CHECKSUM_BLOCK - 1) / CHECKSUM_BLOCK;
+    std::vector<uint64_t> hashes(blocks);
+    JobSystem::parallelFor(blocks, 1, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t offset = block * CHECKSUM_BLOCK;
+            hashes[block] = xxHash64(data + offset, std::min(CHECKSUM_BLOCK, size - offset), block);
+        }
+    });
+    return xxHash64(reinterpret_cast<const unsigned char*>(hashes.data()), hashes.size() * sizeof(uint64_t), size);
+}
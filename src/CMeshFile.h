@@ -0,0 +1,108 @@
+#ifndef CMESH_FILE_H
+#define CMESH_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CompactVertex.h"
+#include "MeshBuilder.h"
+
+// Formato .cmesh (versión 1): geometría ya en el formato de la GPU, para proyectar el
+// archivo y subir sus secciones tal cual, sin analizar ni convertir nada. Las
+// estructuras se leen en el sitio: little-endian y cada sección alineada a 64 bytes.
+//
+//   CMeshHeader        cabecera con la tabla de secciones
+//   CMeshSubmesh[]     rango de vértices, LODs y volúmenes envolventes de cada submalla
+//   CMeshLod[]         rango de índices de cada LOD
+//   nombres            cadenas terminadas en nulo
+//   vértices           CompactVertex de todas las submallas, una tras otra
+//   índices            de 16 o 32 bits (indexSize), relativos al primer vértice de su submalla
+const uint32_t CMESH_MAGIC = 0x48534D43;    // "CMSH"
+const uint32_t CMESH_VERSION = 1;
+const size_t CMESH_ALIGNMENT = 64;
+
+struct CMeshSection {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct CMeshHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fileSize;
+    uint64_t checksum;      // CMeshFile::checksum de todo lo que sigue a la cabecera
+    uint32_t submeshCount;
+    uint32_t lodCount;
+    uint32_t indexSize;     // 2 o 4
+    uint32_t reserved;
+    CMeshSection submeshes;
+    CMeshSection lods;
+    CMeshSection names;
+    CMeshSection vertices;
+    CMeshSection indices;
+    uint64_t padding;
+};
+static_assert(sizeof(CMeshHeader) == 128, "CMeshHeader debe ocupar 128 bytes");
+
+struct CMeshSubmesh {
+    uint32_t name;          // desplazamiento en la sección de nombres
+    uint32_t firstLod;
+    uint32_t lodCount;      // al menos 1; el LOD 0 es la malla completa
+    uint32_t vertexCount;
+    uint64_t firstVertex;
+    float boundsMin[3];     // caja de cuantización de las posiciones (y caja envolvente)
+    float boundsExtent[3];
+    float sphere[4];        // centro y radio
+};
+static_assert(sizeof(CMeshSubmesh) == 64, "CMeshSubmesh debe ocupar 64 bytes");
+
+struct CMeshLod {
+    uint64_t firstIndex;
+    uint32_t indexCount;
+    float error;            // tamaño de celda de la simplificación, en unidades de la malla (0 en el LOD 0)
+};
+static_assert(sizeof(CMeshLod) == 16, "CMeshLod debe ocupar 16 bytes");
+
+// Vista de un .cmesh ya validado: punteros dentro de los bytes proyectados.
+struct CMeshView {
+    const CMeshHeader* header = nullptr;
+    const CMeshSubmesh* submeshes = nullptr;
+    const CMeshLod* lods = nullptr;
+    const char* names = nullptr;
+    const CompactVertex* vertices = nullptr;
+    const unsigned char* indices = nullptr;
+
+    const char* name(const CMeshSubmesh& submesh) const { return names + submesh.name; }
+};
+
+// Malla de entrada para escribir un .cmesh.
+struct CMeshSource {
+    std::string name;
+    MeshData data;
+};
+
+struct CMeshWriteOptions {
+    // LODs por submalla, contando la malla completa. Cada intento agrupa los vértices en
+    // una rejilla con la mitad de celdas por eje que el anterior; los que no quitan al
+    // menos un cuarto de los triángulos del último LOD se descartan.
+    int maxLods = 4;
+};
+
+class CMeshFile
+{
+public:
+    // Comprime los vértices y genera los LODs de cada submalla en paralelo con JobSystem.
+    static bool write(const std::string& path, const std::vector<CMeshSource>& meshes, std::string& error,
+                      const CMeshWriteOptions& options = CMeshWriteOptions());
+
+    // Valida la cabecera y que cada sección, submalla y LOD esté dentro del archivo. Con
+    // verifyChecksum también recorre el archivo entero (en paralelo) para comprobar el checksum.
+    static bool parse(const unsigned char* data, size_t size, CMeshView& view, std::string& error, bool verifyChecksum = true);
+
+    // xxHash64 de cada bloque de 1 MB (en paralelo) y de la lista de resultados.
+    static uint64_t checksum(const unsigned char* data, size_t size);
+};
+
+#endif // CMESH_FILE_H
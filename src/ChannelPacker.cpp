@@ -0,0 +1,67 @@
+#include "ChannelPacker.h"
+#include "VirtualFileSystem.h"
+
+#include "stb_image.h"
+
+bool ChannelPacker::pack(const std::string* sources, const unsigned char* fill, int channels, PackedImage& image, std::string& error)
+{
+    image = PackedImage();
+    image.channels = channels;
+
+    for (int channel = 0; channel < channels; ++channel)
+    {
+        if (sources[channel].empty())
+            continue;
+
+        AssetFile file;
+        if (!VirtualFileSystem::open(sources[channel], file))
+        {
+            error = sources[channel] + ": cannot open file";
+            return false;
+        }
+        int width, height, components;
+        unsigned char* data = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &components, 1);
+        if (!data)
+        {
+            error = sources[channel] + ": " + stbi_failure_reason();
+            return false;
+        }
+        if (image.pixels.empty())
+        {
+            image.width = width;
+            image.height = height;
+            image.pixels.resize((size_t)width * height * channels);
+            for (size_t i = 0; i < (size_t)width * height; ++i)
+            {
+                for (int c = 0; c < channels; ++c)
+                    image.pixels[i * channels + c] = fill[c];
+            }
+        }
+        else if (width != image.width || height != image.height)
+        {
+            stbi_image_free(data);
+            error = sources[channel] + " is " + std::to_string(width) + "x" + std::to_string(height) + ", expected "
+                  + std::to_string(image.width) + "x" + std::to_string(image.height);
+            return false;
+        }
+
+        for (size_t i = 0; i < (size_t)width * height; ++i)
+            image.pixels[i * channels + channel] = data[i];
+        stbi_image_free(data);
+    }
+
+    if (image.pixels.empty())
+    {
+        error = "no source images";
+        return false;
+    }
+    return true;
+}
+
+bool ChannelPacker::packORM(const std::string& occlusion, const std::string& roughness, const std::string& metallic,
+                            PackedImage& image, std::string& error)
+{
+    const std::string sources[3] = { occlusion, roughness, metallic };
+    const unsigned char fill[3] = { 255, 255, 0 };
+    return pack(sources, fill, 3, image, error);
+}
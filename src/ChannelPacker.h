@@ -0,0 +1,30 @@
+#ifndef CHANNEL_PACKER_H
+#define CHANNEL_PACKER_H
+
+#include <string>
+#include <vector>
+
+// Imagen de 8 bits por canal cuyos canales vienen de imágenes distintas.
+struct PackedImage {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// Empaquetado de mapas de un canal en una sola textura (p. ej. ORM: r = oclusión,
+// g = rugosidad, b = metálico, la convención de glTF). Lo usan el cargador de texturas
+// y chaos-texcook.
+class ChannelPacker
+{
+public:
+    // El canal i sale del primer canal de sources[i]; una ruta vacía rellena el canal con
+    // fill[i]. Todas las fuentes deben tener el mismo tamaño.
+    static bool pack(const std::string* sources, const unsigned char* fill, int channels, PackedImage& image, std::string& error);
+
+    // Oclusión, rugosidad y metálico en ese orden; sin oclusión el canal r vale 255.
+    static bool packORM(const std::string& occlusion, const std::string& roughness, const std::string& metallic,
+                        PackedImage& image, std::string& error);
+};
+
+#endif // CHANNEL_PACKER_H
@@ -0,0 +1,92 @@
+#include "CompactVertex.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+    float signNotZero(float value)
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    // Proyecta la dirección sobre el octaedro |x|+|y|+|z| = 1 y despliega la mitad
+    // inferior sobre las esquinas del cuadrado [-1, 1]^2.
+    glm::vec2 octEncode(const glm::vec3& direction)
+    {
+        // Un vector nulo (o NaN) de una malla degenerada no tiene dirección: se guarda (0, 0),
+        // que decodifica a +Z, en lugar de propagar el NaN de la división.
+        const float l1 = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (!(l1 > 1e-20f))
+            return glm::vec2(0.0f);
+        const glm::vec3 n = direction / l1;
+        glm::vec2 result(n.x, n.y);
+        if (n.z < 0.0f)
+        {
+            result = glm::vec2((1.0f - std::abs(n.y)) * signNotZero(n.x),
+                               (1.0f - std::abs(n.x)) * signNotZero(n.y));
+        }
+        return result;
+    }
+
+    int16_t toSnorm16(float value)
+    {
+        return (int16_t)std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f);
+    }
+
+    uint16_t toUnorm16(float value)
+    {
+        return (uint16_t)std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f);
+    }
+}
+
+std::vector<CompactVertex> compressVertices(const std::vector<Vertex>& vertices, glm::vec3& boundsMin, glm::vec3& boundsExtent)
+{
+    boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax(0.0f);
+    if (!vertices.empty())
+    {
+        boundsMin = boundsMax = vertices[0].position;
+        for (const Vertex& vertex : vertices)
+        {
+            boundsMin = glm::min(boundsMin, vertex.position);
+            boundsMax = glm::max(boundsMax, vertex.position);
+        }
+    }
+    boundsExtent = boundsMax - boundsMin;
+
+    // Un eje plano (extent 0) se guarda como 0 y se descuantiza a boundsMin.
+    glm::vec3 scale(0.0f);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (boundsExtent[axis] > 0.0f)
+            scale[axis] = 1.0f / boundsExtent[axis];
+    }
+
+    std::vector<CompactVertex> result(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const Vertex& vertex = vertices[i];
+        CompactVertex& packed = result[i];
+
+        const glm::vec3 quantized = (vertex.position - boundsMin) * scale;
+        packed.position[0] = toUnorm16(quantized.x);
+        packed.position[1] = toUnorm16(quantized.y);
+        packed.position[2] = toUnorm16(quantized.z);
+        packed.position[3] = vertex.tangent.w < 0.0f ? 0 : 65535;
+
+        const glm::vec2 normal = octEncode(vertex.normal);
+        packed.normal[0] = toSnorm16(normal.x);
+        packed.normal[1] = toSnorm16(normal.y);
+
+        const glm::vec2 tangent = octEncode(glm::vec3(vertex.tangent));
+        packed.tangent[0] = toSnorm16(tangent.x);
+        packed.tangent[1] = toSnorm16(tangent.y);
+
+        packed.texCoords[0] = glm::packHalf1x16(vertex.texCoords.x);
+        packed.texCoords[1] = glm::packHalf1x16(vertex.texCoords.y);
+    }
+    return result;
+}
@@ -0,0 +1,24 @@
+#ifndef COMPACT_VERTEX_H
+#define COMPACT_VERTEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MeshBuilder.h"
+
+// Vértice en formato Compact (ver VertexFormat en Mesh.h). No depende de GL para que
+// las herramientas puedan escribirlo ya comprimido (p. ej. en un .cmesh).
+struct CompactVertex {
+    uint16_t position[4];   // xyz: (p - min) / extent en unorm16; w: 0 si tangent.w < 0
+    int16_t normal[2];      // octaédrica, snorm16
+    int16_t tangent[2];     // octaédrica, snorm16
+    uint16_t texCoords[2];  // half float
+};
+static_assert(sizeof(CompactVertex) == 20, "CompactVertex debe ocupar 20 bytes");
+
+// Comprime los vértices y devuelve la caja usada para cuantizar las posiciones.
+std::vector<CompactVertex> compressVertices(const std::vector<Vertex>& vertices, glm::vec3& boundsMin, glm::vec3& boundsExtent);
+
+#endif // COMPACT_VERTEX_H
@@ -0,0 +1,57 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <cstdint>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "SceneGraph.h"
+
+// Componentes de las entidades de la escena (ver EntityWorld).
+
+// Formas básicas que se pueden crear sin importar un modelo.
+enum class ShapeType {
+    Cube,
+    Sphere,
+    Cylinder,
+    Plane,
+    Count // Número de formas (no es una forma)
+};
+
+// Nodo del SceneGraph con la transformación de la entidad; varias entidades pueden
+// compartirlo (p. ej. las primitivas de un mismo nodo glTF).
+struct TransformComponent {
+    SceneNode node = NO_SCENE_NODE;
+};
+
+// Malla y material de la cola de render con los que se dibuja la entidad.
+struct MeshRenderer {
+    uint16_t mesh = 0;
+    uint16_t material = 0;
+};
+
+// Los valores llegan tal cual al shader; deben coincidir con LIGHT_* en common/lights.glsl.
+enum class LightType : int {
+    Point = 0,
+    Spot = 1,
+    Directional = 2
+};
+
+// Luz en la posición de la entidad. Los focos y las direccionales apuntan hacia el -Z
+// local del nodo, como la cámara.
+struct Light {
+    LightType type = LightType::Point;
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 150.0f;
+    float range = 0.0f;                             // 0 = sin límite (cae con 1/d²)
+    float innerCone = glm::radians(20.0f);          // ángulos desde el eje del foco
+    float outerCone = glm::radians(30.0f);
+    bool castShadows = false;
+};
+
+struct Name {
+    std::string value;
+};
+
+#endif // COMPONENTS_H
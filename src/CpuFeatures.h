@@ -0,0 +1,38 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// Detección de las extensiones SIMD que usan los kernels de CPU (MipGenerator,
+// TransformArrays). Los kernels SSE se compilan siempre en x86-64; los AVX se eligen en
+// tiempo de ejecución con cpuHasAVX().
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CHAOS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC acepta intrínsecos AVX sin /arch:AVX; GCC y Clang necesitan marcar la función.
+#if defined(CHAOS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CHAOS_TARGET_AVX __attribute__((target("avx")))
+#else
+#define CHAOS_TARGET_AVX
+#endif
+
+inline bool cpuHasAVX()
+{
+#if defined(CHAOS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    return osxsave && avx && (_xgetbv(0) & 6) == 6;
+#elif defined(CHAOS_X86)
+    return __builtin_cpu_supports("avx");
+#else
+    return false;
+#endif
+}
+
+#endif // CPU_FEATURES_H
@@ -0,0 +1,255 @@
+#include "EntityWorld.h"
+
+#include <cassert>
+
+namespace
+{
+    // Los bloques se alinean a una línea de caché; ningún componente pide más.
+    const size_t CHUNK_ALIGNMENT = 64;
+
+    std::vector<ComponentInfo>& registry()
+    {
+        static std::vector<ComponentInfo> infos;
+        return infos;
+    }
+
+    size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Coloca las columnas para 'capacity' entidades y devuelve los bytes que ocupan.
+    size_t layout(const std::vector<uint32_t>& types, uint32_t capacity, std::vector<size_t>& offsets)
+    {
+        offsets.clear();
+        size_t offset = capacity * sizeof(Entity);
+        for (uint32_t type : types)
+        {
+            const ComponentInfo& info = ComponentRegistry::info(type);
+            offset = alignUp(offset, info.alignment);
+            offsets.push_back(offset);
+            offset += capacity * info.size;
+        }
+        return offset;
+    }
+}
+
+uint32_t ComponentRegistry::add(const ComponentInfo& info)
+{
+    assert(registry().size() < MAX_COMPONENT_TYPES && info.alignment <= CHUNK_ALIGNMENT);
+    registry().push_back(info);
+    return (uint32_t)registry().size() - 1;
+}
+
+const ComponentInfo& ComponentRegistry::info(uint32_t type)
+{
+    return registry()[type];
+}
+
+EntityWorld::~EntityWorld()
+{
+    for (const auto& archetype : archetypes)
+    {
+        for (uint32_t c = 0; c < archetype->chunks.size(); ++c)
+        {
+            for (uint32_t row = 0; row < archetype->chunks[c].count; ++row)
+            {
+                for (uint32_t type : archetype->types)
+                    ComponentRegistry::info(type).destroy(slot(*archetype, c, row, type));
+            }
+            ::operator delete(archetype->chunks[c].data, std::align_val_t(CHUNK_ALIGNMENT));
+        }
+    }
+}
+
+Entity EntityWorld::createIn(ComponentMask mask)
+{
+    const Entity entity = records.insert(Record());
+    insert(entity, archetypeFor(mask));
+    return entity;
+}
+
+bool EntityWorld::destroy(Entity entity)
+{
+    const Record* found = records.find(entity);
+    if (!found)
+        return false;
+    const Record record = *found;
+    const Archetype& archetype = *archetypes[record.archetype];
+    for (uint32_t type : archetype.types)
+        ComponentRegistry::info(type).destroy(slot(archetype, record.chunk, record.row, type));
+    removeRow(record);
+    records.erase(entity);
+    return true;
+}
+
+void* EntityWorld::addComponent(Entity entity, uint32_t type)
+{
+    assert(records.contains(entity));
+    const ComponentMask bit = ComponentMask(1) << type;
+    const ComponentMask mask = archetypes[records.at(entity.index).archetype]->mask;
+    if ((mask & bit) == 0)
+        moveEntity(entity, archetypeFor(mask | bit));
+    return component(entity, type);
+}
+
+void EntityWorld::removeComponent(Entity entity, uint32_t type)
+{
+    const Record* record = records.find(entity);
+    if (!record)
+        return;
+    const ComponentMask bit = ComponentMask(1) << type;
+    const ComponentMask mask = archetypes[record->archetype]->mask;
+    if ((mask & bit) != 0)
+        moveEntity(entity, archetypeFor(mask & ~bit));
+}
+
+void* EntityWorld::component(Entity entity, uint32_t type)
+{
+    const Record* record = records.find(entity);
+    if (!record)
+        return nullptr;
+    const Archetype& archetype = *archetypes[record->archetype];
+    if ((archetype.mask & (ComponentMask(1) << type)) == 0)
+        return nullptr;
+    return slot(archetype, record->chunk, record->row, type);
+}
+
+uint32_t EntityWorld::archetypeFor(ComponentMask mask)
+{
+    auto found = archetypeByMask.find(mask);
+    if (found != archetypeByMask.end())
+        return found->second;
+
+    auto archetype = std::make_unique<Archetype>();
+    archetype->mask = mask;
+    for (int8_t& column : archetype->columns)
+        column = -1;
+    for (uint32_t type = 0; type < MAX_COMPONENT_TYPES; ++type)
+    {
+        if (mask & (ComponentMask(1) << type))
+        {
+            archetype->columns[type] = (int8_t)archetype->types.size();
+            archetype->types.push_back(type);
+        }
+    }
+
+    // Tantas entidades como quepan en el bloque con el relleno de alineación incluido.
+    size_t entityBytes = sizeof(Entity);
+    for (uint32_t type : archetype->types)
+        entityBytes += ComponentRegistry::info(type).size;
+    uint32_t capacity = (uint32_t)(ENTITY_CHUNK_BYTES / entityBytes);
+    while (capacity > 1 && layout(archetype->types, capacity, archetype->offsets) > ENTITY_CHUNK_BYTES)
+        capacity--;
+    layout(archetype->types, capacity, archetype->offsets);
+    archetype->capacity = capacity;
+
+    const uint32_t index = (uint32_t)archetypes.size();
+    archetypes.push_back(std::move(archetype));
+    archetypeByMask.emplace(mask, index);
+    for (auto& cached : queries)
+    {
+        if ((mask & cached.first) == cached.first)
+            cached.second.push_back(index);
+    }
+    return index;
+}
+
+const std::vector<uint32_t>& EntityWorld::query(ComponentMask mask)
+{
+    auto found = queries.find(mask);
+    if (found != queries.end())
+        return found->second;
+    std::vector<uint32_t>& matches = queries[mask];
+    for (uint32_t i = 0; i < archetypes.size(); ++i)
+    {
+        if ((archetypes[i]->mask & mask) == mask)
+            matches.push_back(i);
+    }
+    return matches;
+}
+
+void* EntityWorld::slot(const Archetype& archetype, uint32_t chunk, uint32_t row, uint32_t type) const
+{
+    return archetype.chunks[chunk].data + archetype.offsets[archetype.columns[type]] + row * ComponentRegistry::info(type).size;
+}
+
+// Reserva una fila al final del arquetipo; los componentes quedan sin construir.
+void EntityWorld::insert(Entity entity, uint32_t index)
+{
+    Archetype& archetype = *archetypes[index];
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity)
+    {
+        Chunk chunk;
+        chunk.data = static_cast<unsigned char*>(::operator new(ENTITY_CHUNK_BYTES, std::align_val_t(CHUNK_ALIGNMENT)));
+        chunk.count = 0;
+        archetype.chunks.push_back(chunk);
+    }
+    Chunk& chunk = archetype.chunks.back();
+    reinterpret_cast<Entity*>(chunk.data)[chunk.count] = entity;
+    records.at(entity.index) = { index, (uint32_t)archetype.chunks.size() - 1, chunk.count };
+    chunk.count++;
+}
+
+// Pasa la entidad a otro arquetipo: mueve los componentes que tienen los dos, construye
+// los nuevos y destruye los que sobran.
+void EntityWorld::moveEntity(Entity entity, uint32_t index)
+{
+    const Record from = records.at(entity.index);
+    insert(entity, index);
+    const Record& to = records.at(entity.index);
+    const Archetype& source = *archetypes[from.archetype];
+    const Archetype& target = *archetypes[index];
+
+    for (uint32_t type : target.types)
+    {
+        const ComponentInfo& info = ComponentRegistry::info(type);
+        void* destination = slot(target, to.chunk, to.row, type);
+        if (source.columns[type] >= 0)
+        {
+            void* moved = slot(source, from.chunk, from.row, type);
+            info.moveConstruct(destination, moved);
+            info.destroy(moved);
+        }
+        else
+        {
+            info.construct(destination);
+        }
+    }
+    for (uint32_t type : source.types)
+    {
+        if (target.columns[type] < 0)
+            ComponentRegistry::info(type).destroy(slot(source, from.chunk, from.row, type));
+    }
+    removeRow(from);
+}
+
+// Cierra el hueco de una fila cuyos componentes ya se han destruido o movido con la última
+// entidad del arquetipo, para que todos los bloques menos el último sigan llenos.
+void EntityWorld::removeRow(const Record& record)
+{
+    Archetype& archetype = *archetypes[record.archetype];
+    const uint32_t lastChunk = (uint32_t)archetype.chunks.size() - 1;
+    Chunk& last = archetype.chunks[lastChunk];
+    const uint32_t lastRow = last.count - 1;
+    if (record.chunk != lastChunk || record.row != lastRow)
+    {
+        for (uint32_t type : archetype.types)
+        {
+            const ComponentInfo& info = ComponentRegistry::info(type);
+            void* moved = slot(archetype, lastChunk, lastRow, type);
+            info.moveConstruct(slot(archetype, record.chunk, record.row, type), moved);
+            info.destroy(moved);
+        }
+        const Entity moved = reinterpret_cast<Entity*>(last.data)[lastRow];
+        reinterpret_cast<Entity*>(archetype.chunks[record.chunk].data)[record.row] = moved;
+        records.at(moved.index).chunk = record.chunk;
+        records.at(moved.index).row = record.row;
+    }
+    last.count--;
+    if (last.count == 0)
+    {
+        ::operator delete(last.data, std::align_val_t(CHUNK_ALIGNMENT));
+        archetype.chunks.pop_back();
+    }
+}
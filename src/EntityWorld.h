@@ -0,0 +1,198 @@
+#ifndef ENTITY_WORLD_H
+#define ENTITY_WORLD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "SlotMap.h"
+
+// Handle de una entidad. La ranura de una entidad destruida se reutiliza con otra
+// generación, así que un handle guardado (selección del editor, referencias entre
+// entidades...) deja de valer en vez de apuntar a la entidad nueva: alive() lo detecta y
+// get()/has() lo tratan como una entidad sin componentes.
+struct EntityTag;
+using Entity = Handle<EntityTag>;
+const Entity NO_ENTITY = Entity();
+
+// Un bit por tipo de componente: la firma de un arquetipo y de una consulta.
+using ComponentMask = uint32_t;
+const uint32_t MAX_COMPONENT_TYPES = 32;
+
+// Tamaño de los bloques en que cada arquetipo guarda sus entidades.
+const size_t ENTITY_CHUNK_BYTES = 16 * 1024;
+
+// Cómo construir, mover y destruir un componente sin conocer su tipo.
+struct ComponentInfo {
+    size_t size;
+    size_t alignment;
+    void (*construct)(void* target);
+    void (*moveConstruct)(void* target, void* source);
+    void (*destroy)(void* target);
+};
+
+namespace ComponentRegistry
+{
+    // Registra un tipo y devuelve su índice de bit. Solo desde el hilo principal.
+    uint32_t add(const ComponentInfo& info);
+    const ComponentInfo& info(uint32_t type);
+}
+
+// Índice de bit del tipo T, asignado la primera vez que se usa.
+template <typename T>
+uint32_t componentType()
+{
+    static const uint32_t type = ComponentRegistry::add({
+        sizeof(T),
+        alignof(T),
+        [](void* target) { new (target) T(); },
+        [](void* target, void* source) { new (target) T(std::move(*static_cast<T*>(source))); },
+        [](void* target) { static_cast<T*>(target)->~T(); },
+    });
+    return type;
+}
+
+template <typename... Components>
+ComponentMask componentMask()
+{
+    return (ComponentMask(0) | ... | (ComponentMask(1) << componentType<Components>()));
+}
+
+// Entidades y componentes agrupados por arquetipo: todas las entidades con el mismo
+// conjunto de componentes comparten arquetipo y se guardan en bloques de 16 KB, cada uno
+// con una columna contigua por componente (estructura de arrays). Recorrer un componente
+// es leer memoria seguida, y un sistema solo visita los arquetipos que tienen todo lo que
+// pide: las consultas se guardan por firma y se amplían al aparecer arquetipos nuevos.
+//
+// Las entidades se localizan con un SlotMap de registros (arquetipo, bloque, fila): crear,
+// destruir y buscar son O(1) y los componentes siguen densos en los bloques.
+//
+// Añadir o quitar un componente mueve la entidad a otro arquetipo; destruirla mueve la
+// última entidad del arquetipo a su hueco. Por eso no se pueden crear ni destruir
+// entidades, ni añadir o quitar componentes, dentro de each()/eachChunk(), y los punteros
+// de get() solo valen hasta el siguiente cambio de ese tipo.
+class EntityWorld
+{
+public:
+    EntityWorld() = default;
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+    ~EntityWorld();
+
+    // Crea la entidad directamente en el arquetipo de sus componentes.
+    template <typename... Components>
+    Entity create(Components... components)
+    {
+        const Entity entity = createIn(componentMask<Components...>());
+        (new (component(entity, componentType<Components>())) Components(std::move(components)), ...);
+        return entity;
+    }
+
+    // Devuelve false si el handle ya no era válido.
+    bool destroy(Entity entity);
+    bool alive(Entity entity) const { return records.contains(entity); }
+
+    // Añade el componente (o sustituye el que ya tenía) y lo devuelve. La entidad tiene
+    // que estar viva.
+    template <typename T>
+    T& add(Entity entity, T value = T())
+    {
+        T& slot = *static_cast<T*>(addComponent(entity, componentType<T>()));
+        slot = std::move(value);
+        return slot;
+    }
+
+    template <typename T>
+    void remove(Entity entity) { removeComponent(entity, componentType<T>()); }
+
+    // Nulo si la entidad no tiene el componente o ya no existe.
+    template <typename T>
+    T* get(Entity entity) { return static_cast<T*>(component(entity, componentType<T>())); }
+
+    template <typename T>
+    bool has(Entity entity) const
+    {
+        const Record* record = records.find(entity);
+        return record && (archetypes[record->archetype]->mask & (ComponentMask(1) << componentType<T>())) != 0;
+    }
+
+    // Llama a function(count, entities, columna de cada componente...) por cada bloque
+    // con entidades que tengan todos los componentes pedidos.
+    template <typename... Components, typename Function>
+    void eachChunk(Function&& function)
+    {
+        for (uint32_t index : query(componentMask<Components...>()))
+        {
+            const Archetype& archetype = *archetypes[index];
+            for (const Chunk& chunk : archetype.chunks)
+                function((size_t)chunk.count, reinterpret_cast<const Entity*>(chunk.data), column<Components>(archetype, chunk)...);
+        }
+    }
+
+    // Llama a function(entity, componente...) por cada entidad con todos los componentes.
+    template <typename... Components, typename Function>
+    void each(Function&& function)
+    {
+        eachChunk<Components...>([&function](size_t count, const Entity* entities, Components*... columns) {
+            for (size_t i = 0; i < count; ++i)
+                function(entities[i], columns[i]...);
+        });
+    }
+
+    size_t size() const { return records.size(); }
+    size_t archetypeCount() const { return archetypes.size(); }
+
+private:
+    static const uint32_t NO_ARCHETYPE = ~0u;
+
+    struct Chunk {
+        unsigned char* data;    // entidades al principio y luego una columna por componente
+        uint32_t count;
+    };
+
+    struct Archetype {
+        ComponentMask mask = 0;
+        std::vector<uint32_t> types;                // en orden de bit
+        int8_t columns[MAX_COMPONENT_TYPES];        // columna de cada tipo o -1
+        std::vector<size_t> offsets;                // inicio de cada columna en el bloque
+        uint32_t capacity = 0;                      // entidades por bloque
+        std::vector<Chunk> chunks;                  // todos llenos salvo el último
+    };
+
+    struct Record {
+        uint32_t archetype = NO_ARCHETYPE;
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+    };
+
+    template <typename T>
+    static T* column(const Archetype& archetype, const Chunk& chunk)
+    {
+        return reinterpret_cast<T*>(chunk.data + archetype.offsets[archetype.columns[componentType<T>()]]);
+    }
+
+    Entity createIn(ComponentMask mask);
+    void* addComponent(Entity entity, uint32_t type);
+    void removeComponent(Entity entity, uint32_t type);
+    void* component(Entity entity, uint32_t type);
+
+    uint32_t archetypeFor(ComponentMask mask);
+    const std::vector<uint32_t>& query(ComponentMask mask);
+    void* slot(const Archetype& archetype, uint32_t chunk, uint32_t row, uint32_t type) const;
+    void insert(Entity entity, uint32_t archetype);
+    void moveEntity(Entity entity, uint32_t archetype);
+    void removeRow(const Record& record);
+
+    // En unique_ptr para que las referencias sigan valiendo al crear arquetipos.
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::unordered_map<ComponentMask, uint32_t> archetypeByMask;
+    std::unordered_map<ComponentMask, std::vector<uint32_t>> queries;
+
+    SlotMap<EntityTag, Record> records;
+};
+
+#endif // ENTITY_WORLD_H
@@ -0,0 +1,42 @@
+#include "GLExtensions.h"
+
+#include <cstring>
+
+GLExtensions glExtensions;
+
+bool hasGLExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, (GLuint)i));
+        if (extension && std::strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+void loadGLExtensions(GLADloadproc load)
+{
+    // GL_ARB_get_program_binary expone las mismas funciones que el núcleo 4.1, sin sufijo.
+    if (!GLAD_GL_VERSION_4_1 && hasGLExtension("GL_ARB_get_program_binary"))
+    {
+        glad_glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+        glad_glProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+        glad_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+    }
+    glExtensions.programBinary = glad_glGetProgramBinary && glad_glProgramBinary && glad_glProgramParameteri;
+
+    if (hasGLExtension("GL_KHR_parallel_shader_compile"))
+        glExtensions.maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsKHR");
+    else if (hasGLExtension("GL_ARB_parallel_shader_compile"))
+        glExtensions.maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsARB");
+    glExtensions.parallelShaderCompile = glExtensions.maxShaderCompilerThreads != nullptr;
+
+    if (!GLAD_GL_VERSION_4_4 && hasGLExtension("GL_ARB_buffer_storage"))
+        glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+    glExtensions.bufferStorage = glad_glBufferStorage != nullptr;
+
+    glExtensions.textureCompressionS3TC = hasGLExtension("GL_EXT_texture_compression_s3tc");
+}
@@ -0,0 +1,39 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <glad/glad.h>
+
+// GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile (mismos valores).
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+// GL_EXT_texture_compression_s3tc (BC1-BC3). BC4/BC5 (RGTC) son núcleo desde GL 3.0.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// Extensiones opcionales que aprovecha el motor. glad solo carga las funciones del
+// núcleo hasta la versión del contexto (3.3), así que las que existen como extensión
+// ARB en contextos antiguos se cargan aquí a mano.
+struct GLExtensions {
+    bool programBinary = false;     // GL 4.1 o GL_ARB_get_program_binary
+    bool parallelShaderCompile = false; // GL_KHR/ARB_parallel_shader_compile
+    bool bufferStorage = false;     // GL 4.4 o GL_ARB_buffer_storage (buffers mapeados persistentes)
+    bool textureCompressionS3TC = false; // GL_EXT_texture_compression_s3tc
+
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxShaderCompilerThreads = nullptr;
+};
+
+extern GLExtensions glExtensions;
+
+// Consulta la lista de extensiones del contexto actual.
+bool hasGLExtension(const char* name);
+
+// Rellena glExtensions y carga los punteros que falten. Llamar tras gladLoadGLLoader.
+void loadGLExtensions(GLADloadproc load);
+
+#endif // GL_EXTENSIONS_H
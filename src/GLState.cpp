@@ -0,0 +1,290 @@
+#include "GLState.h"
+
+namespace
+{
+    // Valor centinela para "estado desconocido": fuerza la siguiente llamada.
+    const GLuint UNKNOWN = 0xFFFFFFFFu;
+    const int MAX_TEXTURE_UNITS = 32;
+
+    // Capacidades con seguimiento; el resto se pasa al driver sin filtrar.
+    const GLenum trackedCapabilities[] = { GL_DEPTH_TEST, GL_BLEND, GL_STENCIL_TEST, GL_CULL_FACE, GL_SCISSOR_TEST };
+    const int CAPABILITY_COUNT = sizeof(trackedCapabilities) / sizeof(trackedCapabilities[0]);
+
+    // Buffers con seguimiento del punto de enlace genérico.
+    const GLenum trackedBuffers[] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_DRAW_INDIRECT_BUFFER };
+    const int BUFFER_TARGET_COUNT = sizeof(trackedBuffers) / sizeof(trackedBuffers[0]);
+
+    struct State
+    {
+        GLuint program;
+        GLuint vertexArray;
+        GLuint buffers[BUFFER_TARGET_COUNT];
+        GLuint activeUnit;
+        GLuint textures2D[MAX_TEXTURE_UNITS];
+        GLuint capabilities[CAPABILITY_COUNT];  // 0, 1 o UNKNOWN
+        GLenum blendSource, blendDestination;
+        GLenum depthFunction;
+        GLuint depthWrite;
+        GLenum stencilFunction;
+        GLint stencilReference;
+        GLuint stencilReadMask;
+        GLenum stencilFail, stencilDepthFail, stencilDepthPass;
+        GLuint stencilWriteMask;
+    };
+
+    State state;
+    GLState::Stats frameStats;
+    GLState::Stats previousFrameStats;
+
+    struct Initializer
+    {
+        Initializer() { GLState::invalidate(); }
+    } initializer;
+
+    // Devuelve true si hay que emitir la llamada y actualiza los contadores.
+    template <typename T>
+    bool changes(T& cached, T value)
+    {
+        if (cached == value)
+        {
+            frameStats.filtered++;
+            return false;
+        }
+        cached = value;
+        frameStats.issued++;
+        return true;
+    }
+
+    int bufferSlot(GLenum target)
+    {
+        for (int i = 0; i < BUFFER_TARGET_COUNT; ++i)
+        {
+            if (trackedBuffers[i] == target)
+                return i;
+        }
+        return -1;
+    }
+
+    int capabilitySlot(GLenum capability)
+    {
+        for (int i = 0; i < CAPABILITY_COUNT; ++i)
+        {
+            if (trackedCapabilities[i] == capability)
+                return i;
+        }
+        return -1;
+    }
+
+    void setCapability(GLenum capability, GLuint enabled)
+    {
+        int slot = capabilitySlot(capability);
+        if (slot >= 0 && !changes(state.capabilities[slot], enabled))
+            return;
+        if (slot < 0)
+            frameStats.issued++;
+
+        if (enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+    }
+}
+
+void GLState::useProgram(GLuint program)
+{
+    if (changes(state.program, program))
+        glUseProgram(program);
+}
+
+void GLState::bindVertexArray(GLuint vao)
+{
+    if (changes(state.vertexArray, vao))
+    {
+        glBindVertexArray(vao);
+        // El buffer de índices forma parte del estado del VAO.
+        state.buffers[bufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+    int slot = bufferSlot(target);
+    if (slot < 0)
+    {
+        frameStats.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (changes(state.buffers[slot], buffer))
+        glBindBuffer(target, buffer);
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    // glBindBufferBase también cambia el punto de enlace genérico del target.
+    frameStats.issued++;
+    glBindBufferBase(target, index, buffer);
+    int slot = bufferSlot(target);
+    if (slot >= 0)
+        state.buffers[slot] = buffer;
+}
+
+void GLState::activeTexture(GLuint unit)
+{
+    if (changes(state.activeUnit, unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    if (target != GL_TEXTURE_2D || unit >= (GLuint)MAX_TEXTURE_UNITS)
+    {
+        activeTexture(unit);
+        frameStats.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (state.textures2D[unit] == texture)
+    {
+        frameStats.filtered++;
+        return;
+    }
+    activeTexture(unit);
+    changes(state.textures2D[unit], texture);
+    glBindTexture(target, texture);
+}
+
+void GLState::enable(GLenum capability)
+{
+    setCapability(capability, 1);
+}
+
+void GLState::disable(GLenum capability)
+{
+    setCapability(capability, 0);
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination)
+{
+    if (state.blendSource == source && state.blendDestination == destination)
+    {
+        frameStats.filtered++;
+        return;
+    }
+    state.blendSource = source;
+    state.blendDestination = destination;
+    frameStats.issued++;
+    glBlendFunc(source, destination);
+}
+
+void GLState::depthFunc(GLenum function)
+{
+    if (changes(state.depthFunction, function))
+        glDepthFunc(function);
+}
+
+void GLState::depthMask(GLboolean mask)
+{
+    if (changes(state.depthWrite, (GLuint)mask))
+        glDepthMask(mask);
+}
+
+void GLState::stencilFunc(GLenum function, GLint reference, GLuint mask)
+{
+    if (state.stencilFunction == function && state.stencilReference == reference && state.stencilReadMask == mask)
+    {
+        frameStats.filtered++;
+        return;
+    }
+    state.stencilFunction = function;
+    state.stencilReference = reference;
+    state.stencilReadMask = mask;
+    frameStats.issued++;
+    glStencilFunc(function, reference, mask);
+}
+
+void GLState::stencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass)
+{
+    if (state.stencilFail == stencilFail && state.stencilDepthFail == depthFail && state.stencilDepthPass == depthPass)
+    {
+        frameStats.filtered++;
+        return;
+    }
+    state.stencilFail = stencilFail;
+    state.stencilDepthFail = depthFail;
+    state.stencilDepthPass = depthPass;
+    frameStats.issued++;
+    glStencilOp(stencilFail, depthFail, depthPass);
+}
+
+void GLState::stencilMask(GLuint mask)
+{
+    if (changes(state.stencilWriteMask, mask))
+        glStencilMask(mask);
+}
+
+void GLState::deleteProgram(GLuint program)
+{
+    if (state.program == program)
+        state.program = 0;
+    glDeleteProgram(program);
+}
+
+void GLState::deleteVertexArray(GLuint vao)
+{
+    if (state.vertexArray == vao)
+        state.vertexArray = 0;
+    glDeleteVertexArrays(1, &vao);
+}
+
+void GLState::deleteBuffer(GLuint buffer)
+{
+    for (GLuint& bound : state.buffers)
+    {
+        if (bound == buffer)
+            bound = 0;
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLState::deleteTexture(GLuint texture)
+{
+    for (GLuint& bound : state.textures2D)
+    {
+        if (bound == texture)
+            bound = 0;
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void GLState::invalidate()
+{
+    state.program = UNKNOWN;
+    state.vertexArray = UNKNOWN;
+    for (GLuint& buffer : state.buffers)
+        buffer = UNKNOWN;
+    state.activeUnit = UNKNOWN;
+    for (GLuint& texture : state.textures2D)
+        texture = UNKNOWN;
+    for (GLuint& capability : state.capabilities)
+        capability = UNKNOWN;
+    state.blendSource = state.blendDestination = UNKNOWN;
+    state.depthFunction = UNKNOWN;
+    state.depthWrite = UNKNOWN;
+    state.stencilFunction = UNKNOWN;
+    state.stencilReference = -1;
+    state.stencilReadMask = UNKNOWN;
+    state.stencilFail = state.stencilDepthFail = state.stencilDepthPass = UNKNOWN;
+    state.stencilWriteMask = UNKNOWN;
+}
+
+void GLState::endFrame()
+{
+    previousFrameStats = frameStats;
+    frameStats = Stats();
+}
+
+const GLState::Stats& GLState::lastFrame()
+{
+    return previousFrameStats;
+}
@@ -0,0 +1,49 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+// Capa fina de seguimiento del estado de OpenGL. Recuerda el programa, VAO, buffers,
+// texturas por unidad y el estado de blend/profundidad/stencil activos, y descarta las
+// llamadas que no cambiarían nada. Todo el código del motor debe pasar por aquí para
+// que la caché refleje el estado real; si algo externo toca el contexto, invalidate().
+class GLState
+{
+public:
+    // Llamadas emitidas al driver frente a llamadas descartadas por redundantes.
+    struct Stats {
+        int issued = 0;
+        int filtered = 0;
+    };
+
+    static void useProgram(GLuint program);
+    static void bindVertexArray(GLuint vao);
+    static void bindBuffer(GLenum target, GLuint buffer);
+    static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    static void activeTexture(GLuint unit);
+    static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    static void enable(GLenum capability);
+    static void disable(GLenum capability);
+    static void blendFunc(GLenum source, GLenum destination);
+    static void depthFunc(GLenum function);
+    static void depthMask(GLboolean mask);
+    static void stencilFunc(GLenum function, GLint reference, GLuint mask);
+    static void stencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass);
+    static void stencilMask(GLuint mask);
+
+    // Avisos de borrado: GL desenlaza el objeto si estaba activo.
+    static void deleteProgram(GLuint program);
+    static void deleteVertexArray(GLuint vao);
+    static void deleteBuffer(GLuint buffer);
+    static void deleteTexture(GLuint texture);
+
+    // Olvida todo el estado conocido; la siguiente llamada de cada tipo se emitirá.
+    static void invalidate();
+
+    // Cierra el frame actual: sus contadores pasan a lastFrame() y se reinician.
+    static void endFrame();
+    static const Stats& lastFrame();
+};
+
+#endif // GL_STATE_H
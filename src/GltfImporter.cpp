@@ -0,0 +1,1011 @@
+#include "GltfImporter.h"
+#include "JobSystem.h"
+#include "Json.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace
+{
+    // Cabecera y trozos de un .glb (little-endian).
+    const uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+    const uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+    const uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+
+    // componentType de los accessors (los mismos valores que GL_BYTE... GL_FLOAT).
+    const uint32_t COMPONENT_BYTE = 5120;
+    const uint32_t COMPONENT_UNSIGNED_BYTE = 5121;
+    const uint32_t COMPONENT_SHORT = 5122;
+    const uint32_t COMPONENT_UNSIGNED_SHORT = 5123;
+    const uint32_t COMPONENT_UNSIGNED_INT = 5125;
+    const uint32_t COMPONENT_FLOAT = 5126;
+
+    const int MODE_TRIANGLES = 4;
+    const int MODE_TRIANGLE_STRIP = 5;
+    const int MODE_TRIANGLE_FAN = 6;
+
+    struct BufferSource {
+        const unsigned char* bytes = nullptr;
+        size_t size = 0;
+    };
+
+    struct BufferView {
+        int buffer = -1;
+        size_t offset = 0;
+        size_t length = 0;
+        uint32_t stride = 0;
+    };
+
+    struct Accessor {
+        int view = -1;          // -1: todo ceros (o solo valores dispersos)
+        size_t offset = 0;
+        uint32_t componentType = 0;
+        int components = 0;
+        bool normalized = false;
+        size_t count = 0;
+        const JsonValue* sparse = nullptr;
+        bool hasBounds = false;
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+    };
+
+    // Estado compartido mientras se importa un archivo.
+    struct Document {
+        std::vector<BufferSource> buffers;
+        std::vector<BufferView> views;
+        std::vector<Accessor> accessors;
+    };
+
+    size_t componentSize(uint32_t componentType)
+    {
+        switch (componentType)
+        {
+        case COMPONENT_BYTE:
+        case COMPONENT_UNSIGNED_BYTE: return 1;
+        case COMPONENT_SHORT:
+        case COMPONENT_UNSIGNED_SHORT: return 2;
+        case COMPONENT_UNSIGNED_INT:
+        case COMPONENT_FLOAT: return 4;
+        default: return 0;
+        }
+    }
+
+    // Tamaño, desplazamiento o número de elementos: un entero JSON no negativo (0 si falta).
+    // Falla con negativos y con valores que no se representan exactamente en un double.
+    bool readSize(const JsonValue& value, size_t& out)
+    {
+        const double number = value.number();
+        if (!(number >= 0.0 && number <= 9007199254740992.0))
+            return false;
+        out = (size_t)number;
+        return true;
+    }
+
+    // Si 'count' elementos de 'elementSize' bytes separados por 'stride' caben en 'length'
+    // bytes a partir de 'offset'. Se comprueba sin sumas ni productos que puedan desbordar.
+    bool rangeFits(size_t offset, size_t count, size_t stride, size_t elementSize, size_t length)
+    {
+        if (offset > length)
+            return false;
+        if (count == 0)
+            return true;
+        const size_t available = length - offset;
+        if (elementSize > available)
+            return false;
+        return stride == 0 || count - 1 <= (available - elementSize) / stride;
+    }
+
+    int typeComponents(const std::string& type)
+    {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2") return 2;
+        if (type == "VEC3") return 3;
+        if (type == "VEC4") return 4;
+        if (type == "MAT2") return 4;
+        if (type == "MAT3") return 9;
+        if (type == "MAT4") return 16;
+        return 0;
+    }
+
+    uint32_t readU32(const unsigned char* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // Componente como float, con la normalización de glTF para los enteros normalizados.
+    float readComponent(const unsigned char* p, uint32_t componentType, bool normalized)
+    {
+        switch (componentType)
+        {
+        case COMPONENT_FLOAT:
+        {
+            float value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+        case COMPONENT_BYTE:
+        {
+            const int8_t value = (int8_t)p[0];
+            return normalized ? std::max(value / 127.0f, -1.0f) : (float)value;
+        }
+        case COMPONENT_UNSIGNED_BYTE:
+            return normalized ? p[0] / 255.0f : (float)p[0];
+        case COMPONENT_SHORT:
+        {
+            int16_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return normalized ? std::max(value / 32767.0f, -1.0f) : (float)value;
+        }
+        case COMPONENT_UNSIGNED_SHORT:
+        {
+            uint16_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return normalized ? value / 65535.0f : (float)value;
+        }
+        case COMPONENT_UNSIGNED_INT:
+            return (float)readU32(p);
+        default:
+            return 0.0f;
+        }
+    }
+
+    uint32_t readIndex(const unsigned char* p, uint32_t componentType)
+    {
+        switch (componentType)
+        {
+        case COMPONENT_UNSIGNED_BYTE: return p[0];
+        case COMPONENT_UNSIGNED_SHORT:
+        {
+            uint16_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+        case COMPONENT_UNSIGNED_INT: return readU32(p);
+        default: return 0;
+        }
+    }
+
+    bool decodeBase64(const char* text, size_t length, std::vector<unsigned char>& out)
+    {
+        static signed char table[256];
+        static bool tableReady = false;
+        if (!tableReady)
+        {
+            std::memset(table, -1, sizeof(table));
+            const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (int i = 0; i < 64; ++i)
+                table[(unsigned char)alphabet[i]] = (signed char)i;
+            tableReady = true;
+        }
+
+        out.clear();
+        out.reserve(length / 4 * 3);
+        uint32_t bits = 0;
+        int bitCount = 0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const unsigned char c = (unsigned char)text[i];
+            if (c == '=')
+                break;
+            if (table[c] < 0)
+                return false;
+            bits = (bits << 6) | (uint32_t)table[c];
+            bitCount += 6;
+            if (bitCount >= 8)
+            {
+                bitCount -= 8;
+                out.push_back((unsigned char)(bits >> bitCount));
+            }
+        }
+        return true;
+    }
+
+    // "data:<tipo>;base64,<datos>". Devuelve false si la URI no es de datos.
+    bool decodeDataUri(const std::string& uri, std::vector<unsigned char>& out, bool& valid)
+    {
+        if (uri.compare(0, 5, "data:") != 0)
+            return false;
+        const size_t comma = uri.find(',');
+        valid = comma != std::string::npos && uri.rfind(";base64", comma) != std::string::npos &&
+                decodeBase64(uri.data() + comma + 1, uri.size() - comma - 1, out);
+        return true;
+    }
+
+    // URI relativa (con escapes %XX) resuelta contra la carpeta del archivo glTF.
+    std::string resolveUri(const std::string& directory, const std::string& uri)
+    {
+        std::string path = directory;
+        for (size_t i = 0; i < uri.size(); ++i)
+        {
+            if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit((unsigned char)uri[i + 1]) && std::isxdigit((unsigned char)uri[i + 2]))
+            {
+                path += (char)std::stoi(uri.substr(i + 1, 2), nullptr, 16);
+                i += 2;
+            }
+            else
+            {
+                path += uri[i];
+            }
+        }
+        return path;
+    }
+
+    bool parseBuffers(const JsonValue& json, const std::string& directory, const BufferSource& glbChunk, GltfModel& model,
+                      Document& document, std::string& error)
+    {
+        const JsonValue& buffers = json["buffers"];
+        document.buffers.resize(buffers.size());
+        model.files.reserve(buffers.size());
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            const JsonValue& buffer = buffers[i];
+            size_t byteLength;
+            if (!readSize(buffer["byteLength"], byteLength))
+            {
+                error = "buffer " + std::to_string(i) + " has an invalid byteLength";
+                return false;
+            }
+            BufferSource& source = document.buffers[i];
+            if (!buffer.has("uri"))
+            {
+                // El primer buffer sin URI de un .glb es su trozo binario.
+                if (i != 0 || glbChunk.bytes == nullptr)
+                {
+                    error = "buffer " + std::to_string(i) + " has no uri";
+                    return false;
+                }
+                source = glbChunk;
+            }
+            else
+            {
+                const std::string& uri = buffer["uri"].string();
+                std::vector<unsigned char> decoded;
+                bool valid = false;
+                if (decodeDataUri(uri, decoded, valid))
+                {
+                    if (!valid)
+                    {
+                        error = "buffer " + std::to_string(i) + " has an invalid data uri";
+                        return false;
+                    }
+                    model.decodedBuffers.push_back(std::move(decoded));
+                    source.bytes = model.decodedBuffers.back().data();
+                    source.size = model.decodedBuffers.back().size();
+                }
+                else
+                {
+                    MappedFile file;
+                    const std::string path = resolveUri(directory, uri);
+                    if (!file.open(path))
+                    {
+                        error = "cannot open buffer " + path;
+                        return false;
+                    }
+                    source.bytes = file.data();
+                    source.size = file.size();
+                    model.files.push_back(std::move(file));
+                }
+            }
+            if (source.size < byteLength)
+            {
+                error = "buffer " + std::to_string(i) + " is shorter than its byteLength";
+                return false;
+            }
+            source.size = byteLength;
+        }
+
+        const JsonValue& views = json["bufferViews"];
+        document.views.resize(views.size());
+        for (size_t i = 0; i < views.size(); ++i)
+        {
+            BufferView& view = document.views[i];
+            view.buffer = (int)views[i]["buffer"].integer(-1);
+            size_t stride = 0;
+            if (!readSize(views[i]["byteOffset"], view.offset) || !readSize(views[i]["byteLength"], view.length) ||
+                !readSize(views[i]["byteStride"], stride) || stride > 252)
+            {
+                error = "bufferView " + std::to_string(i) + " has an invalid offset, length or stride";
+                return false;
+            }
+            view.stride = (uint32_t)stride;
+            if (view.buffer < 0 || view.buffer >= (int)document.buffers.size() || !rangeFits(view.offset, 1, 0, view.length, document.buffers[view.buffer].size))
+            {
+                error = "bufferView " + std::to_string(i) + " is out of bounds";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool parseAccessors(const JsonValue& json, Document& document, std::string& error)
+    {
+        const JsonValue& accessors = json["accessors"];
+        document.accessors.resize(accessors.size());
+        for (size_t i = 0; i < accessors.size(); ++i)
+        {
+            const JsonValue& source = accessors[i];
+            Accessor& accessor = document.accessors[i];
+            accessor.view = (int)source["bufferView"].integer(-1);
+
+            accessor.componentType = (uint32_t)source["componentType"].integer();
+            accessor.components = typeComponents(source["type"].string());
+            accessor.normalized = source["normalized"].boolean();
+            if (!readSize(source["byteOffset"], accessor.offset) || !readSize(source["count"], accessor.count))
+            {
+                error = "accessor " + std::to_string(i) + " has an invalid offset or count";
+                return false;
+            }
+            if (source.has("sparse"))
+                accessor.sparse = &source["sparse"];
+            const JsonValue& min = source["min"];
+            const JsonValue& max = source["max"];
+            if (accessor.components == 3 && min.size() == 3 && max.size() == 3)
+            {
+                accessor.hasBounds = true;
+                accessor.min = glm::vec3(min[0].number(), min[1].number(), min[2].number());
+                accessor.max = glm::vec3(max[0].number(), max[1].number(), max[2].number());
+            }
+
+            const size_t elementSize = componentSize(accessor.componentType) * accessor.components;
+            if (elementSize == 0)
+            {
+                error = "accessor " + std::to_string(i) + " has an unknown type";
+                return false;
+            }
+            if (accessor.view >= 0)
+            {
+                if (accessor.view >= (int)document.views.size())
+                {
+                    error = "accessor " + std::to_string(i) + " references a missing bufferView";
+                    return false;
+                }
+                const BufferView& view = document.views[accessor.view];
+                const size_t stride = view.stride != 0 ? view.stride : elementSize;
+                if (!rangeFits(accessor.offset, accessor.count, stride, elementSize, view.length))
+                {
+                    error = "accessor " + std::to_string(i) + " is out of bounds";
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Rango [begin, end) de bytes de 'view' con 'count' elementos de 'elementSize' a partir de 'offset'.
+    bool viewRange(const Document& document, int viewIndex, size_t offset, size_t count, size_t elementSize, const unsigned char*& bytes, size_t& stride)
+    {
+        if (viewIndex < 0 || viewIndex >= (int)document.views.size())
+            return false;
+        const BufferView& view = document.views[viewIndex];
+        stride = view.stride != 0 ? view.stride : elementSize;
+        if (!rangeFits(offset, count, stride, elementSize, view.length))
+            return false;
+        bytes = document.buffers[view.buffer].bytes + view.offset + offset;
+        return true;
+    }
+
+    // Accessor entero convertido a floats (count * components), con los valores dispersos aplicados.
+    bool readFloats(const Document& document, int index, int components, std::vector<float>& out)
+    {
+        if (index < 0 || index >= (int)document.accessors.size())
+            return false;
+        const Accessor& accessor = document.accessors[index];
+        if (accessor.components < components)
+            return false;
+
+        const size_t componentBytes = componentSize(accessor.componentType);
+        const size_t elementSize = componentBytes * accessor.components;
+        out.assign(accessor.count * components, 0.0f);
+        if (accessor.view >= 0)
+        {
+            const unsigned char* bytes;
+            size_t stride;
+            if (!viewRange(document, accessor.view, accessor.offset, accessor.count, elementSize, bytes, stride))
+                return false;
+            for (size_t i = 0; i < accessor.count; ++i)
+            {
+                const unsigned char* element = bytes + i * stride;
+                for (int c = 0; c < components; ++c)
+                    out[i * components + c] = readComponent(element + c * componentBytes, accessor.componentType, accessor.normalized);
+            }
+        }
+
+        if (accessor.sparse != nullptr)
+        {
+            const JsonValue& sparse = *accessor.sparse;
+            const JsonValue& indices = sparse["indices"];
+            const JsonValue& values = sparse["values"];
+            const uint32_t indexType = (uint32_t)indices["componentType"].integer();
+            size_t count, indexOffset, valueOffset;
+            const unsigned char* indexBytes;
+            const unsigned char* valueBytes;
+            size_t indexStride, valueStride;
+            if (!readSize(sparse["count"], count) || !readSize(indices["byteOffset"], indexOffset) || !readSize(values["byteOffset"], valueOffset) ||
+                componentSize(indexType) == 0 ||
+                !viewRange(document, (int)indices["bufferView"].integer(-1), indexOffset, count, componentSize(indexType), indexBytes, indexStride) ||
+                !viewRange(document, (int)values["bufferView"].integer(-1), valueOffset, count, elementSize, valueBytes, valueStride))
+                return false;
+            // Los índices y valores dispersos siempre van compactos.
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t target = readIndex(indexBytes + i * componentSize(indexType), indexType);
+                if (target >= accessor.count)
+                    return false;
+                for (int c = 0; c < components; ++c)
+                    out[target * components + c] = readComponent(valueBytes + i * elementSize + c * componentBytes, accessor.componentType, accessor.normalized);
+            }
+        }
+        return true;
+    }
+
+    bool readIndices(const Document& document, int index, std::vector<uint32_t>& out)
+    {
+        if (index < 0 || index >= (int)document.accessors.size())
+            return false;
+        const Accessor& accessor = document.accessors[index];
+        if (accessor.components != 1 || accessor.sparse != nullptr || accessor.view < 0 ||
+            (accessor.componentType != COMPONENT_UNSIGNED_BYTE && accessor.componentType != COMPONENT_UNSIGNED_SHORT &&
+             accessor.componentType != COMPONENT_UNSIGNED_INT))
+            return false;
+        const unsigned char* bytes;
+        size_t stride;
+        const size_t size = componentSize(accessor.componentType);
+        if (!viewRange(document, accessor.view, accessor.offset, accessor.count, size, bytes, stride))
+            return false;
+        out.resize(accessor.count);
+        for (size_t i = 0; i < accessor.count; ++i)
+            out[i] = readIndex(bytes + i * stride, accessor.componentType);
+        return true;
+    }
+
+    // El accessor se puede leer desde la GPU tal cual: sin valores dispersos y con uno
+    // de los tipos de componente permitidos.
+    bool streamable(const Document& document, int index, int components, bool allowNormalizedIntegers, GltfStream& stream)
+    {
+        if (index < 0 || index >= (int)document.accessors.size())
+            return false;
+        const Accessor& accessor = document.accessors[index];
+        if (accessor.view < 0 || accessor.sparse != nullptr || accessor.components != components)
+            return false;
+        const bool isFloat = accessor.componentType == COMPONENT_FLOAT;
+        const bool isUnorm = accessor.normalized &&
+                             (accessor.componentType == COMPONENT_UNSIGNED_BYTE || accessor.componentType == COMPONENT_UNSIGNED_SHORT);
+        if (!isFloat && !(allowNormalizedIntegers && isUnorm))
+            return false;
+
+        const BufferView& view = document.views[accessor.view];
+        stream.buffer = view.buffer;
+        stream.offset = view.offset + accessor.offset;
+        stream.components = components;
+        stream.componentType = accessor.componentType;
+        stream.normalized = accessor.normalized;
+        stream.stride = view.stride;
+        return true;
+    }
+
+    // Intenta describir la primitiva como rangos de los buffers.
+    bool buildDirect(const Document& document, const JsonValue& source, GltfPrimitive& primitive)
+    {
+        if (source["mode"].integer(MODE_TRIANGLES) != MODE_TRIANGLES)
+            return false;
+        const JsonValue& attributes = source["attributes"];
+        const int position = (int)attributes["POSITION"].integer(-1);
+        if (!streamable(document, position, 3, false, primitive.attributes[0]) ||
+            !streamable(document, (int)attributes["NORMAL"].integer(-1), 3, false, primitive.attributes[1]) ||
+            !streamable(document, (int)attributes["TEXCOORD_0"].integer(-1), 2, true, primitive.attributes[2]) ||
+            !streamable(document, (int)attributes["TANGENT"].integer(-1), 4, false, primitive.attributes[3]))
+            return false;
+
+        const size_t vertexCount = document.accessors[position].count;
+        for (const char* name : { "NORMAL", "TEXCOORD_0", "TANGENT" })
+        {
+            if (document.accessors[(size_t)attributes[name].integer()].count != vertexCount)
+                return false;
+        }
+
+        const int indexAccessor = (int)source["indices"].integer(-1);
+        if (indexAccessor < 0 || indexAccessor >= (int)document.accessors.size())
+            return false;
+        const Accessor& indices = document.accessors[indexAccessor];
+        if (indices.view < 0 || indices.sparse != nullptr || indices.components != 1 || indices.count % 3 != 0 ||
+            (indices.componentType != COMPONENT_UNSIGNED_BYTE && indices.componentType != COMPONENT_UNSIGNED_SHORT &&
+             indices.componentType != COMPONENT_UNSIGNED_INT))
+            return false;
+        // GL lee los índices siempre compactos.
+        const BufferView& indexView = document.views[indices.view];
+        if (indexView.stride != 0 && indexView.stride != componentSize(indices.componentType))
+            return false;
+        // Un índice fuera de rango haría leer a la GPU fuera de los atributos: se comprueba
+        // una vez aquí (de paso trae el rango de índices a memoria).
+        const unsigned char* indexBytes = document.buffers[indexView.buffer].bytes + indexView.offset + indices.offset;
+        const size_t indexSize = componentSize(indices.componentType);
+        uint32_t maxIndex = 0;
+        for (size_t i = 0; i < indices.count; ++i)
+            maxIndex = std::max(maxIndex, readIndex(indexBytes + i * indexSize, indices.componentType));
+        if (indices.count > 0 && maxIndex >= vertexCount)
+            return false;
+
+        primitive.indices.buffer = indexView.buffer;
+        primitive.indices.offset = indexView.offset + indices.offset;
+        primitive.indices.components = 1;
+        primitive.indices.componentType = indices.componentType;
+
+        primitive.direct = true;
+        primitive.vertexCount = (uint32_t)vertexCount;
+        primitive.indexCount = (uint32_t)indices.count;
+        const Accessor& positions = document.accessors[position];
+        if (positions.hasBounds)
+        {
+            primitive.boundsMin = positions.min;
+            primitive.boundsMax = positions.max;
+        }
+        else
+        {
+            std::vector<float> values;
+            readFloats(document, position, 3, values);
+            primitive.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+            primitive.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+            for (size_t i = 0; i + 2 < values.size(); i += 3)
+            {
+                const glm::vec3 p(values[i], values[i + 1], values[i + 2]);
+                primitive.boundsMin = glm::min(primitive.boundsMin, p);
+                primitive.boundsMax = glm::max(primitive.boundsMax, p);
+            }
+        }
+        return true;
+    }
+
+    // Camino de CPU: lee cualquier combinación de atributos, convierte tiras y abanicos a
+    // triángulos, calcula normales planas (lo que pide glTF cuando faltan) y tangentes.
+    bool buildConverted(const Document& document, const JsonValue& source, GltfPrimitive& primitive, std::string& warning)
+    {
+        const int mode = (int)source["mode"].integer(MODE_TRIANGLES);
+        if (mode != MODE_TRIANGLES && mode != MODE_TRIANGLE_STRIP && mode != MODE_TRIANGLE_FAN)
+        {
+            warning = "skipped a point/line primitive";
+            return false;
+        }
+
+        const JsonValue& attributes = source["attributes"];
+        std::vector<float> positions, normals, texCoords, tangents;
+        if (!readFloats(document, (int)attributes["POSITION"].integer(-1), 3, positions))
+        {
+            warning = "skipped a primitive without readable POSITION";
+            return false;
+        }
+        const size_t vertexCount = positions.size() / 3;
+        const bool hasNormals = readFloats(document, (int)attributes["NORMAL"].integer(-1), 3, normals) && normals.size() == vertexCount * 3;
+        const bool hasTexCoords = readFloats(document, (int)attributes["TEXCOORD_0"].integer(-1), 2, texCoords) && texCoords.size() == vertexCount * 2;
+        const bool hasTangents = hasNormals && readFloats(document, (int)attributes["TANGENT"].integer(-1), 4, tangents) && tangents.size() == vertexCount * 4;
+
+        std::vector<uint32_t> order;
+        if (source.has("indices"))
+        {
+            if (!readIndices(document, (int)source["indices"].integer(-1), order))
+            {
+                warning = "skipped a primitive with unreadable indices";
+                return false;
+            }
+        }
+        else
+        {
+            order.resize(vertexCount);
+            for (size_t i = 0; i < vertexCount; ++i)
+                order[i] = (uint32_t)i;
+        }
+
+        std::vector<uint32_t> triangles;
+        if (mode == MODE_TRIANGLES)
+        {
+            triangles.assign(order.begin(), order.begin() + order.size() / 3 * 3);
+        }
+        else
+        {
+            for (size_t i = 2; i < order.size(); ++i)
+            {
+                // Las tiras alternan el sentido para conservar la orientación.
+                if (mode == MODE_TRIANGLE_FAN)
+                    triangles.insert(triangles.end(), { order[i - 1], order[i], order[0] });
+                else if (i % 2 == 0)
+                    triangles.insert(triangles.end(), { order[i - 2], order[i - 1], order[i] });
+                else
+                    triangles.insert(triangles.end(), { order[i - 1], order[i - 2], order[i] });
+            }
+        }
+        for (uint32_t index : triangles)
+        {
+            if (index >= vertexCount)
+            {
+                warning = "skipped a primitive with out-of-range indices";
+                return false;
+            }
+        }
+
+        auto vertexAt = [&](uint32_t i) {
+            Vertex vertex;
+            vertex.position = glm::vec3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+            vertex.normal = hasNormals ? glm::vec3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]) : glm::vec3(0.0f);
+            vertex.texCoords = hasTexCoords ? glm::vec2(texCoords[i * 2], texCoords[i * 2 + 1]) : glm::vec2(0.0f);
+            vertex.tangent = hasTangents ? glm::vec4(tangents[i * 4], tangents[i * 4 + 1], tangents[i * 4 + 2], tangents[i * 4 + 3]) : glm::vec4(0.0f);
+            return vertex;
+        };
+
+        if (hasNormals)
+        {
+            primitive.data.vertices.resize(vertexCount);
+            for (size_t i = 0; i < vertexCount; ++i)
+                primitive.data.vertices[i] = vertexAt((uint32_t)i);
+            primitive.data.indices = std::move(triangles);
+        }
+        else
+        {
+            // Normales planas: cada triángulo con sus propios vértices, soldados después.
+            std::vector<Vertex> soup(triangles.size());
+            for (size_t t = 0; t + 2 < triangles.size(); t += 3)
+            {
+                for (int corner = 0; corner < 3; ++corner)
+                    soup[t + corner] = vertexAt(triangles[t + corner]);
+                const glm::vec3 normal = glm::cross(soup[t + 1].position - soup[t].position, soup[t + 2].position - soup[t].position);
+                const float length = glm::length(normal);
+                for (int corner = 0; corner < 3; ++corner)
+                    soup[t + corner].normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+            primitive.data = MeshBuilder::weld(soup);
+        }
+        if (!hasTangents)
+            MeshBuilder::computeTangents(primitive.data);
+        primitive.indexCount = (uint32_t)primitive.data.indices.size();
+        primitive.vertexCount = (uint32_t)primitive.data.vertices.size();
+        return true;
+    }
+
+    void parseMaterials(const JsonValue& json, GltfModel& model)
+    {
+        const JsonValue& textures = json["textures"];
+        auto imageOf = [&](const JsonValue& info) {
+            if (info.isNull() || info["texCoord"].integer() != 0)
+                return -1;
+            const int source = (int)textures[(size_t)info["index"].integer(-1)]["source"].integer(-1);
+            return source < (int)model.images.size() ? source : -1;
+        };
+
+        const JsonValue& materials = json["materials"];
+        model.materials.resize(materials.size());
+        for (size_t i = 0; i < materials.size(); ++i)
+        {
+            const JsonValue& source = materials[i];
+            const JsonValue& pbr = source["pbrMetallicRoughness"];
+            GltfMaterial& material = model.materials[i];
+            material.name = source["name"].string();
+            const JsonValue& baseColor = pbr["baseColorFactor"];
+            if (baseColor.size() == 4)
+                material.baseColor = glm::vec4(baseColor[0].number(), baseColor[1].number(), baseColor[2].number(), baseColor[3].number());
+            material.metallic = (float)pbr["metallicFactor"].number(1.0);
+            material.roughness = (float)pbr["roughnessFactor"].number(1.0);
+            material.baseColorTexture = imageOf(pbr["baseColorTexture"]);
+            material.metallicRoughnessTexture = imageOf(pbr["metallicRoughnessTexture"]);
+            material.normalTexture = imageOf(source["normalTexture"]);
+            material.occlusionTexture = imageOf(source["occlusionTexture"]);
+        }
+    }
+
+    bool parseImages(const JsonValue& json, const std::string& path, const std::string& directory, const Document& document,
+                     GltfModel& model, std::string& warnings)
+    {
+        const JsonValue& images = json["images"];
+        model.images.resize(images.size());
+        for (size_t i = 0; i < images.size(); ++i)
+        {
+            const JsonValue& source = images[i];
+            GltfImage& image = model.images[i];
+            auto bytes = std::make_shared<std::vector<unsigned char>>();
+            bool valid = true;
+            if (source.has("bufferView"))
+            {
+                // Embebida en un buffer (lo normal en un .glb): se copia porque el
+                // cargador de texturas la puede volver a decodificar mucho después.
+                const unsigned char* begin;
+                size_t stride;
+                const int view = (int)source["bufferView"].integer(-1);
+                valid = viewRange(document, view, 0, 1, view >= 0 && view < (int)document.views.size() ? document.views[view].length : 0, begin, stride);
+                if (valid)
+                    bytes->assign(begin, begin + document.views[view].length);
+            }
+            else if (!decodeDataUri(source["uri"].string(), *bytes, valid))
+            {
+                image.path = resolveUri(directory, source["uri"].string());
+                continue;
+            }
+
+            if (!valid || bytes->empty())
+            {
+                warnings += "image " + std::to_string(i) + " cannot be read\n";
+                continue;
+            }
+            image.key = path + "#image" + std::to_string(i);
+            image.bytes = std::move(bytes);
+        }
+        return true;
+    }
+
+    glm::mat4 nodeMatrix(const JsonValue& node)
+    {
+        const JsonValue& matrix = node["matrix"];
+        if (matrix.size() == 16)
+        {
+            float values[16];
+            for (int i = 0; i < 16; ++i)
+                values[i] = (float)matrix[(size_t)i].number();
+            return glm::make_mat4(values);    // glTF y glm son column-major
+        }
+
+        const JsonValue& t = node["translation"];
+        const JsonValue& r = node["rotation"];
+        const JsonValue& s = node["scale"];
+        const glm::vec3 translation = t.size() == 3 ? glm::vec3(t[0].number(), t[1].number(), t[2].number()) : glm::vec3(0.0f);
+        const glm::quat rotation = r.size() == 4 ? glm::quat((float)r[3].number(), (float)r[0].number(), (float)r[1].number(), (float)r[2].number())
+                                                 : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        const glm::vec3 scale = s.size() == 3 ? glm::vec3(s[0].number(), s[1].number(), s[2].number()) : glm::vec3(1.0f);
+        glm::mat4 local = glm::mat4_cast(rotation);
+        local[0] *= scale.x;
+        local[1] *= scale.y;
+        local[2] *= scale.z;
+        local[3] = glm::vec4(translation, 1.0f);
+        return local;
+    }
+
+    // Recorre la escena por defecto en profundidad; sin escenas, parte de los nodos que no
+    // son hijos de ninguno. Un nodo repetido o un ciclo se ignoran.
+    void parseNodes(const JsonValue& json, GltfModel& model)
+    {
+        const JsonValue& nodes = json["nodes"];
+        std::vector<int> roots;
+        const JsonValue& scene = json["scenes"][(size_t)json["scene"].integer(0)];
+        if (scene.isObject())
+        {
+            for (size_t i = 0; i < scene["nodes"].size(); ++i)
+                roots.push_back((int)scene["nodes"][i].integer(-1));
+        }
+        else
+        {
+            std::vector<bool> isChild(nodes.size(), false);
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                const JsonValue& children = nodes[i]["children"];
+                for (size_t c = 0; c < children.size(); ++c)
+                {
+                    const long long child = children[c].integer(-1);
+                    if (child >= 0 && child < (long long)nodes.size())
+                        isChild[(size_t)child] = true;
+                }
+            }
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                if (!isChild[i])
+                    roots.push_back((int)i);
+            }
+        }
+
+        std::vector<bool> visited(nodes.size(), false);
+        std::vector<std::pair<int, int>> stack;   // (nodo de glTF, padre en model.nodes)
+        for (auto root = roots.rbegin(); root != roots.rend(); ++root)
+            stack.emplace_back(*root, -1);
+        while (!stack.empty())
+        {
+            const std::pair<int, int> entry = stack.back();
+            stack.pop_back();
+            if (entry.first < 0 || entry.first >= (int)nodes.size() || visited[entry.first])
+                continue;
+            visited[entry.first] = true;
+
+            const JsonValue& source = nodes[(size_t)entry.first];
+            GltfNode node;
+            node.name = source["name"].string();
+            node.parent = entry.second;
+            node.mesh = (int)source["mesh"].integer(-1);
+            if (node.mesh >= (int)model.meshes.size())
+                node.mesh = -1;
+            node.local = nodeMatrix(source);
+            node.world = node.parent >= 0 ? model.nodes[node.parent].world * node.local : node.local;
+            model.nodes.push_back(node);
+
+            const int index = (int)model.nodes.size() - 1;
+            const JsonValue& children = source["children"];
+            for (size_t c = children.size(); c-- > 0;)
+                stack.emplace_back((int)children[c].integer(-1), index);
+        }
+    }
+
+    // Ajusta cada buffer al rango que leen las primitivas directas y deja los
+    // desplazamientos de sus atributos relativos a ese rango.
+    void trimBuffers(const Document& document, GltfModel& model)
+    {
+        const size_t count = document.buffers.size();
+        std::vector<size_t> begin(count, std::numeric_limits<size_t>::max());
+        std::vector<size_t> end(count, 0);
+        auto extend = [&](const GltfStream& stream, uint32_t elements) {
+            const size_t elementSize = componentSize(stream.componentType) * stream.components;
+            const size_t stride = stream.stride != 0 ? stream.stride : elementSize;
+            begin[stream.buffer] = std::min(begin[stream.buffer], stream.offset);
+            end[stream.buffer] = std::max(end[stream.buffer], stream.offset + (elements > 0 ? (elements - 1) * stride + elementSize : 0));
+        };
+        for (const GltfMesh& mesh : model.meshes)
+        {
+            for (const GltfPrimitive& primitive : mesh.primitives)
+            {
+                if (!primitive.direct)
+                    continue;
+                for (const GltfStream& stream : primitive.attributes)
+                    extend(stream, primitive.vertexCount);
+                extend(primitive.indices, primitive.indexCount);
+            }
+        }
+
+        model.buffers.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (end[i] == 0)
+                continue;
+            // Se conserva la alineación a 4 bytes que glTF garantiza respecto al inicio del buffer.
+            begin[i] &= ~(size_t)3;
+            model.buffers[i].bytes = document.buffers[i].bytes + begin[i];
+            model.buffers[i].size = end[i] - begin[i];
+        }
+        for (GltfMesh& mesh : model.meshes)
+        {
+            for (GltfPrimitive& primitive : mesh.primitives)
+            {
+                if (!primitive.direct)
+                    continue;
+                for (GltfStream& stream : primitive.attributes)
+                    stream.offset -= begin[stream.buffer];
+                primitive.indices.offset -= begin[primitive.indices.buffer];
+            }
+        }
+    }
+}
+
+bool GltfImporter::load(const std::string& path, GltfModel& model, std::string& error, const GltfImportOptions& options)
+{
+    model = GltfModel();
+    error.clear();
+
+    MappedFile file;
+    if (!file.open(path))
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    const size_t slash = path.find_last_of("/\\");
+    const std::string directory = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+
+    // .glb: cabecera de 12 bytes, trozo JSON y trozo binario opcional. Si no, el archivo
+    // entero es el JSON.
+    const unsigned char* bytes = file.data();
+    const char* jsonText = (const char*)bytes;
+    size_t jsonLength = file.size();
+    BufferSource binChunk;
+    if (file.size() >= 12 && readU32(bytes) == GLB_MAGIC)
+    {
+        const size_t length = std::min((size_t)readU32(bytes + 8), file.size());
+        if (readU32(bytes + 4) != 2 || length < 20 || readU32(bytes + 16) != GLB_CHUNK_JSON || 20 + (size_t)readU32(bytes + 12) > length)
+        {
+            error = "invalid GLB header in " + path;
+            return false;
+        }
+        jsonText = (const char*)bytes + 20;
+        jsonLength = readU32(bytes + 12);
+        const size_t binHeader = 20 + ((jsonLength + 3) & ~(size_t)3);
+        if (binHeader + 8 <= length && readU32(bytes + binHeader + 4) == GLB_CHUNK_BIN)
+        {
+            binChunk.bytes = bytes + binHeader + 8;
+            binChunk.size = std::min((size_t)readU32(bytes + binHeader), length - binHeader - 8);
+        }
+    }
+
+    JsonValue json;
+    std::string jsonError;
+    if (!JsonValue::parse(jsonText, jsonLength, json, jsonError))
+    {
+        error = "invalid JSON in " + path + ": " + jsonError;
+        return false;
+    }
+    if (json["asset"]["version"].string().compare(0, 2, "2.") != 0)
+    {
+        error = "unsupported glTF version in " + path;
+        return false;
+    }
+
+    Document document;
+    std::string warnings;
+    if (!parseBuffers(json, directory, binChunk, model, document, error) || !parseAccessors(json, document, error))
+    {
+        error = path + ": " + error;
+        return false;
+    }
+    // El .glb sigue proyectado mientras viva el modelo: sus buffers apuntan a él.
+    model.files.push_back(std::move(file));
+    parseImages(json, path, directory, document, model, warnings);
+    parseMaterials(json, model);
+
+    // Primero se decide qué primitivas se leen tal cual; el resto se convierte en paralelo.
+    const JsonValue& meshes = json["meshes"];
+    model.meshes.resize(meshes.size());
+    std::vector<std::pair<size_t, size_t>> converted;
+    for (size_t m = 0; m < meshes.size(); ++m)
+    {
+        const JsonValue& primitives = meshes[m]["primitives"];
+        GltfMesh& mesh = model.meshes[m];
+        mesh.name = meshes[m]["name"].string();
+        mesh.primitives.resize(primitives.size());
+        for (size_t p = 0; p < primitives.size(); ++p)
+        {
+            GltfPrimitive& primitive = mesh.primitives[p];
+            const int material = (int)primitives[p]["material"].integer(-1);
+            primitive.material = material < (int)model.materials.size() ? material : -1;
+            if (!options.direct || !buildDirect(document, primitives[p], primitive))
+                converted.emplace_back(m, p);
+        }
+    }
+
+    std::vector<std::string> conversionWarnings(converted.size());
+    JobSystem::parallelFor(converted.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const JsonValue& source = meshes[converted[i].first]["primitives"][converted[i].second];
+            GltfPrimitive& primitive = model.meshes[converted[i].first].primitives[converted[i].second];
+            if (!buildConverted(document, source, primitive, conversionWarnings[i]))
+                primitive.data = MeshData();
+        }
+    });
+    for (const std::string& warning : conversionWarnings)
+    {
+        if (!warning.empty())
+            warnings += warning + "\n";
+    }
+
+    for (GltfMesh& mesh : model.meshes)
+    {
+        // Las primitivas que no se pudieron leer se descartan.
+        mesh.primitives.erase(std::remove_if(mesh.primitives.begin(), mesh.primitives.end(), [](const GltfPrimitive& primitive) {
+            return primitive.indexCount == 0;
+        }), mesh.primitives.end());
+        for (const GltfPrimitive& primitive : mesh.primitives)
+            model.triangles += primitive.indexCount / 3;
+    }
+    trimBuffers(document, model);
+    parseNodes(json, model);
+
+    // Un archivo sin nodos se muestra igualmente: una instancia de cada malla en el origen.
+    if (model.nodes.empty())
+    {
+        for (size_t m = 0; m < model.meshes.size(); ++m)
+        {
+            GltfNode node;
+            node.name = model.meshes[m].name;
+            node.mesh = (int)m;
+            model.nodes.push_back(node);
+        }
+    }
+
+    // Se traen ya a memoria los rangos que se van a subir (esto corre en un hilo de
+    // trabajo): el glBufferData del hilo principal no espera al disco.
+    for (const GltfBuffer& buffer : model.buffers)
+    {
+        volatile unsigned char touch = 0;
+        for (size_t offset = 0; offset < buffer.size; offset += 4096)
+            touch ^= buffer.bytes[offset];
+        (void)touch;
+    }
+
+    if (!warnings.empty())
+        error = path + ":\n" + warnings;
+    return true;
+}
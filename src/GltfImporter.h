@@ -0,0 +1,117 @@
+#ifndef GLTF_IMPORTER_H
+#define GLTF_IMPORTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MappedFile.h"
+#include "MeshBuilder.h"
+
+// Trozo de un buffer de glTF que se sube tal cual a un buffer de GL: desde el primer
+// hasta el último byte que leen las primitivas directas. 'bytes' apunta a la proyección
+// del archivo (.glb o .bin) o, con URIs data:, a la copia decodificada del modelo.
+struct GltfBuffer {
+    const unsigned char* bytes = nullptr;
+    size_t size = 0;    // 0 si ninguna primitiva directa lo usa
+};
+
+// Accessor de glTF visto como atributo de vértice. componentType coincide con el enum
+// de GL (5126 = GL_FLOAT, 5123 = GL_UNSIGNED_SHORT...); offset es relativo a GltfBuffer::bytes.
+struct GltfStream {
+    int buffer = -1;
+    size_t offset = 0;
+    int components = 0;
+    uint32_t componentType = 0;
+    bool normalized = false;
+    uint32_t stride = 0;
+};
+
+// Primitiva de una malla. Si es directa, sus atributos e índices se dibujan desde los
+// buffers sin convertir nada; si no (faltan normales o tangentes, no es indexada, es una
+// tira o un abanico, tiene accessors dispersos...), 'data' trae la geometría convertida
+// a Vertex en CPU.
+struct GltfPrimitive {
+    int material = -1;          // índice en GltfModel::materials; -1 sin material
+    bool direct = false;
+    GltfStream attributes[4];   // posición, normal, UV y tangente (ubicaciones de FLOAT_VERTEX)
+    GltfStream indices;         // components = 1
+    uint32_t indexCount = 0;
+    uint32_t vertexCount = 0;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    MeshData data;
+};
+
+struct GltfMesh {
+    std::string name;
+    std::vector<GltfPrimitive> primitives;
+};
+
+// Imagen de un material: un archivo (ruta ya resuelta contra la carpeta del .gltf) o
+// bytes embebidos en el .glb o en una URI data:, con una clave única para el cargador.
+struct GltfImage {
+    std::string path;
+    std::string key;
+    std::shared_ptr<const std::vector<unsigned char>> bytes;
+};
+
+// Material pbrMetallicRoughness. Las texturas son índices en GltfModel::images (-1 sin
+// mapa); solo se usa el conjunto de UV 0.
+struct GltfMaterial {
+    std::string name;
+    glm::vec4 baseColor = glm::vec4(1.0f);
+    float metallic = 1.0f;
+    float roughness = 1.0f;
+    int baseColorTexture = -1;
+    int metallicRoughnessTexture = -1;  // g = rugosidad, b = metálico
+    int normalTexture = -1;
+    int occlusionTexture = -1;          // r = oclusión
+};
+
+// Nodo de la escena por defecto. Los nodos van en profundidad (el padre antes que sus
+// hijos) y 'world' ya incluye las transformaciones de los antecesores.
+struct GltfNode {
+    std::string name;
+    int parent = -1;            // índice en GltfModel::nodes
+    int mesh = -1;              // índice en GltfModel::meshes
+    glm::mat4 local = glm::mat4(1.0f);
+    glm::mat4 world = glm::mat4(1.0f);
+};
+
+struct GltfModel {
+    std::vector<GltfBuffer> buffers;
+    std::vector<GltfMesh> meshes;
+    std::vector<GltfMaterial> materials;
+    std::vector<GltfImage> images;
+    std::vector<GltfNode> nodes;
+    size_t triangles = 0;
+
+    // Dueños de los bytes a los que apuntan los buffers: archivos proyectados y URIs data:.
+    std::vector<MappedFile> files;
+    std::vector<std::vector<unsigned char>> decodedBuffers;
+};
+
+struct GltfImportOptions {
+    // Sin lectura directa todas las primitivas se convierten a MeshData (p. ej. para
+    // cocinarlas a otro formato).
+    bool direct = true;
+};
+
+// Importador de glTF 2.0 (.gltf con .bin externos o URIs data:, y .glb). Los archivos se
+// proyectan en memoria y las primitivas que ya están en un formato que el motor dibuja
+// (posición, normal y tangente en float, UV en float o unorm, índices de 8, 16 o 32 bits)
+// no se copian: se describen como rangos de los buffers para subirlos de una vez con
+// glBufferData y apuntar los atributos del VAO dentro de ellos. Solo las primitivas
+// incompletas pasan por CPU, en paralelo con JobSystem.
+class GltfImporter
+{
+public:
+    static bool load(const std::string& path, GltfModel& model, std::string& error, const GltfImportOptions& options = GltfImportOptions());
+};
+
+#endif // GLTF_IMPORTER_H
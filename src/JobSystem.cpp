@@ -0,0 +1,141 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    bool stopping = false;
+
+    void workerLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [] { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return;
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            job();
+        }
+    }
+
+    // Estado compartido de un parallelFor. Los trabajos encolados pueden empezar cuando
+    // el que llama ya ha repartido todos los bloques; en ese caso no encuentran ninguno.
+    struct ParallelRange {
+        size_t count;
+        size_t grain;
+        size_t blocks;
+        const std::function<void(size_t, size_t)>* body;
+        std::atomic<size_t> next{ 0 };
+        std::atomic<size_t> done{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        void run()
+        {
+            for (;;)
+            {
+                const size_t block = next.fetch_add(1);
+                if (block >= blocks)
+                    return;
+                const size_t begin = block * grain;
+                (*body)(begin, std::min(begin + grain, count));
+                if (done.fetch_add(1) + 1 == blocks)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+}
+
+void JobSystem::init(unsigned threads)
+{
+    if (!workers.empty())
+        return;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency() - 1);
+
+    stopping = false;
+    for (unsigned i = 0; i < threads; ++i)
+        workers.emplace_back(workerLoop);
+}
+
+void JobSystem::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+unsigned JobSystem::threadCount()
+{
+    return (unsigned)workers.size();
+}
+
+void JobSystem::submit(std::function<void()> job)
+{
+    if (workers.empty())
+    {
+        job();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(job));
+    }
+    queueReady.notify_one();
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body)
+{
+    if (count == 0)
+        return;
+    grain = std::max<size_t>(grain, 1);
+    const size_t blocks = (count + grain - 1) / grain;
+    if (workers.empty() || blocks == 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    auto range = std::make_shared<ParallelRange>();
+    range->count = count;
+    range->grain = grain;
+    range->blocks = blocks;
+    range->body = &body;
+
+    const size_t helpers = std::min<size_t>(blocks - 1, workers.size());
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (size_t i = 0; i < helpers; ++i)
+            queue.push_back([range] { range->run(); });
+    }
+    queueReady.notify_all();
+
+    range->run();
+
+    std::unique_lock<std::mutex> lock(range->mutex);
+    range->finished.wait(lock, [&] { return range->done.load() == range->blocks; });
+}
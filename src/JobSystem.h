@@ -0,0 +1,30 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <cstddef>
+#include <functional>
+
+// Conjunto de hilos de trabajo compartido por los sistemas del motor (decodificación de
+// texturas, generación de mips, importadores...). Los trabajos no deben tocar GL: todo
+// lo que necesite el contexto se devuelve al hilo principal.
+// Sin init() (p. ej. en las herramientas) los trabajos se ejecutan en el hilo que llama.
+class JobSystem
+{
+public:
+    // 0 hilos: uno por núcleo menos el principal (mínimo 1).
+    static void init(unsigned threads = 0);
+
+    // Termina los trabajos encolados y une los hilos.
+    static void shutdown();
+
+    static unsigned threadCount();
+
+    // Encola un trabajo sin esperar su resultado.
+    static void submit(std::function<void()> job);
+
+    // Reparte [0, count) en bloques de 'grain' elementos; el hilo que llama también
+    // procesa bloques y vuelve cuando han terminado todos.
+    static void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body);
+};
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,325 @@
+#include "Json.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    const JsonValue& nullValue()
+    {
+        static const JsonValue instance;
+        return instance;
+    }
+
+    // Profundidad máxima de anidamiento: protege la pila ante archivos malformados.
+    const int MAX_DEPTH = 256;
+
+    void appendUtf8(std::string& out, unsigned codepoint)
+    {
+        if (codepoint < 0x80)
+        {
+            out += (char)codepoint;
+        }
+        else if (codepoint < 0x800)
+        {
+            out += (char)(0xC0 | (codepoint >> 6));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000)
+        {
+            out += (char)(0xE0 | (codepoint >> 12));
+            out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            out += (char)(0xF0 | (codepoint >> 18));
+            out += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+            out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        }
+    }
+}
+
+// Analizador descendente recursivo. El texto no tiene por qué acabar en nulo (p. ej. el
+// trozo JSON de un .glb proyectado en memoria).
+class JsonParser
+{
+public:
+    JsonParser(const char* text, size_t length) : p(text), begin(text), end(text + length) {}
+
+    bool parseDocument(JsonValue& value, std::string& error)
+    {
+        skipSpaces();
+        if (!parseValue(value, 0))
+        {
+            error = message + " at offset " + std::to_string(p - begin);
+            return false;
+        }
+        skipSpaces();
+        if (p != end)
+        {
+            error = "trailing characters at offset " + std::to_string(p - begin);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const char* p;
+    const char* begin;
+    const char* end;
+    std::string message;
+
+    bool fail(const char* text)
+    {
+        message = text;
+        return false;
+    }
+
+    void skipSpaces()
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+            p++;
+    }
+
+    bool literal(const char* word)
+    {
+        const size_t length = std::strlen(word);
+        if ((size_t)(end - p) < length || std::memcmp(p, word, length) != 0)
+            return fail("invalid literal");
+        p += length;
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth)
+    {
+        if (depth > MAX_DEPTH)
+            return fail("nesting too deep");
+        if (p == end)
+            return fail("unexpected end of input");
+
+        switch (*p)
+        {
+        case '{': return parseObject(value, depth);
+        case '[': return parseArray(value, depth);
+        case '"':
+            value.kind = JsonValue::Type::String;
+            return parseString(value.text);
+        case 't':
+            value.kind = JsonValue::Type::Bool;
+            value.boolValue = true;
+            return literal("true");
+        case 'f':
+            value.kind = JsonValue::Type::Bool;
+            value.boolValue = false;
+            return literal("false");
+        case 'n':
+            value.kind = JsonValue::Type::Null;
+            return literal("null");
+        default:
+            return parseNumber(value);
+        }
+    }
+
+    bool parseNumber(JsonValue& value)
+    {
+        char buffer[64];
+        size_t length = 0;
+        while (p + length < end && length < sizeof(buffer) - 1 && std::strchr("+-0123456789.eE", p[length]) != nullptr)
+        {
+            buffer[length] = p[length];
+            length++;
+        }
+        buffer[length] = '\0';
+        char* parsedEnd = nullptr;
+        value.numberValue = std::strtod(buffer, &parsedEnd);
+        if (length == 0 || parsedEnd != buffer + length)
+            return fail("invalid number");
+        value.kind = JsonValue::Type::Number;
+        p += length;
+        return true;
+    }
+
+    bool parseHex4(unsigned& codepoint)
+    {
+        if (end - p < 4)
+            return fail("truncated unicode escape");
+        codepoint = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const char c = *p++;
+            codepoint <<= 4;
+            if (c >= '0' && c <= '9')
+                codepoint |= c - '0';
+            else if (c >= 'a' && c <= 'f')
+                codepoint |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                codepoint |= c - 'A' + 10;
+            else
+                return fail("invalid unicode escape");
+        }
+        return true;
+    }
+
+    bool parseString(std::string& out)
+    {
+        p++;    // comilla inicial
+        for (;;)
+        {
+            // Tramo sin escapes de una vez.
+            const char* start = p;
+            while (p < end && *p != '"' && *p != '\\')
+                p++;
+            out.append(start, p);
+            if (p == end)
+                return fail("unterminated string");
+            if (*p == '"')
+            {
+                p++;
+                return true;
+            }
+
+            p++;    // barra invertida
+            if (p == end)
+                return fail("unterminated string");
+            const char escape = *p++;
+            switch (escape)
+            {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u':
+            {
+                unsigned codepoint;
+                if (!parseHex4(codepoint))
+                    return false;
+                // Par sustituto UTF-16 para los caracteres fuera del plano básico.
+                if (codepoint >= 0xD800 && codepoint < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u')
+                {
+                    p += 2;
+                    unsigned low;
+                    if (!parseHex4(low))
+                        return false;
+                    if (low >= 0xDC00 && low < 0xE000)
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, codepoint);
+                break;
+            }
+            default:
+                return fail("invalid escape");
+            }
+        }
+    }
+
+    bool parseArray(JsonValue& value, int depth)
+    {
+        value.kind = JsonValue::Type::Array;
+        p++;
+        skipSpaces();
+        if (p < end && *p == ']')
+        {
+            p++;
+            return true;
+        }
+        for (;;)
+        {
+            value.elements.emplace_back();
+            skipSpaces();
+            if (!parseValue(value.elements.back(), depth + 1))
+                return false;
+            skipSpaces();
+            if (p == end)
+                return fail("unterminated array");
+            if (*p == ']')
+            {
+                p++;
+                return true;
+            }
+            if (*p++ != ',')
+                return fail("expected ',' or ']'");
+        }
+    }
+
+    bool parseObject(JsonValue& value, int depth)
+    {
+        value.kind = JsonValue::Type::Object;
+        p++;
+        skipSpaces();
+        if (p < end && *p == '}')
+        {
+            p++;
+            return true;
+        }
+        for (;;)
+        {
+            skipSpaces();
+            if (p == end || *p != '"')
+                return fail("expected member name");
+            value.members.emplace_back();
+            if (!parseString(value.members.back().first))
+                return false;
+            skipSpaces();
+            if (p == end || *p++ != ':')
+                return fail("expected ':'");
+            skipSpaces();
+            if (!parseValue(value.members.back().second, depth + 1))
+                return false;
+            skipSpaces();
+            if (p == end)
+                return fail("unterminated object");
+            if (*p == '}')
+            {
+                p++;
+                return true;
+            }
+            if (*p++ != ',')
+                return fail("expected ',' or '}'");
+        }
+    }
+};
+
+bool JsonValue::parse(const char* text, size_t length, JsonValue& value, std::string& error)
+{
+    value = JsonValue();
+    JsonParser parser(text, length);
+    return parser.parseDocument(value, error);
+}
+
+const JsonValue& JsonValue::operator[](size_t index) const
+{
+    if (kind != Type::Array || index >= elements.size())
+        return nullValue();
+    return elements[index];
+}
+
+const JsonValue& JsonValue::operator[](const char* key) const
+{
+    if (kind == Type::Object)
+    {
+        for (const auto& member : members)
+        {
+            if (member.first == key)
+                return member.second;
+        }
+    }
+    return nullValue();
+}
+
+bool JsonValue::has(const char* key) const
+{
+    if (kind != Type::Object)
+        return false;
+    for (const auto& member : members)
+    {
+        if (member.first == key)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,57 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Documento JSON en memoria, lo justo para leer formatos de intercambio como glTF.
+// Los accesos a claves o posiciones que no existen devuelven un valor nulo en lugar
+// de fallar, así que se pueden encadenar: json["nodes"][3]["mesh"].integer(-1).
+class JsonValue
+{
+public:
+    enum class Type : unsigned char {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    static bool parse(const char* text, size_t length, JsonValue& value, std::string& error);
+
+    Type type() const { return kind; }
+    bool isNull() const { return kind == Type::Null; }
+    bool isNumber() const { return kind == Type::Number; }
+    bool isString() const { return kind == Type::String; }
+    bool isArray() const { return kind == Type::Array; }
+    bool isObject() const { return kind == Type::Object; }
+
+    double number(double fallback = 0.0) const { return kind == Type::Number ? numberValue : fallback; }
+    long long integer(long long fallback = 0) const { return kind == Type::Number ? (long long)numberValue : fallback; }
+    bool boolean(bool fallback = false) const { return kind == Type::Bool ? boolValue : fallback; }
+    const std::string& string() const { return text; }
+
+    // Elementos de un array o miembros de un objeto.
+    size_t size() const { return kind == Type::Array ? elements.size() : kind == Type::Object ? members.size() : 0; }
+    const JsonValue& operator[](size_t index) const;
+    const JsonValue& operator[](int index) const { return (*this)[(size_t)index]; }
+    const JsonValue& operator[](const char* key) const;
+    bool has(const char* key) const;
+    const std::vector<std::pair<std::string, JsonValue>>& objectMembers() const { return members; }
+
+private:
+    Type kind = Type::Null;
+    bool boolValue = false;
+    double numberValue = 0.0;
+    std::string text;
+    std::vector<JsonValue> elements;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    friend class JsonParser;
+};
+
+#endif // JSON_H
@@ -0,0 +1,212 @@
+#include "KtxFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const unsigned char KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+    const size_t HEADER_SIZE = 80;          // identificador + cabecera + índice
+    const size_t LEVEL_INDEX_ENTRY = 24;    // byteOffset, byteLength, uncompressedByteLength
+
+    // VkFormat y modelo de color del Data Format Descriptor de cada formato.
+    struct FormatInfo {
+        BlockFormat format;
+        uint32_t vkFormat;
+        uint32_t colorModel;
+        int samples;
+        uint32_t channels[2];
+    };
+
+    const FormatInfo FORMATS[] = {
+        { BlockFormat::BC1, 131, 128, 1, { 0, 0 } },    // VK_FORMAT_BC1_RGB_UNORM_BLOCK, KHR_DF_MODEL_BC1A
+        { BlockFormat::BC3, 137, 130, 2, { 15, 0 } },   // VK_FORMAT_BC3_UNORM_BLOCK, KHR_DF_MODEL_BC3 (alfa, color)
+        { BlockFormat::BC4, 139, 131, 1, { 0, 0 } },    // VK_FORMAT_BC4_UNORM_BLOCK, KHR_DF_MODEL_BC4
+        { BlockFormat::BC5, 141, 132, 2, { 0, 1 } },    // VK_FORMAT_BC5_UNORM_BLOCK, KHR_DF_MODEL_BC5 (rojo, verde)
+    };
+
+    const FormatInfo* findFormat(BlockFormat format)
+    {
+        for (const FormatInfo& info : FORMATS)
+        {
+            if (info.format == format)
+                return &info;
+        }
+        return nullptr;
+    }
+
+    const FormatInfo* findVkFormat(uint32_t vkFormat)
+    {
+        for (const FormatInfo& info : FORMATS)
+        {
+            if (info.vkFormat == vkFormat)
+                return &info;
+        }
+        return nullptr;
+    }
+
+    void put32(std::vector<uint8_t>& out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out.push_back((uint8_t)(value >> (i * 8)));
+    }
+
+    void put64(std::vector<uint8_t>& out, uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            out.push_back((uint8_t)(value >> (i * 8)));
+    }
+
+    void patch64(std::vector<uint8_t>& out, size_t position, uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            out[position + i] = (uint8_t)(value >> (i * 8));
+    }
+
+    uint32_t read32(const unsigned char* data)
+    {
+        return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+    }
+
+    uint64_t read64(const unsigned char* data)
+    {
+        return (uint64_t)read32(data) | ((uint64_t)read32(data + 4) << 32);
+    }
+
+    // Descriptor básico (KHR_DF_VENDORID_KHRONOS, versión 2) para un formato BCn lineal.
+    std::vector<uint8_t> buildDataFormatDescriptor(const FormatInfo& info)
+    {
+        const uint32_t blockSize = 24 + 16 * info.samples;
+        std::vector<uint8_t> dfd;
+        put32(dfd, 4 + blockSize);                           // dfdTotalSize
+        put32(dfd, 0);                                       // vendorId | descriptorType
+        put32(dfd, 2 | (blockSize << 16));                   // versionNumber | descriptorBlockSize
+        put32(dfd, info.colorModel | (1u << 8) | (1u << 16)); // modelo | BT.709 | transferencia lineal | flags
+        put32(dfd, 3 | (3 << 8));                            // bloque de 4x4x1x1 (valor - 1)
+        put32(dfd, (uint32_t)BlockCompression::blockBytes(info.format)); // bytesPlane0
+        put32(dfd, 0);
+        for (int sample = 0; sample < info.samples; ++sample)
+        {
+            put32(dfd, (uint32_t)(sample * 64) | (63u << 16) | (info.channels[sample] << 24));
+            put32(dfd, 0);          // posición de la muestra
+            put32(dfd, 0);          // sampleLower
+            put32(dfd, 0xFFFFFFFF); // sampleUpper
+        }
+        return dfd;
+    }
+}
+
+bool KtxFile::write(const std::string& path, BlockFormat format, uint32_t width, uint32_t height,
+                    const std::vector<std::vector<uint8_t>>& levels)
+{
+    const FormatInfo* info = findFormat(format);
+    if (!info || levels.empty())
+        return false;
+
+    std::vector<uint8_t> out(KTX2_IDENTIFIER, KTX2_IDENTIFIER + sizeof(KTX2_IDENTIFIER));
+    put32(out, info->vkFormat);
+    put32(out, 1);                      // typeSize
+    put32(out, width);
+    put32(out, height);
+    put32(out, 0);                      // pixelDepth
+    put32(out, 0);                      // layerCount
+    put32(out, 1);                      // faceCount
+    put32(out, (uint32_t)levels.size());
+    put32(out, 0);                      // supercompressionScheme
+
+    const std::vector<uint8_t> dfd = buildDataFormatDescriptor(*info);
+    const size_t dfdOffset = HEADER_SIZE + levels.size() * LEVEL_INDEX_ENTRY;
+    put32(out, (uint32_t)dfdOffset);
+    put32(out, (uint32_t)dfd.size());
+    put32(out, 0);                      // kvdByteOffset
+    put32(out, 0);                      // kvdByteLength
+    put64(out, 0);                      // sgdByteOffset
+    put64(out, 0);                      // sgdByteLength
+
+    const size_t levelIndex = out.size();
+    out.resize(out.size() + levels.size() * LEVEL_INDEX_ENTRY, 0);
+    out.insert(out.end(), dfd.begin(), dfd.end());
+
+    // Cada nivel se alinea al tamaño de bloque (múltiplo de 4, como exige el formato).
+    const size_t alignment = BlockCompression::blockBytes(format);
+    for (size_t level = levels.size(); level-- > 0;)
+    {
+        out.resize((out.size() + alignment - 1) / alignment * alignment, 0);
+        const size_t entry = levelIndex + level * LEVEL_INDEX_ENTRY;
+        patch64(out, entry, out.size());
+        patch64(out, entry + 8, levels[level].size());
+        patch64(out, entry + 16, levels[level].size());
+        out.insert(out.end(), levels[level].begin(), levels[level].end());
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    const bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    std::fclose(file);
+    return written;
+}
+
+bool KtxFile::parse(const unsigned char* data, size_t size, KtxImage& image, std::string& error)
+{
+    if (size < HEADER_SIZE || std::memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+    {
+        error = "not a KTX2 file";
+        return false;
+    }
+
+    const unsigned char* header = data + sizeof(KTX2_IDENTIFIER);
+    const FormatInfo* info = findVkFormat(read32(header));
+    const uint32_t pixelDepth = read32(header + 16);
+    const uint32_t layerCount = read32(header + 20);
+    const uint32_t faceCount = read32(header + 24);
+    const uint32_t levelCount = read32(header + 28);
+    const uint32_t supercompression = read32(header + 32);
+    if (!info)
+    {
+        error = "unsupported vkFormat " + std::to_string(read32(header));
+        return false;
+    }
+    if (pixelDepth != 0 || layerCount != 0 || faceCount != 1 || supercompression != 0 || levelCount == 0)
+    {
+        error = "only single 2D textures without supercompression and with a stored mip chain are supported";
+        return false;
+    }
+
+    image.format = info->format;
+    image.width = read32(header + 8);
+    image.height = read32(header + 12);
+    if (image.width == 0 || image.height == 0 || size < HEADER_SIZE + (size_t)levelCount * LEVEL_INDEX_ENTRY)
+    {
+        error = "truncated header";
+        return false;
+    }
+    // Como mucho la cadena completa hasta 1x1: más niveles desplazarían el ancho 32 bits
+    // o más y llegarían tal cual a GL_TEXTURE_MAX_LEVEL.
+    uint32_t fullChain = 1;
+    while (((uint64_t)std::max(image.width, image.height) >> fullChain) > 0)
+        fullChain++;
+    if (levelCount > fullChain)
+    {
+        error = "levelCount " + std::to_string(levelCount) + " exceeds the " + std::to_string(fullChain) + " levels of a full mip chain";
+        return false;
+    }
+
+    image.levels.clear();
+    for (uint32_t level = 0; level < levelCount; ++level)
+    {
+        const unsigned char* entry = data + HEADER_SIZE + level * LEVEL_INDEX_ENTRY;
+        const uint64_t offset = read64(entry);
+        const uint64_t length = read64(entry + 8);
+        const int levelWidth = std::max(1, (int)(image.width >> level));
+        const int levelHeight = std::max(1, (int)(image.height >> level));
+        if (length != BlockCompression::compressedSize(info->format, levelWidth, levelHeight) || offset > size || length > size - offset)
+        {
+            error = "level " + std::to_string(level) + " is out of bounds or has the wrong size";
+            return false;
+        }
+        image.levels.push_back({ (size_t)offset, (size_t)length });
+    }
+    return true;
+}
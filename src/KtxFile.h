@@ -0,0 +1,38 @@
+#ifndef KTX_FILE_H
+#define KTX_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BlockCompression.h"
+
+// Contenedor KTX2 (Khronos) limitado a lo que produce chaos-texcook: una textura 2D,
+// sin capas ni caras, con compresión BCn, sin supercompresión y con todos los mips.
+// Los datos de cada nivel se leen en el sitio desde el archivo proyectado en memoria.
+struct KtxLevel {
+    size_t offset;
+    size_t size;
+};
+
+struct KtxImage {
+    BlockFormat format = BlockFormat::BC1;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<KtxLevel> levels;   // índice = nivel de mip
+};
+
+class KtxFile
+{
+public:
+    // 'levels' empieza en el nivel 0. El archivo guarda los niveles del más pequeño al
+    // más grande, como pide la especificación.
+    static bool write(const std::string& path, BlockFormat format, uint32_t width, uint32_t height,
+                      const std::vector<std::vector<uint8_t>>& levels);
+
+    // Valida la cabecera y que cada nivel esté dentro del archivo con el tamaño esperado.
+    static bool parse(const unsigned char* data, size_t size, KtxImage& image, std::string& error);
+};
+
+#endif // KTX_FILE_H
@@ -0,0 +1,259 @@
+#include "Lz4.h"
+
+#include <cstring>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+    const size_t MIN_MATCH = 4;
+    const size_t LAST_LITERALS = 5;     // el bloque acaba siempre con 5 literales
+    const size_t MATCH_FIND_LIMIT = 12; // ninguna copia empieza en los últimos 12 bytes
+    const size_t MAX_OFFSET = 65535;
+    const int HASH_BITS = 14;
+
+    uint32_t read32(const uint8_t* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint64_t read64(const uint8_t* p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // Bytes iguales al principio de dos palabras little-endian distintas.
+    size_t equalLowBytes(uint64_t difference)
+    {
+#ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanForward64(&bit, difference);
+        return bit >> 3;
+#else
+        return (size_t)__builtin_ctzll(difference) >> 3;
+#endif
+    }
+
+    uint32_t hashSequence(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    // Longitud en la forma de LZ4: el nibble del token llega a 15 y el resto va en bytes
+    // de 255 terminados por uno menor.
+    uint8_t* writeLength(uint8_t* output, size_t length)
+    {
+        for (length -= 15; length >= 255; length -= 255)
+            *output++ = 255;
+        *output++ = (uint8_t)length;
+        return output;
+    }
+
+    bool readLength(const uint8_t*& input, const uint8_t* end, size_t& length)
+    {
+        uint8_t byte;
+        do
+        {
+            if (input >= end)
+                return false;
+            byte = *input++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    // Escribe una secuencia (literales y, con matchLength > 0, la copia que los sigue).
+    // Devuelve nulo si no cabe.
+    uint8_t* writeSequence(uint8_t* output, const uint8_t* outputEnd, const uint8_t* literals, size_t literalCount,
+                           size_t offset, size_t matchLength)
+    {
+        const size_t worst = 1 + literalCount / 255 + 1 + literalCount + 2 + matchLength / 255 + 1;
+        if ((size_t)(outputEnd - output) < worst)
+            return nullptr;
+
+        uint8_t* token = output++;
+        *token = (uint8_t)((literalCount < 15 ? literalCount : 15) << 4);
+        if (literalCount >= 15)
+            output = writeLength(output, literalCount);
+        if (literalCount > 0)
+            std::memcpy(output, literals, literalCount);
+        output += literalCount;
+
+        if (matchLength > 0)
+        {
+            *output++ = (uint8_t)(offset & 0xFF);
+            *output++ = (uint8_t)(offset >> 8);
+            const size_t length = matchLength - MIN_MATCH;
+            *token |= (uint8_t)(length < 15 ? length : 15);
+            if (length >= 15)
+                output = writeLength(output, length);
+        }
+        return output;
+    }
+}
+
+size_t Lz4::compressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t Lz4::compress(const uint8_t* input, size_t size, uint8_t* output, size_t capacity)
+{
+    uint8_t* out = output;
+    uint8_t* const outEnd = output + capacity;
+    size_t anchor = 0;
+
+    if (size > MATCH_FIND_LIMIT)
+    {
+        // Última posición vista de cada secuencia de 4 bytes. Las entradas viejas o de
+        // otra secuencia se descartan al comparar.
+        std::vector<uint32_t> table((size_t)1 << HASH_BITS, 0);
+        const size_t matchLimit = size - LAST_LITERALS;
+        const size_t searchLimit = size - MATCH_FIND_LIMIT;
+
+        size_t position = 1;
+        table[hashSequence(read32(input))] = 0;
+        while (position < searchLimit)
+        {
+            const uint32_t sequence = read32(input + position);
+            const uint32_t hash = hashSequence(sequence);
+            const size_t candidate = table[hash];
+            table[hash] = (uint32_t)position;
+
+            if (candidate >= position || position - candidate > MAX_OFFSET || read32(input + candidate) != sequence)
+            {
+                // Sin coincidencia: en zonas que no se repiten el paso crece para no
+                // perder tiempo en datos incompresibles.
+                position += 1 + ((position - anchor) >> 6);
+                continue;
+            }
+
+            size_t start = position;
+            size_t match = candidate;
+            while (start > anchor && match > 0 && input[start - 1] == input[match - 1])
+            {
+                start--;
+                match--;
+            }
+            // La coincidencia se alarga de 8 en 8 bytes y el último bloque se resuelve con
+            // el primer bit distinto.
+            size_t length = MIN_MATCH + (position - start);
+            while (start + length + 8 <= matchLimit)
+            {
+                const uint64_t difference = read64(input + start + length) ^ read64(input + match + length);
+                if (difference != 0)
+                {
+                    length += equalLowBytes(difference);
+                    break;
+                }
+                length += 8;
+            }
+            if (start + length + 8 > matchLimit)
+            {
+                while (start + length < matchLimit && input[start + length] == input[match + length])
+                    length++;
+            }
+
+            out = writeSequence(out, outEnd, input + anchor, start - anchor, start - match, length);
+            if (!out)
+                return 0;
+            anchor = position = start + length;
+            if (position - 2 < searchLimit)
+                table[hashSequence(read32(input + position - 2))] = (uint32_t)(position - 2);
+        }
+    }
+
+    out = writeSequence(out, outEnd, input + anchor, size - anchor, 0, 0);
+    return out ? (size_t)(out - output) : 0;
+}
+
+bool Lz4::decompress(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize)
+{
+    const uint8_t* in = input;
+    const uint8_t* const inEnd = input + inputSize;
+    uint8_t* out = output;
+    uint8_t* const outEnd = output + outputSize;
+
+    while (in < inEnd)
+    {
+        const uint8_t token = *in++;
+        size_t literals = token >> 4;
+
+        // Camino rápido para la secuencia típica: menos de 15 literales, copia de 4 a 18
+        // bytes con offset >= 8 y margen de sobra en los dos buffers. Todo se copia en
+        // bloques de tamaño fijo; los bytes de más los sobrescribe la secuencia siguiente.
+        if (literals < 15 && (token & 15) < 15 && inEnd - in >= 18 && outEnd - out >= 32)
+        {
+            const size_t offset = (size_t)in[literals] | ((size_t)in[literals + 1] << 8);
+            if (offset >= 8 && offset <= (size_t)(out - output) + literals)
+            {
+                std::memcpy(out, in, 16);
+                out += literals;
+                in += literals + 2;
+                const uint8_t* match = out - offset;
+                std::memcpy(out, match, 8);
+                std::memcpy(out + 8, match + 8, 8);
+                std::memcpy(out + 16, match + 16, 2);
+                out += (token & 15) + MIN_MATCH;
+                continue;
+            }
+        }
+
+        if (literals == 15 && !readLength(in, inEnd, literals))
+            return false;
+        if (literals > (size_t)(inEnd - in) || literals > (size_t)(outEnd - out))
+            return false;
+        // Los literales cortos (los más frecuentes) se copian de 16 en 16 si hay margen:
+        // una copia de tamaño fijo es mucho más barata que un memcpy de tamaño variable.
+        if (literals <= 16 && inEnd - in >= 16 && outEnd - out >= 16)
+            std::memcpy(out, in, 16);
+        else if (literals > 0)
+            std::memcpy(out, in, literals);
+        in += literals;
+        out += literals;
+
+        // La última secuencia solo tiene literales.
+        if (in == inEnd)
+            break;
+
+        if (inEnd - in < 2)
+            return false;
+        const size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > (size_t)(out - output))
+            return false;
+
+        size_t length = token & 15;
+        if (length == 15 && !readLength(in, inEnd, length))
+            return false;
+        length += MIN_MATCH;
+        if (length > (size_t)(outEnd - out))
+            return false;
+
+        const uint8_t* match = out - offset;
+        if (offset >= 8 && (size_t)(outEnd - out) >= length + 8)
+        {
+            // De 8 en 8: con offset >= 8 cada bloque lee bytes ya escritos, aunque la
+            // copia se solape consigo misma. Puede escribir hasta 7 bytes de más, dentro
+            // del margen, que la secuencia siguiente sobrescribe.
+            uint8_t* const end = out + length;
+            for (uint8_t* cursor = out; cursor < end; cursor += 8, match += 8)
+                std::memcpy(cursor, match, 8);
+            out = end;
+        }
+        else
+        {
+            // Copia solapada: repite un patrón más corto que la copia.
+            for (size_t i = 0; i < length; ++i)
+                *out++ = match[i];
+        }
+    }
+    return out == outEnd;
+}
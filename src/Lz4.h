@@ -0,0 +1,24 @@
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Compresor del formato de bloque de LZ4: secuencias de literales y copias de hasta 64 KB
+// atrás, sin entropía, para que descomprimir vaya al ritmo de memcpy. Lo usan los
+// paquetes de assets (ver AssetPack.h).
+class Lz4
+{
+public:
+    // Tamaño de salida que garantiza que compress() no falla.
+    static size_t compressBound(size_t size);
+
+    // Devuelve los bytes escritos en 'output', o 0 si no caben en 'capacity'.
+    static size_t compress(const uint8_t* input, size_t size, uint8_t* output, size_t capacity);
+
+    // Descomprime un bloque que debe producir exactamente 'outputSize' bytes. Comprueba
+    // todos los límites: una entrada corrupta devuelve false sin salirse de los buffers.
+    static bool decompress(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize);
+};
+
+#endif // LZ4_H
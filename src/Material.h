@@ -0,0 +1,37 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <glm/glm.hpp>
+
+// Unidades de textura fijas de los mapas PBR (coinciden con los samplers de basic.frag).
+// Con los layouts PackedORM y MetallicRoughness la unidad 2 lleva la textura empaquetada
+// y la 3 queda libre.
+enum MaterialTextureUnit {
+    ALBEDO_UNIT = 0,
+    NORMAL_UNIT = 1,
+    METALLIC_UNIT = 2,
+    ROUGHNESS_UNIT = 3,
+    ORM_UNIT = 2,
+    MATERIAL_TEXTURE_UNITS = 4
+};
+
+// Cómo se reparten las propiedades PBR entre las texturas del material.
+enum class MaterialLayout : unsigned char {
+    Separate,   // metálico y rugosidad en texturas propias (canal r); oclusión solo por instancia
+    PackedORM,  // una textura: r = oclusión, g = rugosidad, b = metálico (convención glTF)
+    MetallicRoughness   // metallicRoughnessTexture de glTF sin oclusión: g = rugosidad, b = metálico
+};
+
+// Conjunto de texturas que se enlazan juntas para dibujar un objeto.
+// Un ID 0 deja la unidad sin textura (p. ej. el material sin texturas de las luces).
+// Los factores multiplican lo que se lee de las texturas (baseColorFactor en lineal),
+// como los factores de un material glTF.
+struct Material {
+    unsigned int textures[MATERIAL_TEXTURE_UNITS] = { 0, 0, 0, 0 };
+    MaterialLayout layout = MaterialLayout::Separate;
+    glm::vec3 baseColorFactor = glm::vec3(1.0f);
+    float metallicFactor = 1.0f;
+    float roughnessFactor = 1.0f;
+};
+
+#endif // MATERIAL_H
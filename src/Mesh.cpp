@@ -0,0 +1,132 @@
+#include "Mesh.h"
+#include "GLState.h"
+
+#include <cstddef>
+
+namespace
+{
+    // Atributos de CompactVertex a partir del byte 'offset' del GL_ARRAY_BUFFER enlazado.
+    // La normal y la tangente comparten la ubicación 1 (xy normal, zw tangente).
+    void setCompactAttributes(size_t offset)
+    {
+        const GLsizei stride = sizeof(CompactVertex);
+        glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)(offset + offsetof(CompactVertex, position)));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_SHORT, GL_TRUE, stride, (void*)(offset + offsetof(CompactVertex, normal)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(CompactVertex, texCoords)));
+        glEnableVertexAttribArray(2);
+    }
+}
+
+Mesh uploadMesh(const MeshData& data, VertexFormat format)
+{
+    Mesh mesh;
+    mesh.vertexCount = (GLsizei)data.vertices.size();
+    mesh.indexCount = (GLsizei)data.indices.size();
+    mesh.format = format;
+
+    glGenVertexArrays(1, &mesh.VAO);
+    glGenBuffers(1, &mesh.VBO);
+    glGenBuffers(1, &mesh.EBO);
+
+    GLState::bindVertexArray(mesh.VAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    if (format == VertexFormat::Compact)
+    {
+        std::vector<CompactVertex> packed = compressVertices(data.vertices, mesh.boundsMin, mesh.boundsExtent);
+        glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(CompactVertex), packed.data(), GL_STATIC_DRAW);
+        setCompactAttributes(0);
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, data.vertices.size() * sizeof(Vertex), data.vertices.data(), GL_STATIC_DRAW);
+
+        const GLsizei stride = sizeof(Vertex);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, position));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, normal));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, texCoords));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, tangent));
+        glEnableVertexAttribArray(3);
+    }
+
+    // Índices de 16 bits siempre que sea posible: la mitad de ancho de banda.
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    if (data.vertices.size() <= 0x10000)
+    {
+        std::vector<uint16_t> shortIndices(data.indices.begin(), data.indices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t), shortIndices.data(), GL_STATIC_DRAW);
+        mesh.indexType = GL_UNSIGNED_SHORT;
+    }
+    else
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(uint32_t), data.indices.data(), GL_STATIC_DRAW);
+        mesh.indexType = GL_UNSIGNED_INT;
+    }
+
+    return mesh;
+}
+
+Mesh createStreamMesh(const VertexStream (&streams)[4], GLuint indexBuffer, size_t indexOffset, GLenum indexType,
+                      GLsizei indexCount, GLsizei vertexCount, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    Mesh mesh;
+    mesh.format = VertexFormat::Float;
+    mesh.vertexCount = vertexCount;
+    mesh.indexCount = indexCount;
+    mesh.indexType = indexType;
+    mesh.indexOffset = indexOffset;
+    mesh.boundsMin = boundsMin;
+    mesh.boundsExtent = boundsMax - boundsMin;
+
+    glGenVertexArrays(1, &mesh.VAO);
+    GLState::bindVertexArray(mesh.VAO);
+    for (GLuint location = 0; location < 4; ++location)
+    {
+        const VertexStream& stream = streams[location];
+        GLState::bindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+        glVertexAttribPointer(location, stream.components, stream.type, stream.normalized, stream.stride, (void*)stream.offset);
+        glEnableVertexAttribArray(location);
+    }
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    return mesh;
+}
+
+Mesh createCompactMesh(GLuint vertexBuffer, size_t vertexOffset, GLsizei vertexCount, GLuint indexBuffer, size_t indexOffset,
+                       GLenum indexType, GLsizei indexCount, const glm::vec3& boundsMin, const glm::vec3& boundsExtent)
+{
+    Mesh mesh;
+    mesh.vertexCount = vertexCount;
+    mesh.indexCount = indexCount;
+    mesh.indexType = indexType;
+    mesh.indexOffset = indexOffset;
+    mesh.boundsMin = boundsMin;
+    mesh.boundsExtent = boundsExtent;
+
+    glGenVertexArrays(1, &mesh.VAO);
+    GLState::bindVertexArray(mesh.VAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    setCompactAttributes(vertexOffset);
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    return mesh;
+}
+
+void bindMeshBounds(const Mesh& mesh)
+{
+    glVertexAttrib3f(MESH_BOUNDS_MIN_LOCATION, mesh.boundsMin.x, mesh.boundsMin.y, mesh.boundsMin.z);
+    glVertexAttrib3f(MESH_BOUNDS_EXTENT_LOCATION, mesh.boundsExtent.x, mesh.boundsExtent.y, mesh.boundsExtent.z);
+}
+
+void deleteMesh(Mesh& mesh)
+{
+    if (mesh.VAO)
+        GLState::deleteVertexArray(mesh.VAO);
+    if (mesh.VBO)
+        GLState::deleteBuffer(mesh.VBO);
+    if (mesh.EBO)
+        GLState::deleteBuffer(mesh.EBO);
+    mesh = Mesh();
+}
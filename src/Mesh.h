@@ -0,0 +1,80 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "CompactVertex.h"
+#include "MeshBuilder.h"
+
+// Formato de los vértices en la GPU.
+//  - Compact (por defecto, 20 bytes): posición cuantizada a unorm16 dentro de la caja
+//    de la malla, normal y tangente en codificación octaédrica snorm16, UV en half y
+//    el signo de la tangente en el cuarto componente de la posición.
+//  - Float (48 bytes): el Vertex de CPU tal cual. Los shaders de malla solo lo leen
+//    si se compilan con FLOAT_VERTEX (ver assets/shaders/common/vertex.glsl).
+enum class VertexFormat : uint8_t {
+    Compact,
+    Float
+};
+
+// Ubicaciones de atributo de la caja de la malla. No están activas en el VAO: son
+// valores constantes (glVertexAttrib) que la cola de render fija al cambiar de malla.
+const GLuint MESH_BOUNDS_MIN_LOCATION = 9;
+const GLuint MESH_BOUNDS_EXTENT_LOCATION = 10;
+
+// Geometría ya subida a la GPU, lista para dibujarse con un único VAO.
+// Si indexCount > 0 se dibuja indexada con indexType (8, 16 o 32 bits) empezando en el
+// byte indexOffset del buffer de índices. VBO/EBO valen 0 cuando los buffers no son de
+// la malla (ver createStreamMesh).
+struct Mesh {
+    unsigned int VAO = 0;
+    unsigned int VBO = 0;
+    unsigned int EBO = 0;
+    GLenum mode = GL_TRIANGLES;
+    GLsizei vertexCount = 0;
+    GLsizei indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t indexOffset = 0;
+    VertexFormat format = VertexFormat::Compact;
+    // Caja para descuantizar las posiciones: p = min + q * extent.
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsExtent = glm::vec3(1.0f);
+};
+
+// Sube una malla indexada en el formato pedido, con índices de 16 bits cuando todos
+// los vértices caben.
+Mesh uploadMesh(const MeshData& data, VertexFormat format = VertexFormat::Compact);
+
+// Atributo que ya está en un buffer de la GPU tal como lo describe el archivo de origen
+// (p. ej. un accessor de glTF): tipo, componentes, separación y desplazamiento.
+struct VertexStream {
+    GLuint buffer = 0;
+    size_t offset = 0;
+    GLint components = 0;
+    GLenum type = GL_FLOAT;
+    GLboolean normalized = GL_FALSE;
+    GLsizei stride = 0;
+};
+
+// Malla en formato Float cuyos atributos (posición, normal, UV y tangente, en las
+// ubicaciones de FLOAT_VERTEX) e índices apuntan a buffers existentes, sin copiar ni
+// convertir nada. Los buffers siguen siendo de quien llama: deleteMesh solo borra el VAO.
+Mesh createStreamMesh(const VertexStream (&streams)[4], GLuint indexBuffer, size_t indexOffset, GLenum indexType,
+                      GLsizei indexCount, GLsizei vertexCount, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+// Malla Compact cuyos vértices (CompactVertex desde el byte vertexOffset) e índices ya
+// están en buffers compartidos, p. ej. las secciones de un .cmesh. Como en
+// createStreamMesh, los buffers siguen siendo de quien llama.
+Mesh createCompactMesh(GLuint vertexBuffer, size_t vertexOffset, GLsizei vertexCount, GLuint indexBuffer, size_t indexOffset,
+                       GLenum indexType, GLsizei indexCount, const glm::vec3& boundsMin, const glm::vec3& boundsExtent);
+
+// Fija los atributos constantes de la caja de la malla (ubicaciones 9 y 10).
+void bindMeshBounds(const Mesh& mesh);
+
+void deleteMesh(Mesh& mesh);
+
+#endif // MESH_H
@@ -0,0 +1,487 @@
+#include "MeshBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    const float PI = 3.14159265359f;
+
+    // Vértice con los -0.0f convertidos a 0.0f para que la comparación bit a bit no
+    // separe vértices iguales.
+    Vertex canonical(const Vertex& vertex)
+    {
+        Vertex result = vertex;
+        float* values = reinterpret_cast<float*>(&result);
+        for (size_t i = 0; i < sizeof(Vertex) / sizeof(float); ++i)
+        {
+            if (values[i] == 0.0f)
+                values[i] = 0.0f;
+        }
+        return result;
+    }
+
+    uint32_t hashVertex(const Vertex& vertex)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < sizeof(Vertex); ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Puntuaciones del algoritmo de Forsyth ("Linear-Speed Vertex Cache Optimisation").
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    float vertexScore(int cachePosition, int activeTriangles, int cacheSize)
+    {
+        if (activeTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            // Los tres vértices del último triángulo reciben una puntuación fija para
+            // no favorecer uno de ellos frente a los otros.
+            if (cachePosition < 3)
+                score = LAST_TRIANGLE_SCORE;
+            else
+                score = std::pow(1.0f - (float)(cachePosition - 3) / (float)(cacheSize - 3), CACHE_DECAY_POWER);
+        }
+        // Bonificación a vértices con pocos triángulos pendientes, para cerrarlos pronto.
+        score += VALENCE_BOOST_SCALE * std::pow((float)activeTriangles, -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    void addQuad(std::vector<Vertex>& triangles, const Vertex& v00, const Vertex& v10, const Vertex& v11, const Vertex& v01)
+    {
+        triangles.insert(triangles.end(), { v00, v10, v11, v00, v11, v01 });
+    }
+}
+
+MeshData MeshBuilder::weld(const std::vector<Vertex>& triangles)
+{
+    MeshData mesh;
+    mesh.indices.reserve(triangles.size());
+
+    // Tabla de direccionamiento abierto con índice+1 (0 = vacío).
+    size_t capacity = 16;
+    while (capacity < triangles.size() * 2)
+        capacity *= 2;
+    std::vector<uint32_t> table(capacity, 0);
+    const size_t mask = capacity - 1;
+
+    for (const Vertex& source : triangles)
+    {
+        const Vertex vertex = canonical(source);
+        size_t slot = hashVertex(vertex) & mask;
+        while (table[slot] != 0 && std::memcmp(&mesh.vertices[table[slot] - 1], &vertex, sizeof(Vertex)) != 0)
+            slot = (slot + 1) & mask;
+
+        if (table[slot] == 0)
+        {
+            mesh.vertices.push_back(vertex);
+            table[slot] = (uint32_t)mesh.vertices.size();
+        }
+        mesh.indices.push_back(table[slot] - 1);
+    }
+    return mesh;
+}
+
+void MeshBuilder::optimizeVertexCache(MeshData& mesh)
+{
+    optimizeVertexCache(mesh.indices, mesh.vertices.size());
+}
+
+void MeshBuilder::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // Adyacencia vértice -> triángulos en un único array (offsets + lista).
+    std::vector<uint32_t> activeCount(vertexCount, 0);
+    for (uint32_t index : indices)
+        activeCount[index]++;
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + activeCount[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+        }
+    }
+
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        score[v] = vertexScore(-1, activeCount[v], CACHE_SIZE);
+    std::vector<bool> emitted(triangleCount, false);
+
+    // La caché simulada guarda 3 posiciones extra para los vértices recién expulsados.
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> nextCache;
+    cache.reserve(CACHE_SIZE + 3);
+    nextCache.reserve(CACHE_SIZE + 3);
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    size_t scanPosition = 0;
+    long bestTriangle = -1;
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        // Sin candidato en la caché: el siguiente pendiente en orden de entrada. Así el
+        // coste total de estos saltos es lineal incluso con muchas piezas sueltas.
+        if (bestTriangle < 0)
+        {
+            while (emitted[scanPosition])
+                scanPosition++;
+            bestTriangle = (long)scanPosition;
+        }
+
+        const size_t triangle = (size_t)bestTriangle;
+        emitted[triangle] = true;
+
+        // Emitir el triángulo y sacarlo de la adyacencia de sus vértices.
+        nextCache.clear();
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t v = indices[triangle * 3 + k];
+            output.push_back(v);
+            nextCache.push_back(v);
+
+            uint32_t* begin = &adjacency[adjacencyOffset[v]];
+            uint32_t* end = begin + activeCount[v];
+            uint32_t* found = std::find(begin, end, (uint32_t)triangle);
+            if (found != end)
+            {
+                std::swap(*found, *(end - 1));
+                activeCount[v]--;
+            }
+        }
+
+        // Nueva caché LRU: el triángulo al frente y el resto detrás, sin duplicados.
+        for (uint32_t v : cache)
+        {
+            if (v != nextCache[0] && v != nextCache[1] && v != nextCache[2])
+                nextCache.push_back(v);
+        }
+        // Los expulsados siguen en nextCache hasta el final para actualizar sus triángulos.
+        for (size_t i = CACHE_SIZE; i < nextCache.size(); ++i)
+            score[nextCache[i]] = vertexScore(-1, activeCount[nextCache[i]], CACHE_SIZE);
+        const size_t kept = std::min(nextCache.size(), (size_t)CACHE_SIZE);
+        for (size_t i = 0; i < kept; ++i)
+            score[nextCache[i]] = vertexScore((int)i, activeCount[nextCache[i]], CACHE_SIZE);
+
+        // Recalcular los triángulos afectados y elegir el mejor candidato en caché.
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < nextCache.size(); ++i)
+        {
+            const uint32_t v = nextCache[i];
+            for (uint32_t a = 0; a < activeCount[v]; ++a)
+            {
+                const uint32_t t = adjacency[adjacencyOffset[v] + a];
+                const float value = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                if (value > bestScore)
+                {
+                    bestScore = value;
+                    bestTriangle = (long)t;
+                }
+            }
+        }
+
+        nextCache.resize(kept);
+        cache.swap(nextCache);
+    }
+
+    indices.swap(output);
+}
+
+void MeshBuilder::optimizeVertexFetch(MeshData& mesh)
+{
+    const uint32_t unused = 0xFFFFFFFFu;
+    std::vector<uint32_t> remap(mesh.vertices.size(), unused);
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+
+    for (uint32_t& index : mesh.indices)
+    {
+        if (remap[index] == unused)
+        {
+            remap[index] = (uint32_t)vertices.size();
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    // Los vértices no referenciados se descartan.
+    mesh.vertices.swap(vertices);
+}
+
+void MeshBuilder::computeTangents(MeshData& mesh)
+{
+    std::vector<glm::vec3> tangents(mesh.vertices.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> bitangents(mesh.vertices.size(), glm::vec3(0.0f));
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        const uint32_t a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+        const glm::vec3 edge1 = mesh.vertices[b].position - mesh.vertices[a].position;
+        const glm::vec3 edge2 = mesh.vertices[c].position - mesh.vertices[a].position;
+        const glm::vec2 uv1 = mesh.vertices[b].texCoords - mesh.vertices[a].texCoords;
+        const glm::vec2 uv2 = mesh.vertices[c].texCoords - mesh.vertices[a].texCoords;
+        const float determinant = uv1.x * uv2.y - uv2.x * uv1.y;
+        if (std::abs(determinant) < 1e-12f)
+            continue;
+
+        // Sin normalizar: los triángulos grandes pesan más.
+        const float r = 1.0f / determinant;
+        const glm::vec3 tangent = (edge1 * uv2.y - edge2 * uv1.y) * r;
+        const glm::vec3 bitangent = (edge2 * uv1.x - edge1 * uv2.x) * r;
+        for (uint32_t v : { a, b, c })
+        {
+            tangents[v] += tangent;
+            bitangents[v] += bitangent;
+        }
+    }
+
+    for (size_t v = 0; v < mesh.vertices.size(); ++v)
+    {
+        Vertex& vertex = mesh.vertices[v];
+        // Con una normal nula (malla degenerada o importada) no hay plano que respetar: se
+        // usa +Z solo para elegir la tangente, que así nunca sale NaN.
+        const float normalLength2 = glm::dot(vertex.normal, vertex.normal);
+        const glm::vec3 n = normalLength2 > 1e-20f ? vertex.normal / std::sqrt(normalLength2) : glm::vec3(0, 0, 1);
+        glm::vec3 t = tangents[v] - n * glm::dot(n, tangents[v]);
+        // También cuando la tangente acumulada es paralela a la normal (o NaN).
+        if (!(glm::dot(t, t) >= 1e-20f))
+        {
+            // Perpendicular arbitraria: el eje menos alineado con la normal.
+            const glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+            t = glm::cross(axis, n);
+        }
+        t = glm::normalize(t);
+        const float handedness = glm::dot(glm::cross(n, t), bitangents[v]) < 0.0f ? -1.0f : 1.0f;
+        vertex.tangent = glm::vec4(t, handedness);
+    }
+}
+
+std::vector<uint32_t> MeshBuilder::simplifyClustered(const MeshData& mesh, int gridSize)
+{
+    std::vector<uint32_t> result;
+    if (mesh.vertices.empty() || gridSize < 1)
+        return result;
+
+    glm::vec3 boundsMin = mesh.vertices[0].position;
+    glm::vec3 boundsMax = boundsMin;
+    for (const Vertex& vertex : mesh.vertices)
+    {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+    }
+    const float cellSize = std::max(glm::max(boundsMax.x - boundsMin.x, std::max(boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z)) / gridSize, 1e-20f);
+
+    // Celda de cada vértice (20 bits por eje) más el octante de su normal, para no
+    // fundir las dos caras de una pared fina. Ordenando por celda, el primer vértice de
+    // cada una la representa.
+    std::vector<std::pair<uint64_t, uint32_t>> cells(mesh.vertices.size());
+    for (size_t v = 0; v < mesh.vertices.size(); ++v)
+    {
+        const Vertex& vertex = mesh.vertices[v];
+        const glm::uvec3 cell = glm::uvec3(glm::min((vertex.position - boundsMin) / cellSize, glm::vec3((float)0xFFFFF)));
+        const uint64_t octant = (vertex.normal.x < 0.0f ? 1 : 0) | (vertex.normal.y < 0.0f ? 2 : 0) | (vertex.normal.z < 0.0f ? 4 : 0);
+        cells[v] = { ((uint64_t)cell.x << 43) | ((uint64_t)cell.y << 23) | ((uint64_t)cell.z << 3) | octant, (uint32_t)v };
+    }
+    std::sort(cells.begin(), cells.end());
+    std::vector<uint32_t> representative(mesh.vertices.size());
+    for (size_t i = 0; i < cells.size(); ++i)
+        representative[cells[i].second] = i > 0 && cells[i].first == cells[i - 1].first ? representative[cells[i - 1].second] : cells[i].second;
+
+    // Los triángulos que caen en menos de tres celdas desaparecen.
+    result.reserve(mesh.indices.size());
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        const uint32_t a = representative[mesh.indices[i]];
+        const uint32_t b = representative[mesh.indices[i + 1]];
+        const uint32_t c = representative[mesh.indices[i + 2]];
+        if (a != b && b != c && a != c)
+            result.insert(result.end(), { a, b, c });
+    }
+    return result;
+}
+
+MeshData MeshBuilder::build(const std::vector<Vertex>& triangles)
+{
+    MeshData mesh = weld(triangles);
+    optimizeVertexCache(mesh);
+    optimizeVertexFetch(mesh);
+    return mesh;
+}
+
+VertexCacheStats MeshBuilder::analyze(const std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize)
+{
+    VertexCacheStats stats = { 0.0f, 0.0f };
+    if (indices.empty() || vertexCount == 0)
+        return stats;
+
+    // Caché FIFO como la de las GPU clásicas.
+    std::vector<uint32_t> fifo(cacheSize, 0xFFFFFFFFu);
+    size_t head = 0;
+    size_t transformed = 0;
+    for (uint32_t index : indices)
+    {
+        if (std::find(fifo.begin(), fifo.end(), index) != fifo.end())
+            continue;
+        fifo[head] = index;
+        head = (head + 1) % cacheSize;
+        transformed++;
+    }
+
+    stats.acmr = (float)transformed / (float)(indices.size() / 3);
+    stats.atvr = (float)transformed / (float)vertexCount;
+    return stats;
+}
+
+std::vector<Vertex> MeshBuilder::cubeTriangles()
+{
+    // Cada cara: normal y tangente; la bitangente es cross(normal, tangente) (signo +1)
+    // y la coordenada v crece en su dirección.
+    const glm::vec3 faces[6][2] = {
+        { glm::vec3( 0,  0,  1), glm::vec3( 1, 0,  0) },
+        { glm::vec3( 0,  0, -1), glm::vec3(-1, 0,  0) },
+        { glm::vec3(-1,  0,  0), glm::vec3( 0, 0,  1) },
+        { glm::vec3( 1,  0,  0), glm::vec3( 0, 0, -1) },
+        { glm::vec3( 0, -1,  0), glm::vec3( 1, 0,  0) },
+        { glm::vec3( 0,  1,  0), glm::vec3( 1, 0,  0) },
+    };
+
+    std::vector<Vertex> triangles;
+    triangles.reserve(36);
+    for (const auto& face : faces)
+    {
+        const glm::vec3 normal = face[0];
+        const glm::vec3 tangent = face[1];
+        const glm::vec3 bitangent = glm::cross(normal, tangent);
+        auto corner = [&](float u, float v) {
+            Vertex vertex;
+            vertex.position = normal * 0.5f + tangent * (u - 0.5f) + bitangent * (v - 0.5f);
+            vertex.normal = normal;
+            vertex.texCoords = glm::vec2(u, v);
+            vertex.tangent = glm::vec4(tangent, 1.0f);
+            return vertex;
+        };
+        addQuad(triangles, corner(0, 0), corner(1, 0), corner(1, 1), corner(0, 1));
+    }
+    return triangles;
+}
+
+std::vector<Vertex> MeshBuilder::sphereTriangles(int segments, int rings)
+{
+    segments = std::max(segments, 3);
+    rings = std::max(rings, 2);
+
+    auto point = [&](int i, int j) {
+        const float u = (float)i / (float)segments;
+        const float v = (float)j / (float)rings;
+        const float phi = u * 2.0f * PI;
+        const float theta = v * PI;
+        Vertex vertex;
+        vertex.normal = glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+        vertex.position = vertex.normal * 0.5f;
+        vertex.texCoords = glm::vec2(u, v);
+        vertex.tangent = glm::vec4(-std::sin(phi), 0.0f, std::cos(phi), 1.0f);
+        return vertex;
+    };
+
+    std::vector<Vertex> triangles;
+    triangles.reserve((size_t)segments * rings * 6);
+    for (int j = 0; j < rings; ++j)
+    {
+        for (int i = 0; i < segments; ++i)
+        {
+            const Vertex v00 = point(i, j), v10 = point(i + 1, j);
+            const Vertex v01 = point(i, j + 1), v11 = point(i + 1, j + 1);
+            // En los polos uno de los dos triángulos del cuadrilátero es degenerado.
+            if (j != 0)
+                triangles.insert(triangles.end(), { v00, v10, v11 });
+            if (j != rings - 1)
+                triangles.insert(triangles.end(), { v00, v11, v01 });
+        }
+    }
+    return triangles;
+}
+
+std::vector<Vertex> MeshBuilder::cylinderTriangles(int segments)
+{
+    segments = std::max(segments, 3);
+    std::vector<Vertex> triangles;
+    triangles.reserve((size_t)segments * 12);
+
+    // Lateral: u alrededor, v de arriba (y = 0.5) a abajo (y = -0.5).
+    auto side = [&](int i, int j) {
+        const float u = (float)i / (float)segments;
+        const float phi = u * 2.0f * PI;
+        Vertex vertex;
+        vertex.normal = glm::vec3(std::cos(phi), 0.0f, std::sin(phi));
+        vertex.position = glm::vec3(vertex.normal.x * 0.5f, j == 0 ? 0.5f : -0.5f, vertex.normal.z * 0.5f);
+        vertex.texCoords = glm::vec2(u, (float)j);
+        vertex.tangent = glm::vec4(-std::sin(phi), 0.0f, std::cos(phi), 1.0f);
+        return vertex;
+    };
+    // Tapas con proyección planar; v crece en la dirección de cross(normal, tangente).
+    auto cap = [&](float x, float z, bool top) {
+        Vertex vertex;
+        vertex.position = glm::vec3(x, top ? 0.5f : -0.5f, z);
+        vertex.normal = glm::vec3(0.0f, top ? 1.0f : -1.0f, 0.0f);
+        vertex.texCoords = glm::vec2(x + 0.5f, top ? 0.5f - z : z + 0.5f);
+        vertex.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+        return vertex;
+    };
+
+    for (int i = 0; i < segments; ++i)
+    {
+        addQuad(triangles, side(i, 0), side(i + 1, 0), side(i + 1, 1), side(i, 1));
+
+        const float phi0 = (float)i / (float)segments * 2.0f * PI;
+        const float phi1 = (float)(i + 1) / (float)segments * 2.0f * PI;
+        const float x0 = 0.5f * std::cos(phi0), z0 = 0.5f * std::sin(phi0);
+        const float x1 = 0.5f * std::cos(phi1), z1 = 0.5f * std::sin(phi1);
+        triangles.insert(triangles.end(), { cap(0.0f, 0.0f, true), cap(x1, z1, true), cap(x0, z0, true) });
+        triangles.insert(triangles.end(), { cap(0.0f, 0.0f, false), cap(x0, z0, false), cap(x1, z1, false) });
+    }
+    return triangles;
+}
+
+std::vector<Vertex> MeshBuilder::planeTriangles(int subdivisions)
+{
+    subdivisions = std::max(subdivisions, 1);
+    auto point = [&](int i, int j) {
+        const float u = (float)i / (float)subdivisions;
+        const float v = (float)j / (float)subdivisions;
+        Vertex vertex;
+        vertex.position = glm::vec3(u - 0.5f, 0.0f, 0.5f - v);
+        vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+        vertex.texCoords = glm::vec2(u, v);
+        vertex.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+        return vertex;
+    };
+
+    std::vector<Vertex> triangles;
+    triangles.reserve((size_t)subdivisions * subdivisions * 6);
+    for (int j = 0; j < subdivisions; ++j)
+    {
+        for (int i = 0; i < subdivisions; ++i)
+            addQuad(triangles, point(i, j), point(i + 1, j), point(i + 1, j + 1), point(i, j + 1));
+    }
+    return triangles;
+}
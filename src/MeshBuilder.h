@@ -0,0 +1,79 @@
+#ifndef MESH_BUILDER_H
+#define MESH_BUILDER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Vértice completo del motor: posición, normal, coordenadas de textura y tangente
+// (12 floats). tangent.w es la orientación de la base: bitangente = cross(N, T) * w.
+// Es el formato de trabajo en CPU; en la GPU se sube comprimido (ver Mesh.h).
+struct Vertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoords;
+    glm::vec4 tangent;
+};
+
+// Malla indexada en memoria de CPU, antes de subirse a la GPU.
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// Estadísticas de caché post-transformación (simulación FIFO).
+struct VertexCacheStats {
+    float acmr;     // vértices transformados por triángulo (ideal ~0.5-0.7, peor 3)
+    float atvr;     // vértices transformados por vértice único (ideal 1)
+};
+
+// Construcción de mallas indexadas: suelda vértices duplicados, reordena triángulos para
+// aprovechar la caché de vértices transformados (algoritmo de Forsyth) y reordena los
+// vértices por primer uso para que la lectura sea lo más lineal posible. Las formas
+// paramétricas se generan como sopa de triángulos y pasan por el mismo camino.
+class MeshBuilder
+{
+public:
+    // Tamaño de caché usado por la optimización y por las estadísticas.
+    static const int CACHE_SIZE = 32;
+
+    // Suelda vértices idénticos bit a bit de una lista de triángulos no indexada.
+    static MeshData weld(const std::vector<Vertex>& triangles);
+
+    // Reordena los triángulos (índices) para reutilizar la caché post-transformación.
+    static void optimizeVertexCache(MeshData& mesh);
+    static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+    // Reordena los vértices por orden de primer uso y reescribe los índices.
+    static void optimizeVertexFetch(MeshData& mesh);
+
+    // Tangentes por vértice a partir de las UV: se acumulan por triángulo, se
+    // ortogonalizan contra la normal y tangent.w guarda la orientación. Sin UV útiles
+    // se elige una perpendicular cualquiera a la normal.
+    static void computeTangents(MeshData& mesh);
+
+    // Simplificación por agrupamiento de vértices para LODs: divide la caja de la malla
+    // en gridSize celdas en el eje más largo, funde los vértices de cada celda en uno
+    // de ellos y descarta los triángulos degenerados. Devuelve los índices nuevos, que
+    // apuntan a los mismos vértices (los LODs comparten el buffer de vértices).
+    static std::vector<uint32_t> simplifyClustered(const MeshData& mesh, int gridSize);
+
+    // weld + optimizeVertexCache + optimizeVertexFetch.
+    static MeshData build(const std::vector<Vertex>& triangles);
+
+    static VertexCacheStats analyze(const std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize = CACHE_SIZE);
+
+    // Formas paramétricas centradas en el origen, de tamaño unidad.
+    static std::vector<Vertex> cubeTriangles();
+    static std::vector<Vertex> sphereTriangles(int segments = 32, int rings = 16);
+    static std::vector<Vertex> cylinderTriangles(int segments = 32);
+    static std::vector<Vertex> planeTriangles(int subdivisions = 1);
+
+    static MeshData cube() { return build(cubeTriangles()); }
+    static MeshData sphere(int segments = 32, int rings = 16) { return build(sphereTriangles(segments, rings)); }
+    static MeshData cylinder(int segments = 32) { return build(cylinderTriangles(segments)); }
+    static MeshData plane(int subdivisions = 1) { return build(planeTriangles(subdivisions)); }
+};
+
+#endif // MESH_BUILDER_H
@@ -0,0 +1,380 @@
+#include "MipGenerator.h"
+#include "CpuFeatures.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Píxel de trabajo: siempre 4 floats (los canales que faltan valen 0 y el alfa 1).
+    struct Pixel {
+        float v[4];
+    };
+
+    struct Tables {
+        float unormToFloat[256];
+        float srgbToLinear[256];
+        unsigned char linearToSrgb[4096];
+
+        Tables()
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                const float c = i / 255.0f;
+                unormToFloat[i] = c;
+                srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < 4096; ++i)
+            {
+                const float l = i / 4095.0f;
+                const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                linearToSrgb[i] = (unsigned char)std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f);
+            }
+        }
+    };
+
+    const Tables& tables()
+    {
+        static const Tables instance;
+        return instance;
+    }
+
+    const bool useAVX = cpuHasAVX();
+
+    // Los kernels suman los pares horizontales de dos filas:
+    // dst[x] = (a[2x] + a[2x+1] + b[2x] + b[2x+1]) / 4 para x en [0, count). Las columnas
+    // impares del borde las trata quien llama.
+#ifndef CHAOS_X86
+    void downsamplePairsScalar(const Pixel* a, const Pixel* b, Pixel* dst, int count)
+    {
+        for (int x = 0; x < count; ++x)
+        {
+            for (int c = 0; c < 4; ++c)
+                dst[x].v[c] = (a[2 * x].v[c] + a[2 * x + 1].v[c] + b[2 * x].v[c] + b[2 * x + 1].v[c]) * 0.25f;
+        }
+    }
+#else
+    // Un píxel es un __m128: el promedio son tres sumas y un producto.
+    void downsamplePairsSSE(const Pixel* a, const Pixel* b, Pixel* dst, int count)
+    {
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        for (int x = 0; x < count; ++x)
+        {
+            const __m128 top = _mm_add_ps(_mm_loadu_ps(a[2 * x].v), _mm_loadu_ps(a[2 * x + 1].v));
+            const __m128 bottom = _mm_add_ps(_mm_loadu_ps(b[2 * x].v), _mm_loadu_ps(b[2 * x + 1].v));
+            _mm_storeu_ps(dst[x].v, _mm_mul_ps(_mm_add_ps(top, bottom), quarter));
+        }
+    }
+
+    // Dos píxeles de destino por iteración: se cargan 4 de cada fila y se reordenan las
+    // mitades de 128 bits para sumar los pares.
+    CHAOS_TARGET_AVX void downsamplePairsAVX(const Pixel* a, const Pixel* b, Pixel* dst, int count)
+    {
+        const __m256 quarter = _mm256_set1_ps(0.25f);
+        int x = 0;
+        for (; x + 2 <= count; x += 2)
+        {
+            const __m256 sum01 = _mm256_add_ps(_mm256_loadu_ps(a[2 * x].v), _mm256_loadu_ps(b[2 * x].v));
+            const __m256 sum23 = _mm256_add_ps(_mm256_loadu_ps(a[2 * x + 2].v), _mm256_loadu_ps(b[2 * x + 2].v));
+            const __m256 even = _mm256_permute2f128_ps(sum01, sum23, 0x20);
+            const __m256 odd = _mm256_permute2f128_ps(sum01, sum23, 0x31);
+            _mm256_storeu_ps(dst[x].v, _mm256_mul_ps(_mm256_add_ps(even, odd), quarter));
+        }
+        downsamplePairsSSE(a + 2 * x, b + 2 * x, dst + x, count - x);
+    }
+#endif
+
+    void downsamplePairs(const Pixel* a, const Pixel* b, Pixel* dst, int count)
+    {
+#ifdef CHAOS_X86
+        if (useAVX)
+            downsamplePairsAVX(a, b, dst, count);
+        else
+            downsamplePairsSSE(a, b, dst, count);
+#else
+        downsamplePairsScalar(a, b, dst, count);
+#endif
+    }
+
+    // Nivel en flotante lineal.
+    struct FloatLevel {
+        int width = 0;
+        int height = 0;
+        std::vector<Pixel> pixels;
+    };
+
+    // Convierte una fila de bytes a píxeles de trabajo. Cada canal usa su tabla (sRGB o
+    // lineal), así el bucle interno no tiene saltos.
+    void decodeRow(const unsigned char* src, int width, int channels, bool srgb, Pixel* dst)
+    {
+        const Tables& t = tables();
+        const float* lut[4];
+        for (int c = 0; c < 4; ++c)
+            lut[c] = srgb && c < 3 ? t.srgbToLinear : t.unormToFloat;
+
+        switch (channels)
+        {
+        case 4:
+            for (int x = 0; x < width; ++x, src += 4)
+                dst[x] = { { lut[0][src[0]], lut[1][src[1]], lut[2][src[2]], lut[3][src[3]] } };
+            break;
+        case 3:
+            for (int x = 0; x < width; ++x, src += 3)
+                dst[x] = { { lut[0][src[0]], lut[1][src[1]], lut[2][src[2]], 1.0f } };
+            break;
+        case 2:
+            for (int x = 0; x < width; ++x, src += 2)
+                dst[x] = { { lut[0][src[0]], lut[1][src[1]], 0.0f, 1.0f } };
+            break;
+        default:
+            for (int x = 0; x < width; ++x, src += 1)
+                dst[x] = { { lut[0][src[0]], 0.0f, 0.0f, 1.0f } };
+            break;
+        }
+    }
+
+    template <typename RowSource>
+    void downsampleRows(int srcWidth, int srcHeight, FloatLevel& dst, RowSource rowSource)
+    {
+        dst.width = std::max(1, srcWidth / 2);
+        dst.height = std::max(1, srcHeight / 2);
+        dst.pixels.resize((size_t)dst.width * dst.height);
+
+        const size_t grain = std::max<size_t>(1, 16384 / (size_t)dst.width);
+        JobSystem::parallelFor((size_t)dst.height, grain, [&](size_t begin, size_t end) {
+            std::vector<Pixel> scratchA((size_t)std::max(srcWidth, 2)), scratchB((size_t)std::max(srcWidth, 2)), scratchC((size_t)srcWidth);
+            for (size_t y = begin; y < end; ++y)
+            {
+                const int y0 = std::min((int)y * 2, srcHeight - 1);
+                const int y1 = std::min((int)y * 2 + 1, srcHeight - 1);
+                const Pixel* a = rowSource(y0, scratchA.data());
+                const Pixel* b = rowSource(y1, scratchB.data());
+                Pixel* out = dst.pixels.data() + y * dst.width;
+
+                if (srcWidth >= 2)
+                {
+                    downsamplePairs(a, b, out, srcWidth / 2);
+                }
+                else
+                {
+                    // Columna única: se duplica para reutilizar el kernel.
+                    scratchA[0] = scratchA[1] = a[0];
+                    scratchB[0] = scratchB[1] = b[0];
+                    downsamplePairs(scratchA.data(), scratchB.data(), out, 1);
+                }
+
+                // Con altura impar la última fila de salida absorbe la tercera fila y, con
+                // anchura impar, la última columna absorbe la tercera columna (caja de 3
+                // texels en ese eje), así el borde no se pierde ni desplaza el contenido.
+                const Pixel* c = nullptr;
+                if ((srcHeight & 1) && srcHeight > 1 && (int)y == dst.height - 1)
+                {
+                    c = rowSource(srcHeight - 1, scratchC.data());
+                    for (int x = 0; x < dst.width; ++x)
+                    {
+                        const int x0 = std::min(2 * x, srcWidth - 1);
+                        const int x1 = std::min(2 * x + 1, srcWidth - 1);
+                        for (int channel = 0; channel < 4; ++channel)
+                            out[x].v[channel] = (out[x].v[channel] * 4.0f + c[x0].v[channel] + c[x1].v[channel]) * (1.0f / 6.0f);
+                    }
+                }
+                if ((srcWidth & 1) && srcWidth > 1)
+                {
+                    const int edge = srcWidth - 1;
+                    const float rows = c ? 3.0f : 2.0f;
+                    Pixel& last = out[dst.width - 1];
+                    for (int channel = 0; channel < 4; ++channel)
+                    {
+                        const float column = a[edge].v[channel] + b[edge].v[channel] + (c ? c[edge].v[channel] : 0.0f);
+                        last.v[channel] = (last.v[channel] * 2.0f * rows + column) / (3.0f * rows);
+                    }
+                }
+            }
+        });
+    }
+
+    // Reduce 'src' a la mitad (redondeando hacia abajo). Con anchura o altura impar la
+    // última columna o fila se promedia en el último texel; una dimensión de 1 se duplica
+    // en lugar de reducirse.
+    void downsample(const FloatLevel& src, FloatLevel& dst)
+    {
+        downsampleRows(src.width, src.height, dst, [&](int y, Pixel*) {
+            return src.pixels.data() + (size_t)y * src.width;
+        });
+    }
+
+    // Primer nivel directamente desde los bytes de origen: cada fila se convierte a
+    // flotante en un buffer del hilo y el nivel 0 en flotante nunca llega a existir
+    // (a 2048x2048 serían 64 MB de tráfico de memoria solo para leerlo una vez).
+    void downsampleSource(const unsigned char* pixels, int width, int height, int channels, bool srgb, FloatLevel& dst)
+    {
+        downsampleRows(width, height, dst, [&](int y, Pixel* scratch) {
+            decodeRow(pixels + (size_t)y * width * channels, width, channels, srgb, scratch);
+            return (const Pixel*)scratch;
+        });
+    }
+
+    void renormalize(FloatLevel& level)
+    {
+        JobSystem::parallelFor(level.pixels.size(), 65536, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                float* v = level.pixels[i].v;
+                const float x = v[0] * 2.0f - 1.0f, y = v[1] * 2.0f - 1.0f, z = v[2] * 2.0f - 1.0f;
+                const float length = std::sqrt(x * x + y * y + z * z);
+                if (length > 1e-6f)
+                {
+                    v[0] = x / length * 0.5f + 0.5f;
+                    v[1] = y / length * 0.5f + 0.5f;
+                    v[2] = z / length * 0.5f + 0.5f;
+                }
+            }
+        });
+    }
+
+    float alphaCoverage(const FloatLevel& level, float cutoff, float scale)
+    {
+        size_t covered = 0;
+        for (const Pixel& pixel : level.pixels)
+        {
+            if (pixel.v[3] * scale >= cutoff)
+                covered++;
+        }
+        return (float)covered / (float)level.pixels.size();
+    }
+
+    // Escala de alfa que deja la cobertura del nivel lo más cerca posible de 'target'.
+    float coverageScale(const FloatLevel& level, float cutoff, float target)
+    {
+        float low = 0.0f, high = 4.0f, best = 1.0f, bestError = 2.0f;
+        for (int iteration = 0; iteration < 12; ++iteration)
+        {
+            const float scale = (low + high) * 0.5f;
+            const float coverage = alphaCoverage(level, cutoff, scale);
+            const float error = std::abs(coverage - target);
+            if (error < bestError)
+            {
+                bestError = error;
+                best = scale;
+            }
+            if (coverage < target)
+                low = scale;
+            else
+                high = scale;
+        }
+        return best;
+    }
+
+    void encodeLevel(const FloatLevel& level, int channels, bool srgb, float alphaScale, unsigned char* dst)
+    {
+        const Tables& t = tables();
+        const int colorChannels = std::min(channels, 3);
+        JobSystem::parallelFor(level.pixels.size(), 65536, [&](size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef CHAOS_X86
+            // RGBA lineal: escala, satura y empaqueta los cuatro canales de una vez.
+            if (channels == 4 && !srgb)
+            {
+                const __m128 scale = _mm_setr_ps(255.0f, 255.0f, 255.0f, 255.0f * alphaScale);
+                const __m128 zero = _mm_setzero_ps(), max = _mm_set1_ps(255.0f), half = _mm_set1_ps(0.5f);
+                for (; i < end; ++i)
+                {
+                    const __m128 value = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(level.pixels[i].v), scale), zero), max);
+                    const __m128i words = _mm_cvttps_epi32(_mm_add_ps(value, half));
+                    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(words, words), words);
+                    const int texel = _mm_cvtsi128_si32(packed);
+                    std::memcpy(dst + i * 4, &texel, 4);
+                }
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                const float* v = level.pixels[i].v;
+                unsigned char* texel = dst + i * channels;
+                for (int c = 0; c < colorChannels; ++c)
+                {
+                    const float value = std::clamp(v[c], 0.0f, 1.0f);
+                    texel[c] = srgb ? t.linearToSrgb[(int)(value * 4095.0f + 0.5f)] : (unsigned char)(value * 255.0f + 0.5f);
+                }
+                if (channels == 4)
+                    texel[3] = (unsigned char)(std::clamp(v[3] * alphaScale, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        });
+    }
+}
+
+int MipGenerator::levelCount(int width, int height)
+{
+    int levels = 1;
+    while (width > 1 || height > 1)
+    {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        levels++;
+    }
+    return levels;
+}
+
+const char* MipGenerator::kernelName()
+{
+#ifdef CHAOS_X86
+    return useAVX ? "AVX" : "SSE";
+#else
+    return "scalar";
+#endif
+}
+
+MipChain MipGenerator::build(const unsigned char* pixels, int width, int height, int channels, const MipOptions& options)
+{
+    MipChain chain;
+    chain.width = width;
+    chain.height = height;
+    chain.channels = channels;
+
+    const int levels = levelCount(width, height);
+    size_t total = 0;
+    for (int level = 0; level < levels; ++level)
+    {
+        chain.levelOffsets.push_back(total);
+        total += chain.levelBytes(level);
+    }
+    chain.pixels.resize(total);
+    std::memcpy(chain.pixels.data(), pixels, chain.levelBytes(0));
+    if (levels == 1)
+        return chain;
+
+    const bool srgb = options.srgb && channels >= 3;
+    const bool normals = options.normalMap && channels >= 3;
+    const bool coverage = options.alphaCoverageCutoff > 0.0f && channels == 4;
+
+    // La cobertura objetivo se mide sobre los bytes del nivel 0.
+    float targetCoverage = 0.0f;
+    if (coverage)
+    {
+        const size_t count = (size_t)width * height;
+        size_t covered = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (pixels[i * 4 + 3] / 255.0f >= options.alphaCoverageCutoff)
+                covered++;
+        }
+        targetCoverage = (float)covered / (float)count;
+    }
+
+    FloatLevel current, next;
+    for (int level = 1; level < levels; ++level)
+    {
+        if (level == 1)
+            downsampleSource(pixels, width, height, channels, srgb, next);
+        else
+            downsample(current, next);
+        if (normals)
+            renormalize(next);
+        const float alphaScale = coverage ? coverageScale(next, options.alphaCoverageCutoff, targetCoverage) : 1.0f;
+        encodeLevel(next, channels, srgb, alphaScale, chain.level(level));
+        std::swap(current, next);
+    }
+    return chain;
+}
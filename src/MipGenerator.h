@@ -0,0 +1,50 @@
+#ifndef MIP_GENERATOR_H
+#define MIP_GENERATOR_H
+
+#include <cstddef>
+#include <vector>
+
+// Imagen de 8 bits por canal con toda su cadena de mips en un único bloque, del nivel 0
+// al de 1x1. Filas sin relleno entre ellas.
+struct MipChain {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<unsigned char> pixels;
+    std::vector<size_t> levelOffsets;
+
+    int levels() const { return (int)levelOffsets.size(); }
+    int levelWidth(int level) const { return width >> level > 0 ? width >> level : 1; }
+    int levelHeight(int level) const { return height >> level > 0 ? height >> level : 1; }
+    size_t levelBytes(int level) const { return (size_t)levelWidth(level) * levelHeight(level) * channels; }
+    const unsigned char* level(int level) const { return pixels.data() + levelOffsets[level]; }
+    unsigned char* level(int level) { return pixels.data() + levelOffsets[level]; }
+};
+
+// Cómo se filtran los mips de una imagen.
+struct MipOptions {
+    // Los canales de color (RGB) están en sRGB: se promedian en espacio lineal.
+    bool srgb = false;
+    // Normal map en RGB: cada texel filtrado se vuelve a normalizar.
+    bool normalMap = false;
+    // Si es > 0 y hay alfa, cada nivel escala su alfa para conservar la fracción de
+    // texels con alfa >= este umbral (cobertura de texturas con alpha test).
+    float alphaCoverageCutoff = 0.0f;
+};
+
+// Generación de mips en CPU, compartida por el cargador de texturas y chaos-texcook.
+// Filtro de caja 2x2 en coma flotante con kernels SSE (AVX si la CPU lo tiene); las
+// filas de cada nivel se reparten entre los hilos de JobSystem. Cada nivel se calcula a
+// partir del anterior en flotante, sin pasar por 8 bits.
+class MipGenerator
+{
+public:
+    static int levelCount(int width, int height);
+
+    static MipChain build(const unsigned char* pixels, int width, int height, int channels, const MipOptions& options = MipOptions());
+
+    // Kernel en uso ("AVX", "SSE" o "scalar"), para las estadísticas de los benchmarks.
+    static const char* kernelName();
+};
+
+#endif // MIP_GENERATOR_H
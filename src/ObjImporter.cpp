@@ -0,0 +1,748 @@
+#include "ObjImporter.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+namespace
+{
+    // Tamaño aproximado de cada bloque de líneas que se analiza en un hilo.
+    const size_t CHUNK_BYTES = 4 * 1024 * 1024;
+
+    const uint32_t NONE = 0xFFFFFFFFu;
+
+    // Esquina de una cara con índices absolutos desde 0; -1 si falta el vt o el vn.
+    struct Corner {
+        int32_t v;
+        int32_t t;
+        int32_t n;
+    };
+
+    // Caras consecutivas de un bloque con el mismo estado. La primera tanda de cada
+    // bloque hereda el objeto y el material del final del bloque anterior.
+    struct FaceRun {
+        bool setsObject = false;
+        bool setsMaterial = false;
+        std::string object;
+        std::string material;
+        std::vector<Corner> corners;    // 3 por triángulo
+    };
+
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        // Primer recorrido: cuántos v/vt/vn y líneas hay en el bloque.
+        size_t positions = 0;
+        size_t texCoords = 0;
+        size_t normals = 0;
+        size_t lines = 0;
+        // Con las sumas de los bloques anteriores: dónde empiezan los de este.
+        size_t firstPosition = 0;
+        size_t firstTexCoord = 0;
+        size_t firstNormal = 0;
+        size_t firstLine = 0;
+        // Segundo recorrido.
+        std::vector<FaceRun> runs;
+        std::vector<std::string> materialLibraries;
+        bool missingNormals = false;
+        std::string error;
+    };
+
+    // Geometría compartida por todas las mallas, tal como aparece en el archivo.
+    struct Attributes {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+    };
+
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline const char* skipSpaces(const char* p, const char* end)
+    {
+        while (p < end && isSpace(*p))
+            p++;
+        return p;
+    }
+
+    inline const char* lineEnd(const char* p, const char* end)
+    {
+        const char* newline = (const char*)std::memchr(p, '\n', end - p);
+        return newline ? newline : end;
+    }
+
+    // Potencias de 10 exactas en double (hasta 1e22 lo son).
+    const double POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    // Casos raros (nan, inf, mantisas muy largas): strtod sobre una copia terminada en nulo.
+    bool parseFloatSlow(const char*& p, const char* end, float& value)
+    {
+        char buffer[64];
+        size_t length = 0;
+        while (p + length < end && !isSpace(p[length]) && p[length] != '\n' && length < sizeof(buffer) - 1)
+        {
+            buffer[length] = p[length];
+            length++;
+        }
+        buffer[length] = '\0';
+        char* parsedEnd = nullptr;
+        value = std::strtof(buffer, &parsedEnd);
+        if (parsedEnd == buffer)
+            return false;
+        p += parsedEnd - buffer;
+        return true;
+    }
+
+    // Número decimal: mantisa entera y exponente en base 10. Con mantisas de hasta 15
+    // dígitos y exponentes pequeños el resultado en double es exacto (vía rápida de
+    // Clinger); el resto, que en un OBJ casi no aparece, pasa por strtod.
+    bool parseFloat(const char*& p, const char* end, float& value)
+    {
+        const char* start = p;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negative = *p++ == '-';
+
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        const char* digitsStart = p;
+        while (p < end && (unsigned)(*p - '0') < 10)
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0)
+                    digits++;
+            }
+            else
+            {
+                exponent++;
+            }
+            p++;
+        }
+        if (p < end && *p == '.')
+        {
+            p++;
+            while (p < end && (unsigned)(*p - '0') < 10)
+            {
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    if (mantissa != 0)
+                        digits++;
+                    exponent--;
+                }
+                p++;
+            }
+        }
+        if (p == digitsStart || (p == digitsStart + 1 && *digitsStart == '.'))
+        {
+            // "nan", "inf" o basura: lo decide strtod.
+            p = start;
+            return parseFloatSlow(p, end, value);
+        }
+        if (p < end && (*p == 'e' || *p == 'E'))
+        {
+            const char* exponentStart = p++;
+            bool exponentNegative = false;
+            if (p < end && (*p == '-' || *p == '+'))
+                exponentNegative = *p++ == '-';
+            if (p == end || (unsigned)(*p - '0') >= 10)
+            {
+                p = exponentStart;
+            }
+            else
+            {
+                int e = 0;
+                while (p < end && (unsigned)(*p - '0') < 10)
+                {
+                    if (e < 10000)
+                        e = e * 10 + (*p - '0');
+                    p++;
+                }
+                exponent += exponentNegative ? -e : e;
+            }
+        }
+
+        if (digits <= 15 && exponent >= -22 && exponent <= 22)
+        {
+            double result = (double)mantissa;
+            result = exponent < 0 ? result / POWERS_OF_TEN[-exponent] : result * POWERS_OF_TEN[exponent];
+            value = (float)(negative ? -result : result);
+            return true;
+        }
+        p = start;
+        return parseFloatSlow(p, end, value);
+    }
+
+    bool parseInt(const char*& p, const char* end, int64_t& value)
+    {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negative = *p++ == '-';
+        const char* digitsStart = p;
+        int64_t result = 0;
+        while (p < end && (unsigned)(*p - '0') < 10)
+        {
+            if (result < ((int64_t)1 << 40))
+                result = result * 10 + (*p - '0');
+            p++;
+        }
+        value = negative ? -result : result;
+        return p != digitsStart;
+    }
+
+    // Resto de la línea sin espacios a los lados.
+    std::string restOfLine(const char* p, const char* end)
+    {
+        p = skipSpaces(p, end);
+        while (end > p && isSpace(end[-1]))
+            end--;
+        return std::string(p, end);
+    }
+
+    // Directiva al principio de la línea (ya sin espacios iniciales).
+    inline bool keyword(const char* p, const char* end, const char* word, size_t length)
+    {
+        return (size_t)(end - p) > length && std::memcmp(p, word, length) == 0 && isSpace(p[length]);
+    }
+
+    void countChunk(Chunk& chunk)
+    {
+        for (const char* line = chunk.begin; line < chunk.end;)
+        {
+            const char* next = lineEnd(line, chunk.end);
+            const char* p = skipSpaces(line, next);
+            if (next - p >= 2 && p[0] == 'v')
+            {
+                if (isSpace(p[1]))
+                    chunk.positions++;
+                else if (p[1] == 't' && next - p >= 3 && isSpace(p[2]))
+                    chunk.texCoords++;
+                else if (p[1] == 'n' && next - p >= 3 && isSpace(p[2]))
+                    chunk.normals++;
+            }
+            chunk.lines++;
+            line = next + 1;
+        }
+    }
+
+    // Índice OBJ (desde 1, o negativo relativo a lo leído hasta ahora) a índice desde 0.
+    bool resolveIndex(int64_t index, size_t readSoFar, size_t total, int32_t& resolved)
+    {
+        const int64_t absolute = index > 0 ? index - 1 : (int64_t)readSoFar + index;
+        if (index == 0 || absolute < 0 || absolute >= (int64_t)total)
+            return false;
+        resolved = (int32_t)absolute;
+        return true;
+    }
+
+    bool parseChunk(Chunk& chunk, Attributes& attributes)
+    {
+        size_t positions = chunk.firstPosition;
+        size_t texCoords = chunk.firstTexCoord;
+        size_t normals = chunk.firstNormal;
+        size_t lineNumber = chunk.firstLine;
+        std::vector<Corner> polygon;
+
+        auto fail = [&](const char* message) {
+            chunk.error = "line " + std::to_string(lineNumber + 1) + ": " + message;
+            return false;
+        };
+        auto currentRun = [&]() -> FaceRun& {
+            if (chunk.runs.empty())
+                chunk.runs.emplace_back();
+            return chunk.runs.back();
+        };
+
+        for (const char* line = chunk.begin; line < chunk.end; line = lineEnd(line, chunk.end) + 1, ++lineNumber)
+        {
+            const char* end = lineEnd(line, chunk.end);
+            const char* p = skipSpaces(line, end);
+            if (p == end || *p == '#')
+                continue;
+
+            if (p[0] == 'v' && end - p >= 2 && isSpace(p[1]))
+            {
+                glm::vec3& position = attributes.positions[positions++];
+                p += 2;
+                for (int c = 0; c < 3; ++c)
+                {
+                    p = skipSpaces(p, end);
+                    if (!parseFloat(p, end, position[c]))
+                        return fail("invalid vertex position");
+                }
+            }
+            else if (keyword(p, end, "vt", 2))
+            {
+                // v crece hacia arriba en OBJ; las imágenes se cargan con la primera fila arriba.
+                glm::vec2& texCoord = attributes.texCoords[texCoords++];
+                p += 3;
+                texCoord = glm::vec2(0.0f);
+                for (int c = 0; c < 2; ++c)
+                {
+                    p = skipSpaces(p, end);
+                    if (p == end)
+                        break;
+                    if (!parseFloat(p, end, texCoord[c]))
+                        return fail("invalid texture coordinate");
+                }
+                texCoord.y = 1.0f - texCoord.y;
+            }
+            else if (keyword(p, end, "vn", 2))
+            {
+                glm::vec3& normal = attributes.normals[normals++];
+                p += 3;
+                for (int c = 0; c < 3; ++c)
+                {
+                    p = skipSpaces(p, end);
+                    if (!parseFloat(p, end, normal[c]))
+                        return fail("invalid normal");
+                }
+            }
+            else if (keyword(p, end, "f", 1))
+            {
+                polygon.clear();
+                p += 2;
+                for (;;)
+                {
+                    p = skipSpaces(p, end);
+                    if (p == end)
+                        break;
+                    Corner corner = { -1, -1, -1 };
+                    int64_t index;
+                    if (!parseInt(p, end, index) || !resolveIndex(index, positions, attributes.positions.size(), corner.v))
+                        return fail("invalid face vertex index");
+                    if (p < end && *p == '/')
+                    {
+                        p++;
+                        if (p < end && *p != '/' && !(parseInt(p, end, index) && resolveIndex(index, texCoords, attributes.texCoords.size(), corner.t)))
+                            return fail("invalid face texture coordinate index");
+                        if (p < end && *p == '/')
+                        {
+                            p++;
+                            if (!parseInt(p, end, index) || !resolveIndex(index, normals, attributes.normals.size(), corner.n))
+                                return fail("invalid face normal index");
+                        }
+                    }
+                    if (corner.n < 0)
+                        chunk.missingNormals = true;
+                    polygon.push_back(corner);
+                }
+                if (polygon.size() < 3)
+                    continue;
+
+                // Polígonos convexos en abanico desde la primera esquina.
+                std::vector<Corner>& corners = currentRun().corners;
+                for (size_t i = 1; i + 1 < polygon.size(); ++i)
+                    corners.insert(corners.end(), { polygon[0], polygon[i], polygon[i + 1] });
+            }
+            else if (keyword(p, end, "o", 1) || keyword(p, end, "g", 1))
+            {
+                FaceRun run;
+                run.setsObject = true;
+                run.object = restOfLine(p + 2, end);
+                chunk.runs.push_back(std::move(run));
+            }
+            else if (keyword(p, end, "usemtl", 6))
+            {
+                FaceRun run;
+                run.setsMaterial = true;
+                run.material = restOfLine(p + 7, end);
+                chunk.runs.push_back(std::move(run));
+            }
+            else if (keyword(p, end, "mtllib", 6))
+            {
+                p += 7;
+                for (;;)
+                {
+                    p = skipSpaces(p, end);
+                    if (p == end)
+                        break;
+                    const char* nameEnd = p;
+                    while (nameEnd < end && !isSpace(*nameEnd))
+                        nameEnd++;
+                    chunk.materialLibraries.emplace_back(p, nameEnd);
+                    p = nameEnd;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::string directoryOf(const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    // Mapa de un material: el nombre de archivo es el último elemento de la línea (antes
+    // van opciones como "-bm 1.0").
+    std::string mapPath(const std::string& directory, const std::string& arguments)
+    {
+        const size_t start = arguments.find_last_of(" \t");
+        std::string file = start == std::string::npos ? arguments : arguments.substr(start + 1);
+        std::replace(file.begin(), file.end(), '\\', '/');
+        return file.empty() ? file : directory + file;
+    }
+
+    // Esquinas de una malla repartidas por los bloques, sin copiarlas.
+    struct MeshSource {
+        std::string name;
+        std::string material;
+        std::vector<const std::vector<Corner>*> parts;
+        size_t corners = 0;
+    };
+
+    // Normales suavizadas por posición para las esquinas sin vn: la suma de las normales
+    // de las caras (sin normalizar, ponderadas por área) de todas las mallas.
+    std::vector<glm::vec3> positionNormals(const std::vector<MeshSource>& sources, const Attributes& attributes)
+    {
+        std::vector<glm::vec3> normals(attributes.positions.size(), glm::vec3(0.0f));
+        for (const MeshSource& source : sources)
+        {
+            for (const std::vector<Corner>* part : source.parts)
+            {
+                for (size_t i = 0; i + 2 < part->size(); i += 3)
+                {
+                    const int32_t a = (*part)[i].v, b = (*part)[i + 1].v, c = (*part)[i + 2].v;
+                    const glm::vec3 face = glm::cross(attributes.positions[b] - attributes.positions[a],
+                                                      attributes.positions[c] - attributes.positions[a]);
+                    normals[a] += face;
+                    normals[b] += face;
+                    normals[c] += face;
+                }
+            }
+        }
+        for (glm::vec3& normal : normals)
+        {
+            const float length = glm::length(normal);
+            normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+        return normals;
+    }
+
+    // Una esquina v/vt/vn por vértice. Las esquinas se agrupan por posición: cada
+    // posición apunta a su primer vértice y los vértices con la misma posición (costuras
+    // de UV o de normales) forman una lista, casi siempre de uno o dos elementos. Las
+    // posiciones de un objeto suelen ser contiguas, así que la cabeza de cada lista va
+    // en un array del rango usado y solo si el rango es disperso se usa una tabla hash.
+    void buildMesh(const MeshSource& source, const Attributes& attributes, const std::vector<glm::vec3>& smoothNormals,
+                   const ObjImportOptions& options, MeshData& mesh)
+    {
+        int32_t minPosition = INT32_MAX, maxPosition = -1;
+        for (const std::vector<Corner>* part : source.parts)
+        {
+            for (const Corner& corner : *part)
+            {
+                minPosition = std::min(minPosition, corner.v);
+                maxPosition = std::max(maxPosition, corner.v);
+            }
+        }
+        if (maxPosition < 0)
+            return;
+
+        const size_t range = (size_t)(maxPosition - minPosition) + 1;
+        const bool dense = range <= source.corners * 4 + 1024;
+        std::vector<uint32_t> denseHeads(dense ? range : 0, NONE);
+        std::unordered_map<int32_t, uint32_t> sparseHeads;
+
+        std::vector<Corner> unique;
+        std::vector<uint32_t> nextSamePosition;
+        unique.reserve(source.corners / 4);
+        nextSamePosition.reserve(source.corners / 4);
+        mesh.indices.reserve(source.corners);
+
+        for (const std::vector<Corner>* part : source.parts)
+        {
+            for (const Corner& corner : *part)
+            {
+                uint32_t* head;
+                if (dense)
+                {
+                    head = &denseHeads[corner.v - minPosition];
+                }
+                else
+                {
+                    auto inserted = sparseHeads.emplace(corner.v, NONE);
+                    head = &inserted.first->second;
+                }
+
+                uint32_t vertex = *head;
+                while (vertex != NONE && (unique[vertex].t != corner.t || unique[vertex].n != corner.n))
+                    vertex = nextSamePosition[vertex];
+                if (vertex == NONE)
+                {
+                    vertex = (uint32_t)unique.size();
+                    unique.push_back(corner);
+                    nextSamePosition.push_back(*head);
+                    *head = vertex;
+                }
+                mesh.indices.push_back(vertex);
+            }
+        }
+
+        mesh.vertices.resize(unique.size());
+        for (size_t i = 0; i < unique.size(); ++i)
+        {
+            const Corner& corner = unique[i];
+            Vertex& vertex = mesh.vertices[i];
+            vertex.position = attributes.positions[corner.v];
+            vertex.texCoords = corner.t >= 0 ? attributes.texCoords[corner.t] : glm::vec2(0.0f);
+            if (corner.n >= 0)
+            {
+                const glm::vec3 normal = attributes.normals[corner.n];
+                const float length = glm::length(normal);
+                vertex.normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+            else
+            {
+                vertex.normal = smoothNormals[corner.v];
+            }
+        }
+
+        MeshBuilder::computeTangents(mesh);
+        if (options.optimize)
+        {
+            MeshBuilder::optimizeVertexCache(mesh);
+            MeshBuilder::optimizeVertexFetch(mesh);
+        }
+    }
+}
+
+bool ObjImporter::load(const std::string& path, ObjModel& model, std::string& error, const ObjImportOptions& options)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    const char* data = (const char*)file.data();
+    const size_t size = file.size();
+    file.prefetch(0, size);
+
+    // 1. Bloques de líneas completas.
+    std::vector<Chunk> chunks;
+    for (size_t offset = 0; offset < size;)
+    {
+        size_t end = std::min(size, offset + CHUNK_BYTES);
+        if (end < size)
+        {
+            const char* newline = (const char*)std::memchr(data + end, '\n', size - end);
+            end = newline ? (size_t)(newline - data) + 1 : size;
+        }
+        Chunk chunk;
+        chunk.begin = data + offset;
+        chunk.end = data + end;
+        chunks.push_back(std::move(chunk));
+        offset = end;
+    }
+
+    // 2. Contar v/vt/vn por bloque y reservar los arrays finales.
+    JobSystem::parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            countChunk(chunks[i]);
+    });
+    Attributes attributes;
+    size_t positions = 0, texCoords = 0, normals = 0, lines = 0;
+    for (Chunk& chunk : chunks)
+    {
+        chunk.firstPosition = positions;
+        chunk.firstTexCoord = texCoords;
+        chunk.firstNormal = normals;
+        chunk.firstLine = lines;
+        positions += chunk.positions;
+        texCoords += chunk.texCoords;
+        normals += chunk.normals;
+        lines += chunk.lines;
+    }
+    if (positions > (size_t)INT32_MAX || texCoords > (size_t)INT32_MAX || normals > (size_t)INT32_MAX)
+    {
+        error = path + ": too many vertices";
+        return false;
+    }
+    attributes.positions.resize(positions);
+    attributes.texCoords.resize(texCoords);
+    attributes.normals.resize(normals);
+
+    // 3. Analizar los bloques en paralelo, cada uno escribiendo en su tramo.
+    JobSystem::parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            parseChunk(chunks[i], attributes);
+    });
+    for (const Chunk& chunk : chunks)
+    {
+        if (!chunk.error.empty())
+        {
+            error = path + ": " + chunk.error;
+            return false;
+        }
+    }
+
+    // 4. Repartir las tandas de caras por objeto y material, en orden de archivo.
+    std::vector<MeshSource> sources;
+    std::unordered_map<std::string, size_t> sourceIndex;
+    std::string object, material;
+    bool missingNormals = false;
+    std::vector<std::string> libraries;
+    for (const Chunk& chunk : chunks)
+    {
+        missingNormals = missingNormals || chunk.missingNormals;
+        libraries.insert(libraries.end(), chunk.materialLibraries.begin(), chunk.materialLibraries.end());
+        for (const FaceRun& run : chunk.runs)
+        {
+            if (run.setsObject)
+                object = run.object;
+            if (run.setsMaterial)
+                material = run.material;
+            if (run.corners.empty())
+                continue;
+
+            const std::string key = object + '\n' + material;
+            auto found = sourceIndex.emplace(key, sources.size());
+            if (found.second)
+            {
+                sources.emplace_back();
+                sources.back().name = object;
+                sources.back().material = material;
+            }
+            MeshSource& source = sources[found.first->second];
+            source.parts.push_back(&run.corners);
+            source.corners += run.corners.size();
+        }
+    }
+
+    // 5. Materiales. Un .mtl que falta no impide importar la geometría.
+    model = ObjModel();
+    const std::string directory = directoryOf(path);
+    for (const std::string& library : libraries)
+    {
+        std::string materialError;
+        if (!loadMaterials(directory + library, model.materials, materialError))
+            error = materialError;
+    }
+
+    // 6. Mallas indexadas, en paralelo por malla.
+    const std::vector<glm::vec3> smoothNormals = missingNormals ? positionNormals(sources, attributes) : std::vector<glm::vec3>();
+    model.meshes.resize(sources.size());
+    JobSystem::parallelFor(sources.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            buildMesh(sources[i], attributes, smoothNormals, options, model.meshes[i].data);
+    });
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        ObjMesh& mesh = model.meshes[i];
+        mesh.name = sources[i].name.empty() ? sources[i].material : sources[i].name;
+        for (size_t m = 0; m < model.materials.size(); ++m)
+        {
+            if (model.materials[m].name == sources[i].material)
+                mesh.material = (int)m;
+        }
+        model.triangles += mesh.data.indices.size() / 3;
+    }
+    return true;
+}
+
+bool ObjImporter::loadMaterials(const std::string& path, std::vector<ObjMaterial>& materials, std::string& error)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    const std::string directory = directoryOf(path);
+    const char* data = (const char*)file.data();
+    const char* end = data + file.size();
+
+    ObjMaterial* material = nullptr;
+    bool explicitRoughness = false;
+    auto finish = [&] {
+        // Sin Pr, la rugosidad sale del exponente de Blinn-Phong: Ns = 2 / r^2 - 2.
+        if (material && !explicitRoughness)
+            material->roughness = std::sqrt(2.0f / (std::max(material->roughness, 0.0f) + 2.0f));
+    };
+
+    for (const char* line = data; line < end; line = lineEnd(line, end) + 1)
+    {
+        const char* lineStop = lineEnd(line, end);
+        const char* p = skipSpaces(line, lineStop);
+        if (p == lineStop || *p == '#')
+            continue;
+
+        if (keyword(p, lineStop, "newmtl", 6))
+        {
+            finish();
+            materials.emplace_back();
+            material = &materials.back();
+            material->name = restOfLine(p + 7, lineStop);
+            material->roughness = 6.0f;  // guarda Ns hasta finish(); 6 equivale a rugosidad 0.5
+            explicitRoughness = false;
+            continue;
+        }
+        if (!material)
+            continue;
+
+        auto readFloats = [&](size_t skip, float* values, int count) {
+            const char* q = p + skip;
+            for (int c = 0; c < count; ++c)
+            {
+                q = skipSpaces(q, lineStop);
+                if (!parseFloat(q, lineStop, values[c]))
+                    return false;
+            }
+            return true;
+        };
+
+        if (keyword(p, lineStop, "Kd", 2))
+        {
+            readFloats(3, &material->diffuse.x, 3);
+        }
+        else if (keyword(p, lineStop, "Ns", 2))
+        {
+            if (!explicitRoughness)
+                readFloats(3, &material->roughness, 1);
+        }
+        else if (keyword(p, lineStop, "Pr", 2))
+        {
+            explicitRoughness = readFloats(3, &material->roughness, 1);
+        }
+        else if (keyword(p, lineStop, "Pm", 2))
+        {
+            readFloats(3, &material->metallic, 1);
+        }
+        else if (keyword(p, lineStop, "map_Kd", 6))
+        {
+            material->diffuseMap = mapPath(directory, restOfLine(p + 7, lineStop));
+        }
+        else if (keyword(p, lineStop, "norm", 4) || keyword(p, lineStop, "bump", 4))
+        {
+            material->normalMap = mapPath(directory, restOfLine(p + 5, lineStop));
+        }
+        else if (keyword(p, lineStop, "map_Bump", 8) || keyword(p, lineStop, "map_bump", 8))
+        {
+            material->normalMap = mapPath(directory, restOfLine(p + 9, lineStop));
+        }
+        else if (keyword(p, lineStop, "map_Pr", 6))
+        {
+            material->roughnessMap = mapPath(directory, restOfLine(p + 7, lineStop));
+        }
+        else if (keyword(p, lineStop, "map_Pm", 6))
+        {
+            material->metallicMap = mapPath(directory, restOfLine(p + 7, lineStop));
+        }
+    }
+    finish();
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef OBJ_IMPORTER_H
+#define OBJ_IMPORTER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MeshBuilder.h"
+
+// Material de un .mtl traducido a las entradas PBR del motor. Las rutas de los mapas
+// ya son relativas al directorio de trabajo (se resuelven contra la carpeta del .mtl);
+// vacías si el material no tiene ese mapa.
+struct ObjMaterial {
+    std::string name;
+    glm::vec3 diffuse = glm::vec3(0.8f);
+    float roughness = 0.5f;     // Pr, o derivada del exponente especular Ns
+    float metallic = 0.0f;      // Pm
+    std::string diffuseMap;     // map_Kd
+    std::string normalMap;      // norm / map_Bump / bump
+    std::string roughnessMap;   // map_Pr
+    std::string metallicMap;    // map_Pm
+};
+
+// Caras de un mismo objeto ('o' / 'g') con el mismo material, ya indexadas.
+struct ObjMesh {
+    std::string name;
+    int material = -1;          // índice en ObjModel::materials; -1 sin material
+    MeshData data;
+};
+
+struct ObjModel {
+    std::vector<ObjMesh> meshes;
+    std::vector<ObjMaterial> materials;
+    size_t triangles = 0;
+};
+
+struct ObjImportOptions {
+    // Reordena cada malla para la caché de vértices (MeshBuilder). En escaneos de
+    // decenas de millones de triángulos es la etapa más cara.
+    bool optimize = true;
+};
+
+// Importador de Wavefront OBJ/MTL. El archivo se proyecta en memoria y se corta en
+// bloques de líneas completas que se analizan en paralelo con JobSystem (sin iostreams:
+// números con un parser propio). Un primer recorrido cuenta los v/vt/vn de cada bloque
+// para que el segundo escriba directamente en los arrays finales y resuelva los índices
+// negativos sin esperar a los bloques anteriores. Después se deduplican las esquinas
+// v/vt/vn de cada malla (una tabla por malla, mallas en paralelo); las normales que
+// falten se calculan suavizadas por posición y las tangentes con MeshBuilder.
+//
+// Se importan v, vt, vn, f (polígonos en abanico), o, g, usemtl y mtllib; el resto
+// de directivas (s, l, p, curvas...) se ignora.
+class ObjImporter
+{
+public:
+    // Un .mtl que falta deja un aviso en 'error', pero la geometría se importa igual.
+    static bool load(const std::string& path, ObjModel& model, std::string& error, const ObjImportOptions& options = ObjImportOptions());
+
+    // Lee los materiales de un .mtl y los añade a 'materials'.
+    static bool loadMaterials(const std::string& path, std::vector<ObjMaterial>& materials, std::string& error);
+};
+
+#endif // OBJ_IMPORTER_H
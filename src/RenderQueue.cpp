@@ -0,0 +1,268 @@
+#include "RenderQueue.h"
+#include "GLState.h"
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+
+namespace
+{
+    const int SHADER_SHIFT = 48;
+    const int MATERIAL_SHIFT = 32;
+    const int MESH_SHIFT = 16;
+    const int PASS_SHIFT = 60;
+
+    const uint64_t SHADER_MASK = 0xFFFull << SHADER_SHIFT;
+    const uint64_t MATERIAL_MASK = 0xFFFFull << MATERIAL_SHIFT;
+    const uint64_t MESH_MASK = 0xFFFFull << MESH_SHIFT;
+
+    // Los lotes se forman comparando la clave: dos recursos con el mismo campo acabarían
+    // en la misma llamada instanciada, así que todo identificador registrable debe caber.
+    static_assert(RenderQueue::MAX_RENDER_SHADERS <= (SHADER_MASK >> SHADER_SHIFT), "el campo shader no cubre MAX_RENDER_SHADERS");
+    static_assert(RenderQueue::MAX_RENDER_MATERIALS <= (MATERIAL_MASK >> MATERIAL_SHIFT), "el campo material no cubre MAX_RENDER_MATERIALS");
+    static_assert(RenderQueue::MAX_RENDER_MESHES <= (MESH_MASK >> MESH_SHIFT), "el campo mesh no cubre MAX_RENDER_MESHES");
+}
+
+uint64_t RenderQueue::makeKey(RenderPass pass, uint16_t shader, uint16_t material, uint16_t mesh, uint16_t depth)
+{
+    return ((uint64_t)pass << PASS_SHIFT) |
+           ((uint64_t)(shader & 0xFFF) << SHADER_SHIFT) |
+           ((uint64_t)material << MATERIAL_SHIFT) |
+           ((uint64_t)mesh << MESH_SHIFT) |
+           (uint64_t)depth;
+}
+
+uint16_t RenderQueue::addMesh(const Mesh& mesh)
+{
+    if (meshes.size() >= MAX_RENDER_MESHES)
+    {
+        std::cerr << "ERROR::RENDER_QUEUE::TOO_MANY_MESHES: " << MAX_RENDER_MESHES << std::endl;
+        return NO_RENDER_ID;
+    }
+    if (instanceVBO == 0)
+    {
+        glGenBuffers(1, &instanceVBO);
+        instanceCapacity = 1024;
+        GLState::bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(InstanceData), NULL, GL_STREAM_DRAW);
+    }
+
+    // Los atributos por instancia se activan una vez en el VAO; los punteros se fijan
+    // por lote en execute().
+    GLState::bindVertexArray(mesh.VAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (GLuint location = INSTANCE_ATTRIBUTE_LOCATION; location < INSTANCE_ATTRIBUTE_LOCATION + 5; ++location)
+    {
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    meshes.push_back(mesh);
+    bindInstanceAttributes(0);
+    return (uint16_t)(meshes.size() - 1);
+}
+
+uint16_t RenderQueue::addMaterial(const Material& material)
+{
+    if (materials.size() >= MAX_RENDER_MATERIALS)
+    {
+        std::cerr << "ERROR::RENDER_QUEUE::TOO_MANY_MATERIALS: " << MAX_RENDER_MATERIALS << std::endl;
+        return NO_RENDER_ID;
+    }
+    materials.push_back(material);
+    return (uint16_t)(materials.size() - 1);
+}
+
+uint16_t RenderQueue::shaderId(Shader& shader)
+{
+    for (size_t i = 0; i < shaders.size(); ++i)
+    {
+        if (shaders[i] == &shader)
+            return (uint16_t)i;
+    }
+    if (shaders.size() >= MAX_RENDER_SHADERS)
+    {
+        std::cerr << "ERROR::RENDER_QUEUE::TOO_MANY_SHADERS: " << MAX_RENDER_SHADERS << std::endl;
+        return NO_RENDER_ID;
+    }
+    shaders.push_back(&shader);
+    return (uint16_t)(shaders.size() - 1);
+}
+
+void RenderQueue::begin(const glm::vec3& position, const glm::vec3& front, float farPlane)
+{
+    packets.clear();
+    instances.clear();
+    cameraPosition = position;
+    cameraFront = front;
+    depthScale = farPlane > 0.0f ? 65535.0f / farPlane : 0.0f;
+}
+
+void RenderQueue::push(RenderPass pass, uint16_t shader, uint16_t material, uint16_t mesh, const glm::mat4& model,
+                       const glm::vec4& params)
+{
+    // Profundidad en vista del origen del objeto, cuantizada a 16 bits.
+    float viewDepth = glm::dot(glm::vec3(model[3]) - cameraPosition, cameraFront);
+    float scaled = std::min(std::max(viewDepth * depthScale, 0.0f), 65535.0f);
+    uint16_t depth = (uint16_t)scaled;
+    if (pass == RenderPass::Transparent)
+        depth = (uint16_t)(0xFFFF - depth);
+
+    // Un identificador sin registrar (p. ej. NO_RENDER_ID) se saldría de su campo y la
+    // clave se confundiría con la de otro recurso.
+    if (shader >= shaders.size() || material >= materials.size() || mesh >= meshes.size())
+        return;
+
+    packets.push_back({ makeKey(pass, shader, material, mesh, depth), (uint32_t)instances.size() });
+    instances.push_back({ model, params });
+}
+
+void RenderQueue::sort()
+{
+    const size_t count = packets.size();
+    if (count < 2)
+        return;
+    scratch.resize(count);
+
+    DrawPacket* source = packets.data();
+    DrawPacket* destination = scratch.data();
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256] = {};
+        for (size_t i = 0; i < count; ++i)
+            histogram[(source[i].key >> shift) & 0xFF]++;
+
+        // Si todos los paquetes comparten este byte, la pasada no cambia el orden.
+        if (histogram[(source[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for (size_t& bucket : histogram)
+        {
+            size_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; ++i)
+            destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        std::swap(source, destination);
+    }
+
+    if (source != packets.data())
+        packets.swap(scratch);
+}
+
+void RenderQueue::execute()
+{
+    lastStats = Stats();
+    if (packets.empty())
+        return;
+
+    // Datos de instancia en el orden ya ordenado: cada lote ocupa un rango contiguo.
+    sortedInstances.resize(packets.size());
+    for (size_t i = 0; i < packets.size(); ++i)
+        sortedInstances[i] = instances[packets[i].instance];
+
+    // Se huérfana el buffer para no esperar a que la GPU termine con el frame anterior.
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    const size_t bytes = sortedInstances.size() * sizeof(InstanceData);
+    if (sortedInstances.size() > instanceCapacity)
+        instanceCapacity = std::max(sortedInstances.size(), instanceCapacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(InstanceData), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, sortedInstances.data());
+
+    // Se fuerza el primer cambio de cada campo con una clave imposible.
+    uint64_t previous = ~0ull;
+    const size_t count = packets.size();
+    size_t first = 0;
+    while (first < count)
+    {
+        const uint64_t key = packets[first].key;
+        const uint64_t changed = key ^ previous;
+        assert(((key & SHADER_MASK) >> SHADER_SHIFT) < shaders.size() && ((key & MATERIAL_MASK) >> MATERIAL_SHIFT) < materials.size() &&
+               ((key & MESH_MASK) >> MESH_SHIFT) < meshes.size());
+
+        if (changed & SHADER_MASK)
+        {
+            shaders[(key & SHADER_MASK) >> SHADER_SHIFT]->use();
+            lastStats.programChanges++;
+        }
+        if (changed & MATERIAL_MASK)
+        {
+            const Material& material = materials[(key & MATERIAL_MASK) >> MATERIAL_SHIFT];
+            for (int unit = 0; unit < MATERIAL_TEXTURE_UNITS; ++unit)
+            {
+                if (material.textures[unit] == 0)
+                    continue;
+                GLState::bindTexture(unit, GL_TEXTURE_2D, material.textures[unit]);
+                TextureLoader::markUsed(material.textures[unit]);
+            }
+            lastStats.materialChanges++;
+        }
+        // Los factores son uniforms del programa: se suben también al cambiar de programa
+        // aunque el material sea el mismo. Los programas que no los declaran los ignoran.
+        if (changed & (SHADER_MASK | MATERIAL_MASK))
+        {
+            static constexpr UniformName BASE_COLOR_FACTOR("baseColorFactor");
+            static constexpr UniformName METALLIC_FACTOR("metallicFactor");
+            static constexpr UniformName ROUGHNESS_FACTOR("roughnessFactor");
+            const Shader& shader = *shaders[(key & SHADER_MASK) >> SHADER_SHIFT];
+            const Material& material = materials[(key & MATERIAL_MASK) >> MATERIAL_SHIFT];
+            const UniformHandle baseColor = shader.getUniform(BASE_COLOR_FACTOR);
+            if (baseColor.valid())
+            {
+                shader.setVec3(baseColor, material.baseColorFactor);
+                shader.setFloat(shader.getUniform(METALLIC_FACTOR), material.metallicFactor);
+                shader.setFloat(shader.getUniform(ROUGHNESS_FACTOR), material.roughnessFactor);
+            }
+        }
+        const Mesh& mesh = meshes[(key & MESH_MASK) >> MESH_SHIFT];
+        if (changed & MESH_MASK)
+        {
+            GLState::bindVertexArray(mesh.VAO);
+            bindMeshBounds(mesh);
+            lastStats.meshChanges++;
+        }
+
+        // El lote se extiende mientras solo cambie la profundidad.
+        const uint64_t stateMask = ~0xFFFFull;
+        size_t last = first + 1;
+        while (last < count && ((packets[last].key ^ key) & stateMask) == 0)
+            last++;
+
+        // GL 3.3 no tiene baseInstance: el inicio del lote se fija en los punteros.
+        bindInstanceAttributes(first);
+        if (mesh.indexCount > 0)
+            glDrawElementsInstanced(mesh.mode, mesh.indexCount, mesh.indexType, (void*)mesh.indexOffset, (GLsizei)(last - first));
+        else
+            glDrawArraysInstanced(mesh.mode, 0, mesh.vertexCount, (GLsizei)(last - first));
+        lastStats.draws++;
+        lastStats.instances += (int)(last - first);
+
+        previous = packets[last - 1].key;
+        first = last;
+    }
+}
+
+void RenderQueue::bindInstanceAttributes(size_t firstInstance)
+{
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    const GLsizei stride = sizeof(InstanceData);
+    const size_t base = firstInstance * sizeof(InstanceData);
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        glVertexAttribPointer(INSTANCE_ATTRIBUTE_LOCATION + column, 4, GL_FLOAT, GL_FALSE, stride,
+                              (void*)(base + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+    }
+    glVertexAttribPointer(INSTANCE_ATTRIBUTE_LOCATION + 4, 4, GL_FLOAT, GL_FALSE, stride,
+                          (void*)(base + offsetof(InstanceData, params)));
+}
+
+void RenderQueue::Delete()
+{
+    if (instanceVBO)
+        GLState::deleteBuffer(instanceVBO);
+    instanceVBO = 0;
+    instanceCapacity = 0;
+}
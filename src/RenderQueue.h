@@ -0,0 +1,119 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+#include "Mesh.h"
+#include "Material.h"
+
+// Datos por instancia que lee el vertex shader (atributos 4-8, divisor 1).
+// 'params' depende del programa: oclusión ambiental en PBR, color en los cubos de luz.
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 params;
+};
+
+// Primera ubicación de atributo de los datos por instancia (mat4 ocupa 4 ubicaciones).
+const GLuint INSTANCE_ATTRIBUTE_LOCATION = 4;
+
+// Identificador que devuelven addMesh, addMaterial y shaderId cuando ya no caben más
+// recursos en su campo de la clave. Los paquetes que lo usan se descartan en push().
+const uint16_t NO_RENDER_ID = 0xFFFF;
+
+// Pases de render en orden de ejecución.
+enum class RenderPass : uint8_t {
+    Opaque = 0,
+    Transparent = 1
+};
+
+// Cola de render: cada objeto visible emite un paquete con una clave de 64 bits que
+// se ordena por radix cada frame. Al enviar, solo se cambia de programa, texturas o
+// VAO cuando cambia el campo correspondiente de la clave. Los paquetes consecutivos con
+// el mismo programa, material y malla se agrupan en una sola llamada instanciada cuyas
+// matrices se suben juntas en un buffer de instancias por frame.
+//
+// Clave (bit más significativo primero):
+//   pass (4) | shader (12) | material (16) | mesh (16) | depth (16)
+// Los opacos se ordenan de delante hacia atrás dentro de un mismo estado; los
+// transparentes invierten la profundidad para dibujarse de atrás hacia delante.
+class RenderQueue
+{
+public:
+    // Registra un recurso y devuelve el identificador que usan las claves. addMesh
+    // también activa en el VAO de la malla los atributos por instancia. Caben
+    // MAX_RENDER_MESHES mallas, MAX_RENDER_MATERIALS materiales y MAX_RENDER_SHADERS
+    // programas; pasado el límite se avisa y se devuelve NO_RENDER_ID.
+    uint16_t addMesh(const Mesh& mesh);
+    uint16_t addMaterial(const Material& material);
+    const Material& material(uint16_t id) const { return materials[id]; }
+    const Mesh& mesh(uint16_t id) const { return meshes[id]; }
+
+    // Devuelve el identificador de un programa, registrándolo la primera vez.
+    uint16_t shaderId(Shader& shader);
+
+    // Empieza un frame: vacía la cola y fija la cámara usada para la profundidad.
+    void begin(const glm::vec3& cameraPosition, const glm::vec3& cameraFront, float farPlane);
+
+    void push(RenderPass pass, uint16_t shader, uint16_t material, uint16_t mesh, const glm::mat4& model,
+              const glm::vec4& params = glm::vec4(1.0f));
+
+    // Ordena los paquetes por clave (radix LSD de 8 bits, omitiendo bytes constantes).
+    void sort();
+
+    // Sube los datos de instancia y emite las llamadas de dibujo en orden, agrupando
+    // lotes y filtrando los cambios de estado.
+    void execute();
+
+    // Libera el buffer de instancias.
+    void Delete();
+
+    size_t size() const { return packets.size(); }
+
+    // Cambios de estado emitidos en el último execute().
+    struct Stats {
+        int draws = 0;
+        int instances = 0;
+        int programChanges = 0;
+        int materialChanges = 0;
+        int meshChanges = 0;
+    };
+    const Stats& stats() const { return lastStats; }
+
+    static constexpr size_t MAX_RENDER_SHADERS = 0xFFF;
+    static constexpr size_t MAX_RENDER_MATERIALS = 0xFFFF;
+    static constexpr size_t MAX_RENDER_MESHES = 0xFFFF;
+
+    static uint64_t makeKey(RenderPass pass, uint16_t shader, uint16_t material, uint16_t mesh, uint16_t depth);
+
+private:
+    struct DrawPacket {
+        uint64_t key;
+        uint32_t instance;      // índice en 'instances'
+    };
+
+    std::vector<Shader*> shaders;
+    std::vector<Material> materials;
+    std::vector<Mesh> meshes;
+
+    std::vector<DrawPacket> packets;
+    std::vector<DrawPacket> scratch;
+    std::vector<InstanceData> instances;
+    std::vector<InstanceData> sortedInstances;
+
+    unsigned int instanceVBO = 0;
+    size_t instanceCapacity = 0;
+
+    void bindInstanceAttributes(size_t firstInstance);
+
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+    float depthScale = 1.0f;
+
+    Stats lastStats;
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,213 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <numeric>
+
+SceneNode SceneGraph::create(const Transform& local, SceneNode parent)
+{
+    // Al final de los arrays: el padre, si lo hay, ya está antes.
+    const uint32_t position = (uint32_t)nodes.size();
+    const uint32_t parentPosition = !parent.isNull() ? this->position(parent) : NO_POSITION;
+    const SceneNode node = positions.insert(position);
+    locals.push(local);
+    localMatrices.push_back(glm::mat4(1.0f));
+    worldMatrices.push_back(glm::mat4(1.0f));
+    parents.push_back(parentPosition);
+    dirty.push_back(0);
+    updatedPass.push_back(0);
+    nodes.push_back(node);
+    markDirty(position);
+    return node;
+}
+
+bool SceneGraph::destroy(SceneNode node)
+{
+    if (!positions.contains(node))
+        return false;
+    if (unsorted)
+        sortByDepth();
+
+    // Los descendientes van detrás del nodo: basta un recorrido desde su posición para
+    // marcarlos y otro para compactar lo que queda sin romper el orden.
+    const uint32_t first = position(node);
+    const uint32_t count = (uint32_t)nodes.size();
+    std::vector<uint32_t> newPositions(count - first, NO_POSITION);
+    std::vector<uint8_t> removed(count - first, 0);
+    removed[0] = 1;
+    for (uint32_t i = first + 1; i < count; ++i)
+        removed[i - first] = parents[i] != NO_POSITION && parents[i] >= first && removed[parents[i] - first];
+
+    uint32_t write = first;
+    for (uint32_t i = first; i < count; ++i)
+    {
+        if (removed[i - first])
+        {
+            positions.erase(nodes[i]);
+            continue;
+        }
+        newPositions[i - first] = write;
+        locals.copy(i, write);
+        localMatrices[write] = localMatrices[i];
+        worldMatrices[write] = worldMatrices[i];
+        parents[write] = parents[i] != NO_POSITION && parents[i] >= first ? newPositions[parents[i] - first] : parents[i];
+        dirty[write] = dirty[i];
+        updatedPass[write] = updatedPass[i];
+        nodes[write] = nodes[i];
+        positions.at(nodes[write].index) = write;
+        write++;
+    }
+    locals.resize(write);
+    localMatrices.resize(write);
+    worldMatrices.resize(write);
+    parents.resize(write);
+    dirty.resize(write);
+    updatedPass.resize(write);
+    nodes.resize(write);
+
+    if (firstDirty != NO_POSITION && firstDirty > first)
+        firstDirty = first;
+    if (firstDirty != NO_POSITION && firstDirty >= write)
+        firstDirty = NO_POSITION;
+    return true;
+}
+
+bool SceneGraph::setParent(SceneNode node, SceneNode parent)
+{
+    const uint32_t position = this->position(node);
+    uint32_t parentPosition = NO_POSITION;
+    if (!parent.isNull())
+    {
+        parentPosition = this->position(parent);
+        for (uint32_t ancestor = parentPosition; ancestor != NO_POSITION; ancestor = parents[ancestor])
+        {
+            if (ancestor == position)
+                return false;
+        }
+    }
+    parents[position] = parentPosition;
+    // Un padre que queda detrás del hijo obliga a reordenar antes del próximo recorrido.
+    if (parentPosition != NO_POSITION && parentPosition > position)
+        unsorted = true;
+    markDirty(position);
+    return true;
+}
+
+SceneNode SceneGraph::parent(SceneNode node) const
+{
+    const uint32_t parentPosition = parents[position(node)];
+    return parentPosition != NO_POSITION ? nodes[parentPosition] : NO_SCENE_NODE;
+}
+
+void SceneGraph::setLocal(SceneNode node, const Transform& transform)
+{
+    const uint32_t position = this->position(node);
+    locals.set(position, transform);
+    markDirty(position);
+}
+
+size_t SceneGraph::update()
+{
+    if (unsorted)
+        sortByDepth();
+    if (firstDirty == NO_POSITION)
+        return 0;
+
+    // Matrices locales: los bloques de 8 nodos con alguno sucio se recomponen enteros (los
+    // limpios dan la misma matriz) y los bloques seguidos van en una sola llamada.
+    const uint32_t count = (uint32_t)nodes.size();
+    uint32_t runStart = NO_POSITION;
+    for (uint32_t block = firstDirty & ~7u; block < count; block += 8)
+    {
+        const uint32_t blockEnd = std::min(block + 8, count);
+        const bool blockDirty = std::find(dirty.begin() + block, dirty.begin() + blockEnd, (uint8_t)1) != dirty.begin() + blockEnd;
+        if (blockDirty && runStart == NO_POSITION)
+            runStart = block;
+        if (!blockDirty && runStart != NO_POSITION)
+        {
+            locals.compose(runStart, block, &localMatrices[runStart]);
+            runStart = NO_POSITION;
+        }
+    }
+    if (runStart != NO_POSITION)
+        locals.compose(runStart, count, &localMatrices[runStart]);
+
+    // Un nodo se recalcula si cambió su Transform o si su padre se ha recalculado en este
+    // mismo recorrido; como el padre va antes, ya se sabe al llegar al hijo.
+    pass++;
+    size_t updated = 0;
+    for (uint32_t i = firstDirty; i < count; ++i)
+    {
+        const uint32_t parentPosition = parents[i];
+        const bool parentMoved = parentPosition != NO_POSITION && updatedPass[parentPosition] == pass;
+        if (!dirty[i] && !parentMoved)
+            continue;
+        dirty[i] = 0;
+        worldMatrices[i] = parentPosition != NO_POSITION ? worldMatrices[parentPosition] * localMatrices[i] : localMatrices[i];
+        updatedPass[i] = pass;
+        updated++;
+    }
+    firstDirty = NO_POSITION;
+    return updated;
+}
+
+void SceneGraph::markDirty(uint32_t position)
+{
+    dirty[position] = 1;
+    if (firstDirty == NO_POSITION || position < firstDirty)
+        firstDirty = position;
+}
+
+// Reordena los arrays por profundidad (orden estable), que deja cada padre antes que sus
+// hijos. Solo hace falta tras un setParent() hacia un nodo posterior.
+void SceneGraph::sortByDepth()
+{
+    const uint32_t count = (uint32_t)nodes.size();
+    std::vector<uint32_t> depths(count, NO_POSITION);
+    std::vector<uint32_t> chain;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t position = i;
+        while (position != NO_POSITION && depths[position] == NO_POSITION)
+        {
+            chain.push_back(position);
+            position = parents[position];
+        }
+        uint32_t depth = position != NO_POSITION ? depths[position] + 1 : 0;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+            depths[*it] = depth++;
+        chain.clear();
+    }
+
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&depths](uint32_t a, uint32_t b) { return depths[a] < depths[b]; });
+    std::vector<uint32_t> newPositions(count);
+    for (uint32_t i = 0; i < count; ++i)
+        newPositions[order[i]] = i;
+
+    auto permute = [&order](auto& values) {
+        std::remove_reference_t<decltype(values)> sorted;
+        sorted.reserve(values.size());
+        for (uint32_t position : order)
+            sorted.push_back(values[position]);
+        values.swap(sorted);
+    };
+    locals.permute(order);
+    permute(localMatrices);
+    permute(worldMatrices);
+    permute(parents);
+    permute(dirty);
+    permute(updatedPass);
+    permute(nodes);
+
+    firstDirty = NO_POSITION;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (parents[i] != NO_POSITION)
+            parents[i] = newPositions[parents[i]];
+        positions.at(nodes[i].index) = i;
+        if (dirty[i] && firstDirty == NO_POSITION)
+            firstDirty = i;
+    }
+    unsorted = false;
+}
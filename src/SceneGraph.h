@@ -0,0 +1,83 @@
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "SlotMap.h"
+#include "TransformArrays.h"
+
+// Handle de un nodo. No cambia aunque el nodo se mueva dentro de los arrays al
+// reordenarlos, y deja de valer al destruir el nodo aunque su ranura se reutilice.
+struct SceneNodeTag;
+using SceneNode = Handle<SceneNodeTag>;
+const SceneNode NO_SCENE_NODE = SceneNode();
+
+// Jerarquía de transformaciones. Cada nodo guarda su Transform, su matriz local y su
+// matriz de mundo, en arrays ordenados de forma que un padre siempre va antes que sus
+// hijos: update() los recorre una sola vez, en orden, y el mundo del padre ya está listo
+// cuando llega a cada hijo.
+//
+// Solo se recalcula lo modificado: setLocal() marca el nodo y update() recompone su
+// matriz local y, a partir de ahí, el mundo del nodo y de todo su subárbol. Una escena
+// quieta no cuesta nada. Las transformaciones se guardan en TransformArrays y las
+// matrices locales se componen por bloques con su kernel SIMD.
+class SceneGraph
+{
+public:
+    SceneNode create(const Transform& local = Transform(), SceneNode parent = NO_SCENE_NODE);
+
+    // Destruye el nodo y todo su subárbol. Devuelve false si el handle ya no era válido.
+    bool destroy(SceneNode node);
+    bool contains(SceneNode node) const { return positions.contains(node); }
+
+    // Cambia el padre conservando la transformación local. Devuelve false si 'parent' es
+    // el propio nodo o uno de sus descendientes.
+    bool setParent(SceneNode node, SceneNode parent);
+    SceneNode parent(SceneNode node) const;
+
+    Transform local(SceneNode node) const { return locals.get(position(node)); }
+    void setLocal(SceneNode node, const Transform& transform);
+
+    // Válidas desde el último update().
+    const glm::mat4& localMatrix(SceneNode node) const { return localMatrices[position(node)]; }
+    const glm::mat4& world(SceneNode node) const { return worldMatrices[position(node)]; }
+
+    // Recalcula las matrices de los nodos modificados y de sus descendientes. Devuelve
+    // cuántas matrices de mundo ha recalculado.
+    size_t update();
+
+    size_t size() const { return nodes.size(); }
+
+private:
+    static constexpr uint32_t NO_POSITION = ~0u;
+
+    uint32_t position(SceneNode node) const
+    {
+        assert(positions.contains(node));
+        return positions.at(node.index);
+    }
+    void markDirty(uint32_t position);
+    void sortByDepth();
+
+    // Por posición, con los padres antes que los hijos.
+    TransformArrays locals;
+    std::vector<glm::mat4> localMatrices;
+    std::vector<glm::mat4> worldMatrices;
+    std::vector<uint32_t> parents;          // posición del padre o NO_POSITION
+    std::vector<uint8_t> dirty;             // Transform cambiado desde el último update()
+    std::vector<uint32_t> updatedPass;      // último update() que recalculó el mundo
+    std::vector<SceneNode> nodes;           // handle del nodo en cada posición
+
+    SlotMap<SceneNodeTag, uint32_t> positions;  // posición de cada nodo
+
+    uint32_t firstDirty = NO_POSITION;      // el recorrido empieza aquí
+    uint32_t pass = 0;
+    bool unsorted = false;                  // un setParent() ha dejado un hijo antes que su padre
+};
+
+#endif // SCENE_GRAPH_H
@@ -1,118 +1,320 @@
 #include "Shader.h"
+#include "ShaderCache.h"
+#include "ShaderCompiler.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "StartupTimeline.h"
+#include "UniformBuffer.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <filesystem>
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath)
+    : Shader(vertexPath, fragmentPath, ShaderDefines())
 {
-    // 1. Recuperar el código fuente del vertex/fragment shader desde filePath
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines)
+{
+    // 1. Preprocesar los fuentes: #include, defines de la permutación y del motor
     std::string vertexCode;
     std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
+    ShaderPreprocessor::process(vertexPath, defines, vertexCode);
+    ShaderPreprocessor::process(fragmentPath, defines, fragmentCode);
 
-    // Asegurarse de que los objetos ifstream puedan lanzar excepciones
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try
-    {
-        // Abrir archivos
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-
-        // Leer el contenido de los archivos en los streams
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-
-        // Cerrar los manejadores de archivos
-        vShaderFile.close();
-        fShaderFile.close();
-
-        // Convertir stream a string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-
-        // --- INICIO DE DEPURACIÓN: IMPRIMIR CONTENIDO DE SHADERS ---
-        std::cout << "--- Vertex Shader Content (from file): ---" << std::endl;
-        std::cout << vertexCode << std::endl;
-        std::cout << "------------------------------------------" << std::endl;
-
-        std::cout << "--- Fragment Shader Content (from file): ---" << std::endl;
-        std::cout << fragmentCode << std::endl;
-        std::cout << "--------------------------------------------" << std::endl;
-        // --- FIN DE DEPURACIÓN ---
-    }
-    catch (std::ifstream::failure& e)
+    // 2. Intentar cargar el programa ya enlazado desde la caché de binarios
+    ID = glCreateProgram();
+    cacheKey = ShaderCache::makeKey(vertexCode, fragmentCode);
+    if (ShaderCache::load(ID, cacheKey))
     {
-        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+        linkState = LinkState::Linked;
+        bindUniformBlocks();
+        reflectUniforms();
+        return;
     }
+
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
 
-    // 2. Compilar shaders
-    unsigned int vertex, fragment;
-
-    // Vertex Shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
+    // 3. Enviar la compilación y el enlace sin consultar su estado: con
+    // GL_KHR_parallel_shader_compile el driver trabaja en segundo plano y el resultado
+    // se recoge en ensureLinked() la primera vez que se usa el programa.
+    vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vShaderCode, NULL);
+    glCompileShader(vertexShader);
 
-    // Fragment Shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
+    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fShaderCode, NULL);
+    glCompileShader(fragmentShader);
 
-    // Programa de Shaders
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    glAttachShader(ID, vertexShader);
+    glAttachShader(ID, fragmentShader);
+    if (ShaderCache::enabled())
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(ID);
+
+    std::string label = std::filesystem::path(vertexPath).stem().string();
+    if (!defines.empty())
+        label += "[" + defines.toString() + "]";
+    ShaderCompiler::track(ID, label);
+}
+
+bool Shader::isReady() const
+{
+    if (linkState != LinkState::Pending)
+        return true;
+
+    // Sin GL_KHR_parallel_shader_compile no se puede preguntar sin bloquear; se recoge ya
+    // (ensureLinked() espera al driver igual que lo haría el primer use()) para que quien
+    // sondea con isReady() acabe pasando al programa real.
+    GLint complete = GL_TRUE;
+    if (ShaderCompiler::parallel())
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &complete);
+    if (complete)
+        ensureLinked();
+    return complete != GL_FALSE;
+}
+
+void Shader::ensureLinked() const
+{
+    if (linkState != LinkState::Pending)
+        return;
+
+    // Las consultas de estado bloquean hasta que el driver termina.
+    const double waitStart = StartupTimeline::now();
+    checkCompileErrors(vertexShader, "VERTEX");
+    checkCompileErrors(fragmentShader, "FRAGMENT");
     checkCompileErrors(ID, "PROGRAM");
 
+    GLint linked = 0;
+    glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+    ShaderCompiler::finished(ID, waitStart, StartupTimeline::now());
+
     // Borrar los shaders ya que están enlazados en nuestro programa y ya no son necesarios
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    glDetachShader(ID, vertexShader);
+    glDetachShader(ID, fragmentShader);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    vertexShader = fragmentShader = 0;
+
+    if (!linked)
+    {
+        linkState = LinkState::Failed;
+        return;
+    }
+    linkState = LinkState::Linked;
+    ShaderCache::store(ID, cacheKey);
+    bindUniformBlocks();
+    reflectUniforms();
 }
 
 void Shader::use()
 {
-    glUseProgram(ID);
+    ensureLinked();
+    GLState::useProgram(ID);
 }
 
 void Shader::Delete()
 {
-    glDeleteProgram(ID);
+    if (vertexShader)
+        glDeleteShader(vertexShader);
+    if (fragmentShader)
+        glDeleteShader(fragmentShader);
+    vertexShader = fragmentShader = 0;
+    GLState::deleteProgram(ID);
+}
+
+UniformHandle Shader::getUniform(const std::string& name) const
+{
+    ensureLinked();
+
+    UniformHandle handle;
+    if (uniformTable.empty())
+        return handle;
+
+    const uint64_t hash = hashUniformName(name.c_str());
+    const size_t mask = uniformTable.size() - 1;
+    for (size_t i = hash & mask; uniformTable[i].hash != 0; i = (i + 1) & mask)
+    {
+        if (uniformTable[i].hash == hash && uniformTable[i].name == name)
+        {
+            handle.location = uniformTable[i].location;
+            break;
+        }
+    }
+    return handle;
+}
+
+UniformHandle Shader::getUniform(const UniformName& name) const
+{
+    ensureLinked();
+
+    UniformHandle handle;
+    if (uniformTable.empty())
+        return handle;
+
+    const size_t mask = uniformTable.size() - 1;
+    for (size_t i = name.hash & mask; uniformTable[i].hash != 0; i = (i + 1) & mask)
+    {
+        if (uniformTable[i].hash != name.hash)
+            continue;
+#ifndef NDEBUG
+        if (uniformTable[i].name != name.name)
+        {
+            std::cerr << "ERROR::SHADER::UNIFORM_HASH_COLLISION: " << name.name << " / " << uniformTable[i].name << std::endl;
+            continue;
+        }
+#endif
+        handle.location = uniformTable[i].location;
+        break;
+    }
+    return handle;
 }
 
 void Shader::setBool(const std::string& name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    setBool(getUniform(name), value);
 }
 void Shader::setInt(const std::string& name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    setInt(getUniform(name), value);
 }
 void Shader::setFloat(const std::string& name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    setFloat(getUniform(name), value);
 }
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat4(getUniform(name), mat);
 }
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec3(getUniform(name), value);
 }
 void Shader::setVec3(const std::string& name, float x, float y, float z) const
 {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    setVec3(getUniform(name), x, y, z);
+}
+
+void Shader::setBool(UniformHandle uniform, bool value) const
+{
+    glUniform1i(uniform.location, (int)value);
+}
+void Shader::setInt(UniformHandle uniform, int value) const
+{
+    glUniform1i(uniform.location, value);
+}
+void Shader::setFloat(UniformHandle uniform, float value) const
+{
+    glUniform1f(uniform.location, value);
+}
+void Shader::setMat4(UniformHandle uniform, const glm::mat4& mat) const
+{
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+}
+void Shader::setVec3(UniformHandle uniform, const glm::vec3& value) const
+{
+    glUniform3fv(uniform.location, 1, &value[0]);
+}
+void Shader::setVec3(UniformHandle uniform, float x, float y, float z) const
+{
+    glUniform3f(uniform.location, x, y, z);
+}
+
+void Shader::bindUniformBlocks() const
+{
+    // Bloques compartidos y su punto de enlace fijo (GLSL 330 no admite layout(binding)).
+    static const struct { const char* name; GLuint binding; } sharedBlocks[] = {
+        { "FrameData", FRAME_DATA_BINDING },
+        { "LightData", LIGHT_DATA_BINDING },
+    };
+
+    for (const auto& block : sharedBlocks)
+    {
+        GLuint index = glGetUniformBlockIndex(ID, block.name);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, block.binding);
+    }
+}
+
+void Shader::reflectUniforms() const
+{
+    GLint count = 0, maxNameLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    struct ActiveUniform
+    {
+        std::string name;
+        GLint location;
+    };
+    std::vector<ActiveUniform> active;
+    std::vector<char> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+
+        // Los miembros de bloques uniform no tienen ubicación propia.
+        GLint location = glGetUniformLocation(ID, name.c_str());
+        if (location < 0)
+            continue;
+
+        // Los arrays se reportan como "nombre[0]": se registran el nombre base
+        // y cada elemento, para que "nombre[3]" también sea una búsqueda directa.
+        size_t bracket = name.find('[');
+        if (bracket == std::string::npos)
+        {
+            active.push_back({ name, location });
+            continue;
+        }
+        std::string base = name.substr(0, bracket);
+        active.push_back({ base, location });
+        active.push_back({ base + "[0]", location });
+        for (GLint element = 1; element < size; ++element)
+        {
+            std::string elementName = base + "[" + std::to_string(element) + "]";
+            active.push_back({ elementName, glGetUniformLocation(ID, elementName.c_str()) });
+        }
+    }
+
+    // Capacidad potencia de dos con factor de carga <= 0.5 para sondeos cortos.
+    size_t capacity = 16;
+    while (capacity < active.size() * 2)
+        capacity *= 2;
+    uniformTable.assign(capacity, UniformSlot());
+
+    for (const ActiveUniform& uniform : active)
+        insertUniform(uniform.name, uniform.location);
+}
+
+void Shader::insertUniform(const std::string& name, GLint location) const
+{
+    const uint64_t hash = hashUniformName(name.c_str());
+    const size_t mask = uniformTable.size() - 1;
+    size_t i = hash & mask;
+    while (uniformTable[i].hash != 0)
+    {
+        if (uniformTable[i].hash == hash)
+        {
+            if (uniformTable[i].name == name)
+                return;
+            // Los dos se guardan: la búsqueda por nombre los distingue.
+            std::cerr << "ERROR::SHADER::UNIFORM_HASH_COLLISION: " << name << " / " << uniformTable[i].name << std::endl;
+        }
+        i = (i + 1) & mask;
+    }
+    uniformTable[i].hash = hash;
+    uniformTable[i].location = location;
+    uniformTable[i].name = name;
 }
 
-void Shader::checkCompileErrors(unsigned int shader, std::string type)
+void Shader::checkCompileErrors(unsigned int shader, std::string type) const
 {
     int success;
     char infoLog[1024];
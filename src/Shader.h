@@ -2,6 +2,8 @@
 #define SHADER_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -9,21 +11,73 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp> 
 
+#include "ShaderPreprocessor.h"
+
+// Hash FNV-1a de 64 bits de un nombre de uniform. Es constexpr para que los nombres
+// usados en el bucle de render se puedan precalcular en tiempo de compilación.
+constexpr uint64_t hashUniformName(const char* name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    while (*name)
+    {
+        hash ^= static_cast<uint8_t>(*name++);
+        hash *= 1099511628211ull;
+    }
+    // El 0 se reserva para marcar huecos vacíos en la tabla.
+    return hash != 0 ? hash : 1u;
+}
+
+// Nombre de uniform con su hash precalculado. La búsqueda compara el hash; las builds
+// de depuración comparan también el nombre, para que una colisión no devuelva en
+// silencio la ubicación de otro uniform. El constructor es explícito para que
+// getUniform("nombre") vaya sin ambigüedad a la versión con string; los nombres
+// precalculados se declaran como static constexpr UniformName.
+struct UniformName
+{
+    uint64_t hash;
+    const char* name;
+
+    explicit constexpr UniformName(const char* value) : hash(hashUniformName(value)), name(value) {}
+};
+
+// Ubicación de un uniform ya resuelta. Se obtiene una vez con Shader::getUniform()
+// y se pasa a los set* del bucle de render, que así no hacen trabajo con strings
+// ni consultas al driver.
+struct UniformHandle
+{
+    GLint location = -1;
+
+    bool valid() const { return location >= 0; }
+};
+
 class Shader
 {
 public:
     // El ID del programa de shader
     unsigned int ID;
 
-    // Constructor que lee y construye el shader
+    // Constructor que lee los fuentes y envía la compilación al driver sin esperarla.
+    // El programa se recoge (bloqueando si aún no ha terminado) en su primer uso.
     Shader(const char* vertexPath, const char* fragmentPath);
 
+    // Igual, compilando la permutación definida por 'defines'.
+    Shader(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines);
+
+    // Comprueba si el programa ya está enlazado. No bloquea con
+    // GL_KHR_parallel_shader_compile; sin la extensión espera al enlace y devuelve true.
+    bool isReady() const;
+
     // Activa el shader
     void use();
 
     // Elimina el programa de shader
     void Delete();
 
+    // Busca un uniform en la tabla reflejada al enlazar. No llama al driver. La versión
+    // con string compara siempre el nombre.
+    UniformHandle getUniform(const std::string& name) const;
+    UniformHandle getUniform(const UniformName& name) const;
+
     // Funciones para establecer uniformes
     void setBool(const std::string& name, bool value) const;
     void setInt(const std::string& name, int value) const;
@@ -32,9 +86,45 @@ public:
     void setVec3(const std::string& name, const glm::vec3& value) const;
     void setVec3(const std::string& name, float x, float y, float z) const;
 
+    // Variantes con ubicación ya resuelta, pensadas para el bucle de render
+    void setBool(UniformHandle uniform, bool value) const;
+    void setInt(UniformHandle uniform, int value) const;
+    void setFloat(UniformHandle uniform, float value) const;
+    void setMat4(UniformHandle uniform, const glm::mat4& mat) const;
+    void setVec3(UniformHandle uniform, const glm::vec3& value) const;
+    void setVec3(UniformHandle uniform, float x, float y, float z) const;
+
 private:
+    enum class LinkState { Pending, Linked, Failed };
+
+    // Estado de la compilación asíncrona. Es mutable porque el enlace se recoge de
+    // forma perezosa también desde métodos const como getUniform().
+    mutable LinkState linkState = LinkState::Pending;
+    mutable unsigned int vertexShader = 0;
+    mutable unsigned int fragmentShader = 0;
+    uint64_t cacheKey = 0;
+
+    // Espera al driver si hace falta, comprueba errores y refleja los uniforms.
+    void ensureLinked() const;
+
+    // Entrada de la tabla de uniforms: direccionamiento abierto con sondeo lineal.
+    struct UniformSlot
+    {
+        uint64_t hash = 0;
+        GLint location = -1;
+        std::string name;
+    };
+    mutable std::vector<UniformSlot> uniformTable;
+
+    // Asocia los bloques uniform compartidos (FrameData, LightData) a sus puntos fijos.
+    void bindUniformBlocks() const;
+
+    // Recorre los uniforms activos del programa enlazado y rellena la tabla.
+    void reflectUniforms() const;
+    void insertUniform(const std::string& name, GLint location) const;
+
     // Función de utilidad para comprobar errores de compilación/enlace de shaders.
-    void checkCompileErrors(unsigned int shader, std::string type);
+    void checkCompileErrors(unsigned int shader, std::string type) const;
 };
 
 #endif
@@ -0,0 +1,190 @@
+#include "ShaderCache.h"
+#include "GLExtensions.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+namespace
+{
+    // Cabecera de cada archivo de la caché.
+    struct CacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    const uint32_t CACHE_MAGIC = 0x42534843; // "CHSB"
+    const uint32_t CACHE_VERSION = 1;
+
+    bool cacheEnabled = false;
+    std::string cacheDirectory;
+    std::string driverSignature;
+
+    uint64_t fnv1a64(const void* data, size_t size, uint64_t hash)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Nombre de temporal que no comparte nadie: un token del proceso (aleatorio y con la
+    // hora de arranque), el hilo y un contador. Dos procesos que guardan el mismo programa
+    // escriben cada uno su archivo y el rename deja uno de los dos entero.
+    std::string uniqueTempSuffix()
+    {
+        static const uint64_t processToken = ((uint64_t)std::random_device()() << 32) ^
+                                             (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+        static std::atomic<uint32_t> counter(0);
+        const uint64_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+        char suffix[64];
+        std::snprintf(suffix, sizeof(suffix), ".%016llx-%08llx-%u.tmp", (unsigned long long)processToken,
+                      (unsigned long long)(thread & 0xFFFFFFFFull), counter.fetch_add(1));
+        return suffix;
+    }
+
+    std::string glString(GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+}
+
+void ShaderCache::init(const std::string& directory)
+{
+    cacheEnabled = false;
+    if (!glExtensions.programBinary)
+        return;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0)
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        std::cerr << "ERROR::SHADER_CACHE::DIRECTORY: " << directory << " (" << error.message() << ")" << std::endl;
+        return;
+    }
+
+    cacheDirectory = directory;
+    driverSignature = glString(GL_VENDOR) + '\n' + glString(GL_RENDERER) + '\n' + glString(GL_VERSION);
+    cacheEnabled = true;
+}
+
+bool ShaderCache::enabled()
+{
+    return cacheEnabled;
+}
+
+uint64_t ShaderCache::makeKey(const std::string& vertexCode, const std::string& fragmentCode)
+{
+    // El separador evita que "ab"+"c" y "a"+"bc" compartan clave.
+    const char separator = '\0';
+    uint64_t hash = 14695981039346656037ull;
+    hash = fnv1a64(driverSignature.data(), driverSignature.size(), hash);
+    hash = fnv1a64(&separator, 1, hash);
+    hash = fnv1a64(vertexCode.data(), vertexCode.size(), hash);
+    hash = fnv1a64(&separator, 1, hash);
+    hash = fnv1a64(fragmentCode.data(), fragmentCode.size(), hash);
+    return hash;
+}
+
+bool ShaderCache::load(GLuint program, uint64_t key)
+{
+    if (!cacheEnabled)
+        return false;
+
+    std::ifstream file(pathFor(key), std::ios::binary);
+    if (!file)
+        return false;
+
+    CacheHeader header = {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key)
+        return false;
+
+    // Una entrada corrupta podría pedir una reserva de varios GB: el binario tiene que
+    // ocupar exactamente lo que queda del archivo.
+    const std::streamoff binaryStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff fileEnd = file.tellg();
+    if (binaryStart < 0 || fileEnd - binaryStart != (std::streamoff)header.length || header.length == 0)
+        return false;
+    file.seekg(binaryStart);
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size()))
+        return false;
+
+    glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+
+    // El driver puede rechazar un binario válido (p. ej. tras actualizarse sin cambiar
+    // la cadena de versión); en ese caso se recompila desde el fuente.
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    return linked != 0;
+}
+
+void ShaderCache::store(GLuint program, uint64_t key)
+{
+    if (!cacheEnabled)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, NULL, &format, binary.data());
+
+    CacheHeader header = { CACHE_MAGIC, CACHE_VERSION, key, format, (uint32_t)length };
+
+    // Se escribe a un temporal propio de este proceso e hilo y se renombra, para no dejar
+    // archivos a medias si varios procesos (el editor y una herramienta, dos editores...)
+    // guardan el mismo programa a la vez.
+    std::string path = pathFor(key);
+    std::string tempPath = path + uniqueTempSuffix();
+    std::error_code error;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), binary.size());
+        file.close();
+        if (!file)
+        {
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+        std::filesystem::remove(tempPath, error);
+}
+
+std::string ShaderCache::pathFor(uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return cacheDirectory + "/" + name;
+}
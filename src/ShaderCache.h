@@ -0,0 +1,34 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <string>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+// Caché en disco de programas enlazados (glGetProgramBinary / glProgramBinary).
+// La clave combina el código fuente ya preprocesado con el fabricante, renderer y
+// versión del driver, de modo que una actualización del driver invalida la caché.
+// Si el binario no existe o el driver lo rechaza, Shader compila desde el fuente.
+class ShaderCache
+{
+public:
+    // Prepara la caché para el contexto actual. Llamar tras loadGLExtensions().
+    static void init(const std::string& directory = "cache/shaders");
+
+    static bool enabled();
+
+    // Clave de un programa a partir de sus fuentes y del driver actual.
+    static uint64_t makeKey(const std::string& vertexCode, const std::string& fragmentCode);
+
+    // Intenta cargar el binario en 'program'. Devuelve true si queda enlazado.
+    static bool load(GLuint program, uint64_t key);
+
+    // Guarda el binario de un programa ya enlazado.
+    static void store(GLuint program, uint64_t key);
+
+private:
+    static std::string pathFor(uint64_t key);
+};
+
+#endif // SHADER_CACHE_H
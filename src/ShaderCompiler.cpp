@@ -0,0 +1,88 @@
+#include "ShaderCompiler.h"
+#include "GLExtensions.h"
+#include "StartupTimeline.h"
+
+#include <vector>
+
+namespace
+{
+    struct PendingProgram
+    {
+        GLuint program;
+        std::string label;
+        double submitMs;
+        double completeMs;  // negativo mientras no se haya visto terminar
+        double blockedMs;
+    };
+
+    std::vector<PendingProgram> programs;
+}
+
+void ShaderCompiler::init()
+{
+    // 0xFFFFFFFF deja que el driver use tantos hilos como considere.
+    if (glExtensions.parallelShaderCompile)
+        glExtensions.maxShaderCompilerThreads(0xFFFFFFFFu);
+}
+
+bool ShaderCompiler::parallel()
+{
+    return glExtensions.parallelShaderCompile;
+}
+
+void ShaderCompiler::track(GLuint program, const std::string& label)
+{
+    programs.push_back({ program, label, StartupTimeline::now(), -1.0, 0.0 });
+}
+
+int ShaderCompiler::poll()
+{
+    int pending = 0;
+    for (PendingProgram& entry : programs)
+    {
+        if (entry.completeMs >= 0.0)
+            continue;
+
+        // Sin la extensión no hay forma de preguntar sin bloquear: el programa se da por
+        // terminado cuando Shader lo enlaza en su primer uso.
+        GLint complete = GL_FALSE;
+        if (parallel())
+            glGetProgramiv(entry.program, GL_COMPLETION_STATUS_KHR, &complete);
+
+        if (complete)
+            entry.completeMs = StartupTimeline::now();
+        else
+            pending++;
+    }
+    return pending;
+}
+
+void ShaderCompiler::finished(GLuint program, double waitStartMs, double waitEndMs)
+{
+    for (PendingProgram& entry : programs)
+    {
+        if (entry.program != program)
+            continue;
+        if (entry.completeMs < 0.0)
+            entry.completeMs = waitEndMs;
+        entry.blockedMs += waitEndMs - waitStartMs;
+
+        // Solo las esperas apreciables merecen su propio tramo.
+        if (waitEndMs - waitStartMs > 0.1)
+            StartupTimeline::addSpan("wait " + entry.label, waitStartMs, waitEndMs);
+    }
+}
+
+void ShaderCompiler::reportTimeline(std::ostream& out)
+{
+    double blockedTotal = 0.0;
+    for (const PendingProgram& entry : programs)
+    {
+        double completeMs = entry.completeMs >= 0.0 ? entry.completeMs : StartupTimeline::now();
+        StartupTimeline::addSpan("shader " + entry.label, entry.submitMs, completeMs);
+        blockedTotal += entry.blockedMs;
+    }
+    StartupTimeline::report(out);
+    out << "Shader compilation: " << (parallel() ? "parallel (KHR_parallel_shader_compile)" : "driver default")
+        << ", main thread blocked " << blockedTotal << " ms" << std::endl;
+}
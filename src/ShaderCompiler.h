@@ -0,0 +1,37 @@
+#ifndef SHADER_COMPILER_H
+#define SHADER_COMPILER_H
+
+#include <string>
+#include <ostream>
+
+#include <glad/glad.h>
+
+// Servicio de compilación asíncrona. Los constructores de Shader solo envían el trabajo
+// (glCompileShader/glLinkProgram) sin consultar su estado; con
+// GL_KHR_parallel_shader_compile el driver compila en sus propios hilos y aquí se
+// sondea GL_COMPLETION_STATUS_KHR sin bloquear. Un programa solo bloquea la primera
+// vez que se usa si aún no ha terminado.
+class ShaderCompiler
+{
+public:
+    // Activa los hilos de compilación del driver. Llamar tras loadGLExtensions().
+    static void init();
+
+    static bool parallel();
+
+    // Registra un programa enviado a compilar.
+    static void track(GLuint program, const std::string& label);
+
+    // Comprueba sin bloquear qué programas han terminado. Devuelve cuántos siguen pendientes.
+    static int poll();
+
+    // Lo llama Shader al terminar de enlazar un programa; [waitStartMs, waitEndMs] es el
+    // tiempo que el hilo principal estuvo bloqueado esperando al driver.
+    static void finished(GLuint program, double waitStartMs, double waitEndMs);
+
+    // Añade a StartupTimeline un tramo por programa e imprime la línea de tiempo
+    // junto con el total de tiempo bloqueado en shaders.
+    static void reportTimeline(std::ostream& out);
+};
+
+#endif // SHADER_COMPILER_H
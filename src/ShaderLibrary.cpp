@@ -0,0 +1,29 @@
+#include "ShaderLibrary.h"
+
+Shader& ShaderLibrary::get(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines)
+{
+    // Clave: hash de las rutas combinado con el hash del conjunto de defines.
+    uint64_t key = defines.hash();
+    for (const std::string* path : { &vertexPath, &fragmentPath })
+    {
+        for (unsigned char c : *path)
+        {
+            key ^= c;
+            key *= 1099511628211ull;
+        }
+        key ^= 0xFF;
+        key *= 1099511628211ull;
+    }
+
+    std::unique_ptr<Shader>& program = programs[key];
+    if (!program)
+        program = std::make_unique<Shader>(vertexPath.c_str(), fragmentPath.c_str(), defines);
+    return *program;
+}
+
+void ShaderLibrary::Delete()
+{
+    for (auto& entry : programs)
+        entry.second->Delete();
+    programs.clear();
+}
@@ -0,0 +1,29 @@
+#ifndef SHADER_LIBRARY_H
+#define SHADER_LIBRARY_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "Shader.h"
+#include "ShaderPreprocessor.h"
+
+// Caché de permutaciones compiladas. Cada combinación de (vertex, fragment, defines)
+// se compila una sola vez; las variantes baratas (p. ej. sin normal map) se eligen en
+// tiempo de dibujo en lugar de ramificar dentro de un único uber-shader.
+class ShaderLibrary
+{
+public:
+    // Devuelve la permutación pedida, enviándola a compilar si es la primera vez.
+    Shader& get(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines = ShaderDefines());
+
+    size_t size() const { return programs.size(); }
+
+    // Elimina todos los programas de la caché.
+    void Delete();
+
+private:
+    std::unordered_map<uint64_t, std::unique_ptr<Shader>> programs;
+};
+
+#endif // SHADER_LIBRARY_H
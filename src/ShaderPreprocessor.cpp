@@ -0,0 +1,155 @@
+#include "ShaderPreprocessor.h"
+#include "UniformBuffer.h"
+#include "VirtualFileSystem.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    std::string includeRoot = "assets/shaders/";
+
+    // Devuelve el archivo de una línea '#include "archivo"' o cadena vacía si no lo es.
+    std::string parseInclude(const std::string& line)
+    {
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos || line.compare(pos, 8, "#include") != 0)
+            return std::string();
+        size_t open = line.find('"', pos + 8);
+        size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+        if (close == std::string::npos)
+            return std::string();
+        return line.substr(open + 1, close - open - 1);
+    }
+
+    bool expand(const std::string& path, int fileIndex, std::vector<std::string>& included, std::string& output)
+    {
+        std::string source;
+        if (!VirtualFileSystem::read(path, source))
+        {
+            std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+            return false;
+        }
+
+        std::istringstream lines(source);
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(lines, line))
+        {
+            lineNumber++;
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            std::string includeName = parseInclude(line);
+            if (includeName.empty())
+            {
+                output += line;
+                output += '\n';
+                continue;
+            }
+
+            std::string includePath = includeRoot + includeName;
+            if (std::find(included.begin(), included.end(), includePath) == included.end())
+            {
+                included.push_back(includePath);
+                int includeIndex = (int)included.size();
+                output += "#line 1 " + std::to_string(includeIndex) + "\n";
+                if (!expand(includePath, includeIndex, included, output))
+                    return false;
+            }
+            output += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+        }
+        return true;
+    }
+}
+
+ShaderDefines& ShaderDefines::set(const std::string& name, const std::string& value)
+{
+    auto it = std::lower_bound(defines.begin(), defines.end(), name,
+        [](const std::pair<std::string, std::string>& define, const std::string& key) { return define.first < key; });
+    if (it != defines.end() && it->first == name)
+        it->second = value;
+    else
+        defines.insert(it, { name, value });
+    return *this;
+}
+
+ShaderDefines& ShaderDefines::set(const std::string& name, int value)
+{
+    return set(name, std::to_string(value));
+}
+
+uint64_t ShaderDefines::hash() const
+{
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const std::string& text) {
+        for (unsigned char c : text)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        hash ^= 0xFF;   // separador
+        hash *= 1099511628211ull;
+    };
+    for (const auto& define : defines)
+    {
+        mix(define.first);
+        mix(define.second);
+    }
+    return hash;
+}
+
+std::string ShaderDefines::toSource() const
+{
+    std::string source;
+    for (const auto& define : defines)
+        source += "#define " + define.first + " " + define.second + "\n";
+    return source;
+}
+
+std::string ShaderDefines::toString() const
+{
+    std::string text;
+    for (const auto& define : defines)
+    {
+        if (!text.empty())
+            text += ',';
+        text += define.first;
+        if (define.second != "1")
+            text += "=" + define.second;
+    }
+    return text;
+}
+
+void ShaderPreprocessor::setIncludeRoot(const std::string& directory)
+{
+    includeRoot = directory;
+    if (!includeRoot.empty() && includeRoot.back() != '/')
+        includeRoot += '/';
+}
+
+bool ShaderPreprocessor::process(const std::string& path, const ShaderDefines& defines, std::string& output)
+{
+    std::string body;
+    std::vector<std::string> included;
+    if (!expand(path, 0, included, body))
+        return false;
+
+    // #version tiene que ser la primera directiva: los defines van justo detrás.
+    size_t versionEnd = 0;
+    size_t versionPos = body.find("#version");
+    if (versionPos != std::string::npos)
+        versionEnd = body.find('\n', versionPos) + 1;
+
+    ShaderDefines engineDefines;
+    engineDefines.set("MAX_LIGHTS", MAX_LIGHTS);
+
+    output = body.substr(0, versionEnd);
+    output += engineDefines.toSource();
+    output += defines.toSource();
+    if (versionEnd > 0)
+        output += "#line 2 0\n";
+    output += body.substr(versionEnd);
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Conjunto de #define que selecciona una permutación de un shader. Se mantiene ordenado
+// por nombre para que dos conjuntos iguales den siempre el mismo hash.
+class ShaderDefines
+{
+public:
+    ShaderDefines() = default;
+
+    ShaderDefines& set(const std::string& name, const std::string& value = "1");
+    ShaderDefines& set(const std::string& name, int value);
+
+    bool empty() const { return defines.empty(); }
+    uint64_t hash() const;
+
+    // Bloque "#define NOMBRE VALOR" listo para insertar en el fuente.
+    std::string toSource() const;
+
+    // Resumen legible, p. ej. "NORMAL_MAP,ORM_MAP".
+    std::string toString() const;
+
+private:
+    std::vector<std::pair<std::string, std::string>> defines;
+};
+
+// Preprocesado GLSL previo a la compilación:
+//  - resuelve #include "archivo" relativo a la raíz de shaders (cada archivo una sola vez),
+//  - inserta los #define de la permutación y los del motor (MAX_LIGHTS...) tras #version,
+//  - emite directivas #line para que los errores del driver apunten a la línea original.
+class ShaderPreprocessor
+{
+public:
+    static void setIncludeRoot(const std::string& directory);
+
+    // Lee 'path' y deja en 'output' el fuente final. Devuelve false si algún archivo falla.
+    static bool process(const std::string& path, const ShaderDefines& defines, std::string& output);
+};
+
+#endif // SHADER_PREPROCESSOR_H
@@ -0,0 +1,91 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Referencia a un elemento de un SlotMap: índice de su ranura (32 bits) y generación de
+// la ranura cuando se creó. Al borrar el elemento la ranura cambia de generación, así que
+// un handle viejo deja de resolver aunque la ranura se reutilice. 'Tag' solo distingue
+// tipos (un SceneNode no se puede pasar donde se espera un Entity).
+template <typename Tag>
+struct Handle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == ~0u; }
+    bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+// Parte dispersa de un slot map: por cada ranura, su generación y dónde guarda el
+// contenedor el elemento ('Location', p. ej. una posición en sus arrays densos). El
+// contenedor decide el almacenamiento denso y, si mueve un elemento (borrado con el
+// último en el hueco, reordenación...), actualiza su Location con at().
+//
+// Insertar, borrar y buscar son O(1); las ranuras libres se reutilizan en orden LIFO.
+template <typename Tag, typename Location>
+class SlotMap
+{
+public:
+    Handle<Tag> insert(const Location& location)
+    {
+        uint32_t index;
+        if (!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)slots.size();
+            slots.emplace_back();
+        }
+        slots[index].location = location;
+        slots[index].alive = true;
+        living++;
+        return { index, slots[index].generation };
+    }
+
+    // Invalida todos los handles del elemento. Devuelve false si ya no era válido.
+    bool erase(Handle<Tag> handle)
+    {
+        if (!contains(handle))
+            return false;
+        Slot& slot = slots[handle.index];
+        slot.alive = false;
+        slot.generation++;
+        freeSlots.push_back(handle.index);
+        living--;
+        return true;
+    }
+
+    bool contains(Handle<Tag> handle) const
+    {
+        return handle.index < slots.size() && slots[handle.index].alive && slots[handle.index].generation == handle.generation;
+    }
+
+    // Nulo si el handle no es válido.
+    Location* find(Handle<Tag> handle) { return contains(handle) ? &slots[handle.index].location : nullptr; }
+    const Location* find(Handle<Tag> handle) const { return contains(handle) ? &slots[handle.index].location : nullptr; }
+
+    // Sin comprobar la generación: para el contenedor, que sabe que la ranura está viva.
+    Location& at(uint32_t index) { return slots[index].location; }
+    const Location& at(uint32_t index) const { return slots[index].location; }
+    Handle<Tag> handle(uint32_t index) const { return { index, slots[index].generation }; }
+
+    size_t size() const { return living; }
+
+private:
+    struct Slot {
+        Location location{};
+        uint32_t generation = 0;
+        bool alive = false;
+    };
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    size_t living = 0;
+};
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,82 @@
+#include "StartupTimeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    struct Span
+    {
+        std::string label;
+        double startMs;
+        double endMs;   // negativo mientras el tramo sigue abierto
+    };
+
+    std::vector<Span> spans;
+
+    const std::chrono::steady_clock::time_point& origin()
+    {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return start;
+    }
+}
+
+double StartupTimeline::now()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin()).count();
+}
+
+void StartupTimeline::begin(const std::string& label)
+{
+    spans.push_back({ label, now(), -1.0 });
+}
+
+void StartupTimeline::end(const std::string& label)
+{
+    for (auto it = spans.rbegin(); it != spans.rend(); ++it)
+    {
+        if (it->label == label && it->endMs < 0.0)
+        {
+            it->endMs = now();
+            return;
+        }
+    }
+}
+
+void StartupTimeline::addSpan(const std::string& label, double startMs, double endMs)
+{
+    spans.push_back({ label, startMs, endMs });
+}
+
+void StartupTimeline::report(std::ostream& out)
+{
+    const double reportTime = now();
+    double total = 0.0;
+    size_t labelWidth = 0;
+    for (const Span& span : spans)
+    {
+        total = std::max(total, span.endMs < 0.0 ? reportTime : span.endMs);
+        labelWidth = std::max(labelWidth, span.label.size());
+    }
+    if (total <= 0.0)
+        return;
+
+    const int barWidth = 50;
+    out << "--- Startup timeline (" << total << " ms) ---" << std::endl;
+    for (const Span& span : spans)
+    {
+        const double endMs = span.endMs < 0.0 ? reportTime : span.endMs;
+        const int first = (int)(span.startMs / total * barWidth);
+        const int last = std::max(first + 1, (int)(endMs / total * barWidth));
+
+        std::string bar(barWidth, ' ');
+        for (int i = first; i < last && i < barWidth; ++i)
+            bar[i] = '#';
+
+        char times[64];
+        std::snprintf(times, sizeof(times), "%8.1f -> %8.1f ms (%7.1f)", span.startMs, endMs, endMs - span.startMs);
+        out << span.label << std::string(labelWidth - span.label.size(), ' ') << " |" << bar << "| " << times << std::endl;
+    }
+}
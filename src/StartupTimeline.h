@@ -0,0 +1,25 @@
+#ifndef STARTUP_TIMELINE_H
+#define STARTUP_TIMELINE_H
+
+#include <string>
+#include <ostream>
+
+// Registro de los tramos del arranque (ventana, compilación de shaders, texturas...)
+// para ver qué trabajo se solapa. Los tiempos son milisegundos desde el primer uso.
+class StartupTimeline
+{
+public:
+    static double now();
+
+    // Abre y cierra un tramo por nombre.
+    static void begin(const std::string& label);
+    static void end(const std::string& label);
+
+    // Añade un tramo con tiempos ya medidos (p. ej. observados al sondear el driver).
+    static void addSpan(const std::string& label, double startMs, double endMs);
+
+    // Imprime la línea de tiempo con una barra por tramo.
+    static void report(std::ostream& out);
+};
+
+#endif // STARTUP_TIMELINE_H
@@ -0,0 +1,925 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "TextureLoader.h"
+#include "AsyncIO.h"
+#include "JobSystem.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "StartupTimeline.h"
+#include "MipGenerator.h"
+#include "VirtualFileSystem.h"
+#include "KtxFile.h"
+#include "ChannelPacker.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // Segmentos de staging: uno por frame en vuelo, protegido por una fence.
+    const int STAGING_SEGMENTS = 3;
+
+    // Frames sin dibujarse a partir de los cuales una textura puede ceder mips para que
+    // otra recupere los suyos. Por encima del presupuesto se recorta igualmente.
+    const uint64_t EVICTION_GRACE_FRAMES = 300;
+
+    // Los mips de este tamaño o menores nunca se liberan: ocupan poco y la textura
+    // siempre tiene algo razonable que muestrear.
+    const int MIN_RESIDENT_SIZE = 64;
+
+    // Resultado de un trabajo de carga: píxeles con sus mips o, si existe una versión
+    // cocinada (.ktx2), sus bloques comprimidos: el archivo (o la entrada del paquete)
+    // abierto con VirtualFileSystem o los bytes que ha leído AsyncIO.
+    struct DecodedImage {
+        MipChain chain;
+        AssetFile file;
+        std::vector<unsigned char> bytes;
+        KtxImage ktx;
+        bool compressed = false;
+        double decodeStartMs = 0.0;
+        double decodeEndMs = 0.0;
+
+        const unsigned char* fileData() const { return file.isOpen() ? file.data() : bytes.data(); }
+        size_t fileSize() const { return file.isOpen() ? file.size() : bytes.size(); }
+
+        int levels() const { return compressed ? (int)ktx.levels.size() : chain.levels(); }
+        int width() const { return compressed ? (int)ktx.width : chain.width; }
+        int height() const { return compressed ? (int)ktx.height : chain.height; }
+    };
+
+    struct PendingTexture {
+        GLuint texture;
+        uint64_t ticket;    // identifica el trabajo: el nombre GL puede reutilizarse tras release()
+        std::string path;
+        std::unique_ptr<DecodedImage> image;   // nulo mientras se decodifica
+        uint64_t ioRequest = 0;     // lectura de AsyncIO, si la carga empezó por ahí
+        bool failed = false;
+        bool allocated = false;
+        bool restream = false;  // recarga de mips liberados: los niveles residentes no se tocan
+        int level = 0;      // mip que se está subiendo (baja hasta targetLevel)
+        int firstLevel = 0; // en una recarga, el mip liberado menos detallado
+        int targetLevel = 0;
+        int row = 0;        // siguiente fila del mip
+        int frames = 0;
+        double uploadStartMs = 0.0;
+    };
+
+    struct StagingSegment {
+        GLuint buffer = 0;
+        unsigned char* mapped = nullptr;  // solo con buffers persistentes
+        GLsync fence = nullptr;
+    };
+
+    // Copia de una franja de filas al staging y su glTexSubImage2D, o un nivel comprimido
+    // completo que se sube directamente desde el archivo proyectado.
+    struct UploadOp {
+        PendingTexture* texture;
+        int level;
+        int row;
+        int rows;
+        const unsigned char* source;
+        size_t offset;
+        size_t bytes;
+        bool completesLevel;
+        bool compressed;
+    };
+
+    size_t frameBudget = 0;
+    StagingSegment segments[STAGING_SEGMENTS];
+    int frameIndex = 0;
+
+    // Texturas en curso, solo del hilo principal.
+    std::vector<std::unique_ptr<PendingTexture>> pendingTextures;
+
+    // Resultados de los hilos de trabajo.
+    std::mutex decodedMutex;
+    std::deque<std::pair<uint64_t, std::unique_ptr<DecodedImage>>> decoded;
+    uint64_t nextTicket = 1;
+
+    std::string cookedPath(const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        const size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return path + ".ktx2";
+        return path.substr(0, dot) + ".ktx2";
+    }
+
+    bool endsWith(const std::string& text, const char* suffix)
+    {
+        const size_t length = std::strlen(suffix);
+        return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+    }
+
+    bool blockFormatSupported(BlockFormat format)
+    {
+        return format == BlockFormat::BC4 || format == BlockFormat::BC5 || glExtensions.textureCompressionS3TC;
+    }
+
+    GLenum compressedFormat(BlockFormat format)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case BlockFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case BlockFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+        case BlockFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+        }
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+
+    // Valida la versión cocinada ya abierta o leída en 'image'. Si está proyectada, sus
+    // páginas se leen aquí para que el hilo principal no sufra los fallos de página al subir.
+    bool acceptCooked(const std::string& path, DecodedImage& image)
+    {
+        std::string error;
+        if (!KtxFile::parse(image.fileData(), image.fileSize(), image.ktx, error))
+        {
+            std::cout << "ERROR::TEXTURE::KTX2\n" << "Path: " << path << " (" << error << ")" << std::endl;
+            image.file.close();
+            image.bytes = std::vector<unsigned char>();
+            return false;
+        }
+        if (!blockFormatSupported(image.ktx.format))
+        {
+            image.file.close();
+            image.bytes = std::vector<unsigned char>();
+            return false;
+        }
+        if (image.file.isOpen())
+        {
+            image.file.prefetch();
+            volatile unsigned char touch = 0;
+            for (size_t offset = 0; offset < image.file.size(); offset += 4096)
+                touch ^= image.file.data()[offset];
+            (void)touch;
+        }
+        image.compressed = true;
+        return true;
+    }
+
+    bool openCooked(const std::string& path, DecodedImage& image)
+    {
+        return VirtualFileSystem::open(path, image.file) && acceptCooked(path, image);
+    }
+
+    // Qué cargar: una imagen o, con packORM, los mapas de un canal que se empaquetan en
+    // una textura ORM. 'path' es la imagen o la versión cocinada del empaquetado; con
+    // 'encoded' la imagen ya está en memoria y 'path' solo la identifica.
+    struct LoadRequest {
+        std::string path;
+        std::shared_ptr<const std::vector<unsigned char>> encoded;
+        TextureKind kind = TextureKind::Color;
+        bool packORM = false;
+        std::string occlusion;
+        std::string roughness;
+        std::string metallic;
+    };
+
+    // Estado de residencia de una textura, desde load() hasta el release() final.
+    struct TextureRecord {
+        std::string key;
+        LoadRequest request;
+        int refs = 1;
+        uint64_t lastUsedFrame = 0;
+        bool loaded = false;    // la primera carga completa ha terminado
+        bool streaming = false; // hay un PendingTexture en curso
+        bool failed = false;    // no se vuelve a intentar la carga
+        bool compressed = false;
+        GLenum storageFormat = GL_RGBA8;
+        GLenum pixelFormat = GL_RGBA;
+        int width = 1;
+        int height = 1;
+        int residentLevel = 0;  // mip más detallado con almacenamiento en la GPU (o reservado por una recarga)
+        std::vector<size_t> levelBytes = { 4 };  // el texel provisional
+
+        int levels() const { return (int)levelBytes.size(); }
+
+        size_t residentBytes() const
+        {
+            size_t bytes = 0;
+            for (int level = residentLevel; level < levels(); ++level)
+                bytes += levelBytes[level];
+            return bytes;
+        }
+
+        bool canDropLevel() const
+        {
+            return loaded && !streaming && residentLevel < levels() - 1 &&
+                   std::max(width >> residentLevel, height >> residentLevel) > MIN_RESIDENT_SIZE;
+        }
+    };
+
+    std::unordered_map<GLuint, TextureRecord> records;
+    std::unordered_map<std::string, GLuint> recordsByKey;
+    uint64_t frameNumber = 0;
+    size_t memoryBudget = 0;
+    int evictedLevels = 0;
+    int restreams = 0;
+
+    // Clave de deduplicación: uso de la textura y rutas de origen con separadores uniformes.
+    std::string requestKey(const LoadRequest& request)
+    {
+        std::string key = std::to_string((int)request.kind) + "|" + request.path;
+        if (request.packORM)
+            key += "|" + request.occlusion + "|" + request.roughness + "|" + request.metallic;
+        std::replace(key.begin(), key.end(), '\\', '/');
+        return key;
+    }
+
+    // Decodifica una imagen codificada (PNG, JPEG...) y genera sus mips. El color se
+    // filtra en lineal y las normales se renormalizan en cada mip.
+    void decodePixels(const unsigned char* bytes, size_t size, TextureKind kind, DecodedImage& image)
+    {
+        int width, height, channels;
+        unsigned char* data = stbi_load_from_memory(bytes, (int)size, &width, &height, &channels, 0);
+        if (!data)
+            return;
+        MipOptions options;
+        options.srgb = kind == TextureKind::Color;
+        options.normalMap = kind == TextureKind::Normal;
+        image.chain = MipGenerator::build(data, width, height, channels, options);
+        stbi_image_free(data);
+    }
+
+    // Sin versión cocinada utilizable: decodifica la imagen fuente o empaqueta los mapas
+    // del ORM, leyéndolos en el hilo que llama.
+    void decodeSource(const LoadRequest& request, DecodedImage& image)
+    {
+        if (request.packORM)
+        {
+            PackedImage packed;
+            std::string error;
+            if (ChannelPacker::packORM(request.occlusion, request.roughness, request.metallic, packed, error))
+                image.chain = MipGenerator::build(packed.pixels.data(), packed.width, packed.height, packed.channels);
+            else
+                std::cout << "ERROR::TEXTURE::PACK_ORM\n" << error << std::endl;
+        }
+        else if (request.encoded)
+        {
+            decodePixels(request.encoded->data(), request.encoded->size(), request.kind, image);
+        }
+        else if (!endsWith(request.path, ".ktx2"))
+        {
+            AssetFile file;
+            if (VirtualFileSystem::open(request.path, file))
+                decodePixels(file.data(), file.size(), request.kind, image);
+        }
+    }
+
+    void finishDecode(uint64_t ticket, std::unique_ptr<DecodedImage> image)
+    {
+        image->decodeEndMs = StartupTimeline::now();
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        decoded.emplace_back(ticket, std::move(image));
+    }
+
+    void decodeJob(uint64_t ticket, const LoadRequest& request)
+    {
+        auto image = std::make_unique<DecodedImage>();
+        image->decodeStartMs = StartupTimeline::now();
+
+        // Se prefiere la versión cocinada; si no existe o el formato no está soportado
+        // se decodifican (y empaquetan) las imágenes fuente.
+        const std::string& path = request.path;
+        const bool embedded = request.encoded != nullptr;
+        const bool isCooked = !embedded && endsWith(path, ".ktx2");
+        const bool cooked = !embedded && (isCooked ? VirtualFileSystem::exists(path) && openCooked(path, *image)
+                                                   : VirtualFileSystem::exists(cookedPath(path)) && openCooked(cookedPath(path), *image));
+        if (!cooked)
+            decodeSource(request, *image);
+        finishDecode(ticket, std::move(image));
+    }
+
+    // Continuación de una lectura de AsyncIO, ya en un hilo de JobSystem.
+    void decodeRead(uint64_t ticket, const LoadRequest& request, const AssetLocation& location, bool cooked, bool ok,
+                    std::vector<unsigned char>& bytes)
+    {
+        auto image = std::make_unique<DecodedImage>();
+        image->decodeStartMs = StartupTimeline::now();
+        bool decodedRead = false;
+        if (ok && VirtualFileSystem::decode(location, bytes))
+        {
+            if (cooked)
+            {
+                image->bytes = std::move(bytes);
+                decodedRead = acceptCooked(location.file, *image);
+            }
+            else
+            {
+                decodePixels(bytes.data(), bytes.size(), request.kind, *image);
+                decodedRead = true;
+            }
+        }
+        // Una versión cocinada que no sirve (p. ej. BC1 sin S3TC) deja paso a la fuente.
+        if (!decodedRead && cooked)
+            decodeSource(request, *image);
+        finishDecode(ticket, std::move(image));
+    }
+
+    // Las imágenes que vienen de un archivo (suelto o dentro de un paquete) se leen con
+    // AsyncIO y se decodifican en su callback; así los hilos de JobSystem no se bloquean
+    // en el disco y muchas lecturas van a la vez. Devuelve 0 si la carga va por decodeJob
+    // (imágenes embebidas, ORM sin versión cocinada o archivos que no existen).
+    uint64_t readSource(uint64_t ticket, const LoadRequest& request, IOPriority priority)
+    {
+        if (request.encoded)
+            return 0;
+        const bool isCooked = endsWith(request.path, ".ktx2");
+        AssetLocation location;
+        bool cooked = VirtualFileSystem::locate(isCooked ? request.path : cookedPath(request.path), location);
+        if (!cooked && (isCooked || request.packORM || !VirtualFileSystem::locate(request.path, location)))
+            return 0;
+        return AsyncIO::read(location.file, location.offset, location.storedSize, priority,
+            [ticket, request, location, cooked](bool ok, std::vector<unsigned char>& bytes) {
+                decodeRead(ticket, request, location, cooked, ok, bytes);
+            });
+    }
+
+    // Encarga a los hilos de trabajo la carga de los mips [targetLevel, residentLevel) de
+    // una textura; en la primera carga, la imagen entera. Los mips de una recarga cuentan
+    // como residentes desde ya, para que el presupuesto no los reparta dos veces.
+    void stream(GLuint texture, TextureRecord& record, int targetLevel)
+    {
+        auto pending = std::make_unique<PendingTexture>();
+        pending->texture = texture;
+        pending->ticket = nextTicket++;
+        pending->path = record.request.path;
+        pending->restream = record.loaded;
+        pending->firstLevel = record.residentLevel - 1;
+        pending->targetLevel = targetLevel;
+        record.residentLevel = targetLevel;
+        record.streaming = true;
+
+        // Las recargas de mips liberados ceden el disco a las primeras cargas.
+        const uint64_t ticket = pending->ticket;
+        const LoadRequest request = record.request;
+        pending->ioRequest = readSource(ticket, request, pending->restream ? IOPriority::Background : IOPriority::Normal);
+        const bool reading = pending->ioRequest != 0;
+        pendingTextures.push_back(std::move(pending));
+        if (!reading)
+            JobSystem::submit([ticket, request] { decodeJob(ticket, request); });
+    }
+
+    // Devuelve la textura ya cargada para la misma petición o crea una con su texel
+    // provisional y encarga la carga.
+    GLuint submit(const LoadRequest& request)
+    {
+        const std::string key = requestKey(request);
+        auto existing = recordsByKey.find(key);
+        if (existing != recordsByKey.end())
+        {
+            records[existing->second].refs++;
+            return existing->second;
+        }
+
+        static const unsigned char placeholders[4][4] = {
+            { 255, 255, 255, 255 },
+            { 128, 128, 255, 255 },
+            { 128, 128, 128, 255 },
+            { 255, 128, 0, 255 },
+        };
+
+        GLuint texture;
+        glGenTextures(1, &texture);
+        GLState::bindTexture(0, GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholders[(int)request.kind]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        TextureRecord& record = records[texture];
+        record.key = key;
+        record.request = request;
+        record.lastUsedFrame = frameNumber;
+        recordsByKey[key] = texture;
+        stream(texture, record, 0);
+        return texture;
+    }
+
+    GLenum pixelFormat(int channels)
+    {
+        switch (channels)
+        {
+        case 1: return GL_RED;
+        case 2: return GL_RG;
+        case 3: return GL_RGB;
+        default: return GL_RGBA;
+        }
+    }
+
+    GLenum internalFormat(int channels)
+    {
+        switch (channels)
+        {
+        case 1: return GL_R8;
+        case 2: return GL_RG8;
+        case 3: return GL_RGB8;
+        default: return GL_RGBA8;
+        }
+    }
+
+    // Primera carga: la imagen fija el tamaño y los bytes de cada mip del registro.
+    void describe(TextureRecord& record, const DecodedImage& image)
+    {
+        record.compressed = image.compressed;
+        record.width = image.width();
+        record.height = image.height();
+        record.levelBytes.resize(image.levels());
+        for (int level = 0; level < image.levels(); ++level)
+            record.levelBytes[level] = image.compressed ? image.ktx.levels[level].size : image.chain.levelBytes(level);
+        if (image.compressed)
+        {
+            record.storageFormat = compressedFormat(image.ktx.format);
+            record.pixelFormat = GL_RGBA;
+        }
+        else
+        {
+            record.storageFormat = internalFormat(image.chain.channels);
+            record.pixelFormat = pixelFormat(image.chain.channels);
+        }
+    }
+
+    // Reserva los mips que se van a subir con el tamaño real; hasta que se sube el último
+    // la textura sigue muestreando lo que ya tenía (en la primera carga, el texel
+    // provisional). Los comprimidos se reservan al subir cada nivel con
+    // glCompressedTexImage2D. En una recarga solo se tocan los niveles liberados.
+    void allocateLevels(PendingTexture& pending)
+    {
+        const DecodedImage& image = *pending.image;
+        const int firstLevel = pending.restream ? pending.firstLevel : image.levels() - 1;
+        if (!image.compressed)
+        {
+            const MipChain& chain = image.chain;
+            GLState::bindTexture(0, GL_TEXTURE_2D, pending.texture);
+            for (int level = pending.targetLevel; level <= firstLevel; ++level)
+            {
+                glTexImage2D(GL_TEXTURE_2D, level, internalFormat(chain.channels), chain.levelWidth(level), chain.levelHeight(level),
+                             0, pixelFormat(chain.channels), GL_UNSIGNED_BYTE, NULL);
+            }
+        }
+        pending.level = firstLevel;
+        pending.row = 0;
+        pending.allocated = true;
+        pending.uploadStartMs = StartupTimeline::now();
+    }
+
+    // Libera el mip más detallado que tiene la textura: primero deja de muestrearse
+    // (BASE_LEVEL) y luego se redefine con tamaño 0 para que el driver suelte la memoria.
+    size_t dropLevel(GLuint texture, TextureRecord& record)
+    {
+        const int level = record.residentLevel;
+        GLState::bindTexture(0, GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+        glTexImage2D(GL_TEXTURE_2D, level, record.storageFormat, 0, 0, 0, record.pixelFormat, GL_UNSIGNED_BYTE, NULL);
+        record.residentLevel++;
+        evictedLevels++;
+        return record.levelBytes[level];
+    }
+
+    size_t totalResidentBytes()
+    {
+        size_t bytes = 0;
+        for (const auto& entry : records)
+            bytes += entry.second.residentBytes();
+        return bytes;
+    }
+
+    // Ajusta la memoria al presupuesto, una vez por frame antes de subir nada:
+    //  1. Si el total lo supera se liberan mips, de la textura menos usada a la más usada.
+    //  2. Las texturas reducidas que se han dibujado en el último frame recuperan sus mips
+    //     si caben; para hacerles sitio solo ceden mips las que llevan más de
+    //     EVICTION_GRACE_FRAMES sin dibujarse, así dos texturas en uso no se turnan la memoria.
+    void enforceBudget()
+    {
+        if (memoryBudget == 0)
+            return;
+
+        std::vector<std::pair<uint64_t, GLuint>> byAge;
+        byAge.reserve(records.size());
+        for (const auto& entry : records)
+            byAge.emplace_back(entry.second.lastUsedFrame, entry.first);
+        std::sort(byAge.begin(), byAge.end());
+
+        size_t resident = totalResidentBytes();
+        for (const auto& candidate : byAge)
+        {
+            TextureRecord& record = records[candidate.second];
+            while (resident > memoryBudget && record.canDropLevel())
+                resident -= dropLevel(candidate.second, record);
+            if (resident <= memoryBudget)
+                break;
+        }
+
+        for (auto it = byAge.rbegin(); it != byAge.rend(); ++it)
+        {
+            TextureRecord& record = records[it->second];
+            if (frameNumber - record.lastUsedFrame > 1)
+                break;
+            if (!record.loaded || record.streaming || record.failed || record.residentLevel == 0)
+                continue;
+
+            // Mip más detallado que cabe, liberando si hace falta mips de texturas frías.
+            int target = record.residentLevel;
+            size_t wanted = 0;
+            while (target > 0)
+            {
+                const size_t bytes = record.levelBytes[target - 1];
+                while (resident + wanted + bytes > memoryBudget)
+                {
+                    auto cold = std::find_if(byAge.begin(), byAge.end(), [&](const std::pair<uint64_t, GLuint>& entry) {
+                        return frameNumber - entry.first > EVICTION_GRACE_FRAMES && records[entry.second].canDropLevel();
+                    });
+                    if (cold == byAge.end())
+                        break;
+                    resident -= dropLevel(cold->second, records[cold->second]);
+                }
+                if (resident + wanted + bytes > memoryBudget)
+                    break;
+                wanted += bytes;
+                target--;
+            }
+            if (target == record.residentLevel)
+                continue;
+
+            resident += wanted;
+            restreams++;
+            stream(it->second, record, target);
+        }
+    }
+}
+
+void TextureLoader::init(size_t frameBudgetBytes, size_t memoryBudgetBytes)
+{
+    frameBudget = frameBudgetBytes;
+    memoryBudget = memoryBudgetBytes;
+    for (StagingSegment& segment : segments)
+    {
+        glGenBuffers(1, &segment.buffer);
+        GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, segment.buffer);
+        if (glExtensions.bufferStorage)
+        {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER, frameBudget, NULL, flags);
+            segment.mapped = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameBudget, flags);
+        }
+        else
+        {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, frameBudget, NULL, GL_STREAM_DRAW);
+        }
+    }
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+unsigned int TextureLoader::load(const std::string& path, TextureKind kind)
+{
+    LoadRequest request;
+    request.path = path;
+    request.kind = kind;
+    return submit(request);
+}
+
+unsigned int TextureLoader::loadORM(const std::string& cookedPath, const std::string& occlusion, const std::string& roughness,
+                                    const std::string& metallic)
+{
+    LoadRequest request;
+    request.path = cookedPath;
+    request.packORM = true;
+    request.occlusion = occlusion;
+    request.roughness = roughness;
+    request.metallic = metallic;
+    request.kind = TextureKind::ORM;
+    return submit(request);
+}
+
+unsigned int TextureLoader::loadEncoded(const std::string& key, std::shared_ptr<const std::vector<unsigned char>> bytes, TextureKind kind)
+{
+    LoadRequest request;
+    request.path = key;
+    request.encoded = std::move(bytes);
+    request.kind = kind;
+    return submit(request);
+}
+
+unsigned int TextureLoader::loadSolid(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    const unsigned char texel[4] = { r, g, b, a };
+    const std::string key = "solid|" + std::to_string(r) + "," + std::to_string(g) + "," + std::to_string(b) + "," + std::to_string(a);
+    auto existing = recordsByKey.find(key);
+    if (existing != recordsByKey.end())
+    {
+        records[existing->second].refs++;
+        return existing->second;
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    GLState::bindTexture(0, GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // Ya está completa: nunca se recarga ni pierde mips.
+    TextureRecord& record = records[texture];
+    record.key = key;
+    record.loaded = true;
+    record.lastUsedFrame = frameNumber;
+    recordsByKey[key] = texture;
+    return texture;
+}
+
+void TextureLoader::release(unsigned int texture)
+{
+    auto it = records.find(texture);
+    if (it == records.end() || --it->second.refs > 0)
+        return;
+
+    // La lectura se cancela si aún no ha terminado. Un trabajo en curso terminará
+    // igualmente; su ticket ya no está pendiente y el resultado se descarta en update().
+    pendingTextures.erase(std::remove_if(pendingTextures.begin(), pendingTextures.end(), [texture](const std::unique_ptr<PendingTexture>& pending) {
+        if (pending->texture != texture)
+            return false;
+        if (pending->ioRequest)
+            AsyncIO::cancel(pending->ioRequest);
+        return true;
+    }), pendingTextures.end());
+    recordsByKey.erase(it->second.key);
+    records.erase(it);
+    GLState::deleteTexture(texture);
+}
+
+void TextureLoader::markUsed(unsigned int texture)
+{
+    auto it = records.find(texture);
+    if (it != records.end())
+        it->second.lastUsedFrame = frameNumber;
+}
+
+void TextureLoader::update()
+{
+    frameNumber++;
+
+    // 1. Recoger lo que han terminado los hilos. Una recarga cuyo origen ya no coincide
+    // con lo que hay en la GPU se descarta.
+    {
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        for (auto& result : decoded)
+        {
+            for (auto& pending : pendingTextures)
+            {
+                if (pending->ticket != result.first)
+                    continue;
+                const DecodedImage& image = *result.second;
+                const TextureRecord& record = records[pending->texture];
+                pending->failed = !image.compressed && image.chain.pixels.empty();
+                if (pending->restream)
+                {
+                    pending->failed = pending->failed || image.compressed != record.compressed || image.levels() != record.levels() ||
+                                      image.width() != record.width || image.height() != record.height;
+                }
+                pending->image = std::move(result.second);
+                if (!pending->failed && !pending->restream)
+                    describe(records[pending->texture], *pending->image);
+                break;
+            }
+        }
+        decoded.clear();
+    }
+
+    // Las que fallan se quedan con lo que tenían: el texel provisional o los mips residentes.
+    pendingTextures.erase(std::remove_if(pendingTextures.begin(), pendingTextures.end(), [](const std::unique_ptr<PendingTexture>& pending) {
+        if (!pending->failed)
+            return false;
+        std::cout << "ERROR::TEXTURE::LOAD_FAILED\n" << "Path: " << pending->path << std::endl;
+        TextureRecord& record = records[pending->texture];
+        if (pending->restream)
+            record.residentLevel = pending->firstLevel + 1;
+        record.streaming = false;
+        record.failed = true;
+        return true;
+    }), pendingTextures.end());
+
+    enforceBudget();
+
+    if (pendingTextures.empty() || frameBudget == 0)
+        return;
+
+    // 2. El segmento de staging de este frame solo se reutiliza si la GPU ya lo ha
+    // consumido; si no, este frame solo avanzan las texturas comprimidas.
+    StagingSegment& segment = segments[frameIndex % STAGING_SEGMENTS];
+    bool stagingFree = true;
+    if (segment.fence)
+    {
+        if (glClientWaitSync(segment.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        {
+            stagingFree = false;
+        }
+        else
+        {
+            glDeleteSync(segment.fence);
+            segment.fence = nullptr;
+        }
+    }
+
+    // 3. Repartir el presupuesto, del mip más pequeño al nivel 0: franjas de filas para
+    // las texturas sin comprimir y niveles completos para las comprimidas.
+    std::vector<UploadOp> ops;
+    size_t used = 0;
+    size_t staged = 0;
+    for (auto& pendingPtr : pendingTextures)
+    {
+        PendingTexture& pending = *pendingPtr;
+        if (!pending.image || (!pending.image->compressed && !stagingFree))
+            continue;
+        const DecodedImage& image = *pending.image;
+        pending.frames++;
+
+        if (image.compressed)
+        {
+            if (!pending.allocated)
+                allocateLevels(pending);
+            while (pending.level >= pending.targetLevel)
+            {
+                const KtxLevel& level = image.ktx.levels[pending.level];
+                // Un nivel mayor que el presupuesto entero se sube solo, en un frame propio.
+                if (used > 0 && used + level.size > frameBudget)
+                    break;
+                ops.push_back({ &pending, pending.level, 0, 0, image.fileData() + level.offset, 0, level.size, true, true });
+                used += level.size;
+                pending.level--;
+            }
+        }
+        else
+        {
+            const MipChain& chain = image.chain;
+
+            // En la primera carga el mip más pequeño debe caber entero el mismo frame en que
+            // se reservan los niveles. Una recarga reserva niveles que aún no se muestrean.
+            if (!pending.allocated)
+            {
+                const size_t lastBytes = chain.levelBytes(chain.levels() - 1);
+                if (!pending.restream && ((staged + 15) & ~(size_t)15) + lastBytes > frameBudget)
+                    break;
+                allocateLevels(pending);
+            }
+
+            while (pending.level >= pending.targetLevel)
+            {
+                const int width = chain.levelWidth(pending.level);
+                const int height = chain.levelHeight(pending.level);
+                const size_t rowBytes = (size_t)width * chain.channels;
+                const size_t offset = (staged + 15) & ~(size_t)15;
+                if (offset + rowBytes > frameBudget)
+                    break;
+
+                const int rows = std::min(height - pending.row, (int)((frameBudget - offset) / rowBytes));
+                const unsigned char* source = chain.level(pending.level) + (size_t)pending.row * rowBytes;
+                ops.push_back({ &pending, pending.level, pending.row, rows, source, offset, rows * rowBytes, pending.row + rows == height, false });
+                staged = offset + rows * rowBytes;
+                used += rows * rowBytes;
+
+                pending.row += rows;
+                if (pending.row < height)
+                    break;
+                pending.level--;
+                pending.row = 0;
+            }
+        }
+        if (used >= frameBudget)
+            break;
+    }
+    if (ops.empty())
+        return;
+
+    auto completeLevel = [](const UploadOp& op) {
+        // El nivel ya tiene datos: pasa a ser el más detallado que se muestrea.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, op.level);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, op.texture->image->levels() - 1);
+    };
+
+    // 4a. Niveles comprimidos, directamente desde el archivo proyectado.
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    for (const UploadOp& op : ops)
+    {
+        if (!op.compressed)
+            continue;
+        const KtxImage& ktx = op.texture->image->ktx;
+        GLState::bindTexture(0, GL_TEXTURE_2D, op.texture->texture);
+        glCompressedTexImage2D(GL_TEXTURE_2D, op.level, compressedFormat(ktx.format), std::max(1, (int)(ktx.width >> op.level)),
+                               std::max(1, (int)(ktx.height >> op.level)), 0, (GLsizei)op.bytes, op.source);
+        completeLevel(op);
+    }
+
+    // 4b. Franjas sin comprimir: copia al staging y subida desde el PBO.
+    if (staged > 0)
+    {
+        GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, segment.buffer);
+        unsigned char* destination = segment.mapped;
+        if (!destination)
+            destination = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameBudget, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        for (const UploadOp& op : ops)
+        {
+            if (!op.compressed)
+                std::memcpy(destination + op.offset, op.source, op.bytes);
+        }
+        if (!segment.mapped)
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (const UploadOp& op : ops)
+        {
+            if (op.compressed)
+                continue;
+            const MipChain& chain = op.texture->image->chain;
+            GLState::bindTexture(0, GL_TEXTURE_2D, op.texture->texture);
+            glTexSubImage2D(GL_TEXTURE_2D, op.level, 0, op.row, chain.levelWidth(op.level), op.rows,
+                            pixelFormat(chain.channels), GL_UNSIGNED_BYTE, (void*)op.offset);
+            if (op.completesLevel)
+                completeLevel(op);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        segment.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        frameIndex++;
+    }
+
+    // 5. Las texturas con todos los mips subidos dejan de estar pendientes; las
+    // comprimidas liberan aquí su proyección.
+    const double now = StartupTimeline::now();
+    pendingTextures.erase(std::remove_if(pendingTextures.begin(), pendingTextures.end(), [now](const std::unique_ptr<PendingTexture>& pending) {
+        if (!pending->image || pending->level >= pending->targetLevel)
+            return false;
+        TextureRecord& record = records[pending->texture];
+        record.streaming = false;
+        record.loaded = true;
+        if (pending->restream)
+            return true;
+
+        const DecodedImage& image = *pending->image;
+        const std::string name = pending->path.substr(pending->path.find_last_of("/\\") + 1);
+        StartupTimeline::addSpan("decode " + name, image.decodeStartMs, image.decodeEndMs);
+        StartupTimeline::addSpan("upload " + name, pending->uploadStartMs, now);
+        std::cout << "Texture loaded successfully: " << pending->path << (image.compressed ? " (KTX2, " : " (") << image.width() << "x" << image.height()
+                  << ", decode " << (int)(image.decodeEndMs - image.decodeStartMs) << " ms, " << pending->frames << " frames)" << std::endl;
+        return true;
+    }), pendingTextures.end());
+}
+
+int TextureLoader::pending()
+{
+    return (int)pendingTextures.size();
+}
+
+TextureLoader::Stats TextureLoader::stats()
+{
+    Stats stats;
+    stats.residentBytes = totalResidentBytes();
+    stats.memoryBudget = memoryBudget;
+    stats.textures = (int)records.size();
+    for (const auto& entry : records)
+    {
+        if (entry.second.residentLevel > 0)
+            stats.reduced++;
+    }
+    stats.evictedLevels = evictedLevels;
+    stats.restreams = restreams;
+    return stats;
+}
+
+void TextureLoader::shutdown()
+{
+    for (StagingSegment& segment : segments)
+    {
+        if (segment.fence)
+            glDeleteSync(segment.fence);
+        if (segment.mapped)
+        {
+            GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, segment.buffer);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        if (segment.buffer)
+            GLState::deleteBuffer(segment.buffer);
+        segment = StagingSegment();
+    }
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    pendingTextures.clear();
+
+    for (const auto& entry : records)
+        GLState::deleteTexture(entry.first);
+    records.clear();
+    recordsByKey.clear();
+}
@@ -0,0 +1,93 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Uso de una textura: decide el color provisional mientras se carga.
+enum class TextureKind : uint8_t {
+    Color,      // blanco
+    Normal,     // normal plana (0.5, 0.5, 1)
+    Data,       // gris medio (metallic, roughness...)
+    ORM         // sin oclusión, rugosidad media, no metálico
+};
+
+// Carga asíncrona de texturas. load() devuelve en el acto un nombre de textura GL con
+// un texel provisional; AsyncIO lee el archivo (las recargas de mips con prioridad
+// baja), los hilos de JobSystem decodifican la imagen y generan sus mips
+// y update() las sube desde buffers de staging (PBO) mapeados de forma persistente, con
+// un límite de bytes por frame. Los mips se suben del más pequeño al más grande y
+// GL_TEXTURE_BASE_LEVEL baja a medida que se completan, así que la textura siempre está
+// completa y gana resolución sin que cambie su nombre.
+//
+// Si junto a la imagen existe una versión cocinada con chaos-texcook (mismo nombre con
+// extensión .ktx2) se usa esa: el archivo se proyecta en memoria en el hilo de trabajo
+// y sus niveles BCn se suben con glCompressedTexImage2D sin decodificar nada. Las rutas
+// se abren con VirtualFileSystem, así que pueden venir de un paquete de assets.
+//
+// El cargador también es dueño de las texturas: las peticiones repetidas (misma ruta y
+// mismo uso) devuelven el mismo nombre con una referencia más, y release() la borra al
+// soltar la última. Lleva la cuenta de los bytes de GPU de cada mip y, si el total pasa
+// del presupuesto, libera los mips más detallados de las texturas que llevan más tiempo
+// sin dibujarse (subiendo GL_TEXTURE_BASE_LEVEL). Cuando una textura reducida vuelve a
+// usarse y hay sitio, sus mips se vuelven a cargar por el mismo camino asíncrono.
+class TextureLoader
+{
+public:
+    struct Stats {
+        size_t residentBytes = 0;   // estimación de los mips con almacenamiento en la GPU
+        size_t memoryBudget = 0;
+        int textures = 0;
+        int reduced = 0;            // texturas con mips detallados liberados
+        int evictedLevels = 0;      // mips liberados desde el arranque
+        int restreams = 0;          // recargas de mips liberados desde el arranque
+    };
+
+    // Crea los buffers de staging. Llamar tras loadGLExtensions(), JobSystem::init() y
+    // AsyncIO::init().
+    // 'memoryBudgetBytes' es el tope de memoria de texturas (estimado, sin el relleno
+    // que añada el driver).
+    static void init(size_t frameBudgetBytes = 4 * 1024 * 1024, size_t memoryBudgetBytes = (size_t)1536 * 1024 * 1024);
+
+    static unsigned int load(const std::string& path, TextureKind kind = TextureKind::Color);
+
+    // Textura ORM (r = oclusión, g = rugosidad, b = metálico). Usa 'cookedPath' (.ktx2 de
+    // chaos-texcook --orm) si existe; si no, empaqueta al cargar los mapas de un canal.
+    // Una ruta vacía deja el canal con su valor neutro (oclusión 1, metálico 0).
+    static unsigned int loadORM(const std::string& cookedPath, const std::string& occlusion, const std::string& roughness,
+                                const std::string& metallic);
+
+    // Imagen ya en memoria (PNG, JPEG... p. ej. embebida en un .glb). 'key' la identifica
+    // para deduplicarla; el cargador conserva los bytes para poder recargar los mips que
+    // libere el presupuesto.
+    static unsigned int loadEncoded(const std::string& key, std::shared_ptr<const std::vector<unsigned char>> bytes,
+                                    TextureKind kind = TextureKind::Color);
+
+    // Textura de 1x1 con un color fijo, para materiales sin mapa (p. ej. el Kd de un
+    // .mtl). Se deduplica y se libera con release() como las demás.
+    static unsigned int loadSolid(unsigned char r, unsigned char g, unsigned char b, unsigned char a = 255);
+
+    // Suelta una referencia; con la última se borra la textura.
+    static void release(unsigned int texture);
+
+    // La textura se ha muestreado este frame (lo llama RenderQueue al enlazar materiales).
+    // Las menos usadas recientemente son las primeras en perder mips.
+    static void markUsed(unsigned int texture);
+
+    // Una vez por frame en el hilo principal: recoge las imágenes decodificadas, ajusta la
+    // memoria al presupuesto y sube como mucho frameBudgetBytes. Nunca espera a la GPU;
+    // si el buffer de staging de este frame sigue en uso, no sube nada.
+    static void update();
+
+    // Texturas que aún no tienen todos sus mips en la GPU.
+    static int pending();
+
+    static Stats stats();
+
+    // Libera los buffers de staging y las texturas. Llamar tras JobSystem::shutdown().
+    static void shutdown();
+};
+
+#endif // TEXTURE_LOADER_H
@@ -0,0 +1,251 @@
+#include "TransformArrays.h"
+#include "CpuFeatures.h"
+
+namespace
+{
+    const bool useAVX = cpuHasAVX();
+
+    // compose() espera cuaterniones unitarios; uno nulo pasa a ser la identidad.
+    glm::quat normalized(const glm::quat& rotation)
+    {
+        const float length = glm::length(rotation);
+        return length > 0.0f ? rotation / length : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    // Punteros a los arrays de cada componente, desplazados a 'begin'.
+    struct Streams {
+        const float* px;
+        const float* py;
+        const float* pz;
+        const float* rx;
+        const float* ry;
+        const float* rz;
+        const float* rw;
+        const float* sx;
+        const float* sy;
+        const float* sz;
+    };
+
+    // Rotación del cuaternión con cada columna multiplicada por su escala, y la traslación
+    // en la cuarta columna.
+    void composeScalar(const Streams& s, size_t count, glm::mat4* out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float x = s.rx[i], y = s.ry[i], z = s.rz[i], w = s.rw[i];
+            const float x2 = x + x, y2 = y + y, z2 = z + z;
+            const float xx = x * x2, yy = y * y2, zz = z * z2;
+            const float xy = x * y2, xz = x * z2, yz = y * z2;
+            const float wx = w * x2, wy = w * y2, wz = w * z2;
+
+            glm::mat4& m = out[i];
+            m[0] = glm::vec4((1.0f - (yy + zz)) * s.sx[i], (xy + wz) * s.sx[i], (xz - wy) * s.sx[i], 0.0f);
+            m[1] = glm::vec4((xy - wz) * s.sy[i], (1.0f - (xx + zz)) * s.sy[i], (yz + wx) * s.sy[i], 0.0f);
+            m[2] = glm::vec4((xz + wy) * s.sz[i], (yz - wx) * s.sz[i], (1.0f - (xx + yy)) * s.sz[i], 0.0f);
+            m[3] = glm::vec4(s.px[i], s.py[i], s.pz[i], 1.0f);
+        }
+    }
+
+#ifdef CHAOS_X86
+    // Cuatro objetos por iteración. Se calculan los 16 elementos de las cuatro matrices
+    // como 16 registros (uno por elemento, un objeto por carril) y cuatro transposiciones
+    // 4x4 los dejan como cuatro mat4 seguidas.
+    void composeSSE(const Streams& s, size_t count, glm::mat4* out)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(s.rx + i), y = _mm_loadu_ps(s.ry + i), z = _mm_loadu_ps(s.rz + i), w = _mm_loadu_ps(s.rw + i);
+            const __m128 x2 = _mm_add_ps(x, x), y2 = _mm_add_ps(y, y), z2 = _mm_add_ps(z, z);
+            const __m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+            const __m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+            const __m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+            const __m128 sx = _mm_loadu_ps(s.sx + i), sy = _mm_loadu_ps(s.sy + i), sz = _mm_loadu_ps(s.sz + i);
+
+            __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx);
+            __m128 c0y = _mm_mul_ps(_mm_add_ps(xy, wz), sx);
+            __m128 c0z = _mm_mul_ps(_mm_sub_ps(xz, wy), sx);
+            __m128 c0w = zero;
+            __m128 c1x = _mm_mul_ps(_mm_sub_ps(xy, wz), sy);
+            __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy);
+            __m128 c1z = _mm_mul_ps(_mm_add_ps(yz, wx), sy);
+            __m128 c1w = zero;
+            __m128 c2x = _mm_mul_ps(_mm_add_ps(xz, wy), sz);
+            __m128 c2y = _mm_mul_ps(_mm_sub_ps(yz, wx), sz);
+            __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz);
+            __m128 c2w = zero;
+            __m128 c3x = _mm_loadu_ps(s.px + i);
+            __m128 c3y = _mm_loadu_ps(s.py + i);
+            __m128 c3z = _mm_loadu_ps(s.pz + i);
+            __m128 c3w = one;
+            _MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+            _MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+            _MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+            _MM_TRANSPOSE4_PS(c3x, c3y, c3z, c3w);
+
+            // Tras transponer, el registro k de cada columna es esa columna del objeto k.
+            const __m128 columns[4][4] = { { c0x, c0y, c0z, c0w }, { c1x, c1y, c1z, c1w }, { c2x, c2y, c2z, c2w }, { c3x, c3y, c3z, c3w } };
+            for (int k = 0; k < 4; ++k)
+            {
+                float* matrix = &out[i + k][0][0];
+                for (int column = 0; column < 4; ++column)
+                    _mm_storeu_ps(matrix + 4 * column, columns[column][k]);
+            }
+        }
+        Streams rest = { s.px + i, s.py + i, s.pz + i, s.rx + i, s.ry + i, s.rz + i, s.rw + i, s.sx + i, s.sy + i, s.sz + i };
+        composeScalar(rest, count - i, out + i);
+    }
+
+    // Transpone 8x8: el registro k de salida tiene el carril k de cada registro de entrada.
+    CHAOS_TARGET_AVX void transpose8(__m256 r[8])
+    {
+        const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]), t1 = _mm256_unpackhi_ps(r[0], r[1]);
+        const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]), t3 = _mm256_unpackhi_ps(r[2], r[3]);
+        const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]), t5 = _mm256_unpackhi_ps(r[4], r[5]);
+        const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]), t7 = _mm256_unpackhi_ps(r[6], r[7]);
+        const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+        r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+        r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+        r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+        r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+        r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+        r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+        r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+        r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+    }
+
+    // Ocho objetos por iteración: los 16 elementos en 16 registros y dos transposiciones
+    // 8x8, una por cada mitad (columnas 0-1 y 2-3) de las ocho matrices.
+    CHAOS_TARGET_AVX void composeAVX(const Streams& s, size_t count, glm::mat4* out)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 zero = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(s.rx + i), y = _mm256_loadu_ps(s.ry + i), z = _mm256_loadu_ps(s.rz + i), w = _mm256_loadu_ps(s.rw + i);
+            const __m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+            const __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+            const __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+            const __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+            const __m256 sx = _mm256_loadu_ps(s.sx + i), sy = _mm256_loadu_ps(s.sy + i), sz = _mm256_loadu_ps(s.sz + i);
+
+            __m256 low[8] = {
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+                _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+                _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx),
+                zero,
+                _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+                _mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+                zero,
+            };
+            __m256 high[8] = {
+                _mm256_mul_ps(_mm256_add_ps(xz, wy), sz),
+                _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+                zero,
+                _mm256_loadu_ps(s.px + i),
+                _mm256_loadu_ps(s.py + i),
+                _mm256_loadu_ps(s.pz + i),
+                one,
+            };
+            transpose8(low);
+            transpose8(high);
+            for (int k = 0; k < 8; ++k)
+            {
+                float* matrix = &out[i + k][0][0];
+                _mm256_storeu_ps(matrix, low[k]);
+                _mm256_storeu_ps(matrix + 8, high[k]);
+            }
+        }
+        Streams rest = { s.px + i, s.py + i, s.pz + i, s.rx + i, s.ry + i, s.rz + i, s.rw + i, s.sx + i, s.sy + i, s.sz + i };
+        composeSSE(rest, count - i, out + i);
+    }
+#endif
+}
+
+void TransformArrays::push(const Transform& transform)
+{
+    for (auto& stream : streams)
+        stream.push_back(0.0f);
+    set(size() - 1, transform);
+}
+
+void TransformArrays::set(size_t index, const Transform& transform)
+{
+    const glm::quat rotation = normalized(transform.rotation);
+    streams[PositionX][index] = transform.position.x;
+    streams[PositionY][index] = transform.position.y;
+    streams[PositionZ][index] = transform.position.z;
+    streams[RotationX][index] = rotation.x;
+    streams[RotationY][index] = rotation.y;
+    streams[RotationZ][index] = rotation.z;
+    streams[RotationW][index] = rotation.w;
+    streams[ScaleX][index] = transform.scale.x;
+    streams[ScaleY][index] = transform.scale.y;
+    streams[ScaleZ][index] = transform.scale.z;
+}
+
+Transform TransformArrays::get(size_t index) const
+{
+    Transform transform;
+    transform.position = glm::vec3(streams[PositionX][index], streams[PositionY][index], streams[PositionZ][index]);
+    transform.rotation = glm::quat(streams[RotationW][index], streams[RotationX][index], streams[RotationY][index], streams[RotationZ][index]);
+    transform.scale = glm::vec3(streams[ScaleX][index], streams[ScaleY][index], streams[ScaleZ][index]);
+    return transform;
+}
+
+void TransformArrays::copy(size_t from, size_t to)
+{
+    for (auto& stream : streams)
+        stream[to] = stream[from];
+}
+
+void TransformArrays::resize(size_t count)
+{
+    for (auto& stream : streams)
+        stream.resize(count);
+}
+
+void TransformArrays::permute(const std::vector<uint32_t>& order)
+{
+    for (auto& stream : streams)
+    {
+        std::vector<float, AlignedAllocator<float, 32>> sorted(stream.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            sorted[i] = stream[order[i]];
+        stream.swap(sorted);
+    }
+}
+
+void TransformArrays::compose(size_t begin, size_t end, glm::mat4* out) const
+{
+    const Streams s = {
+        streams[PositionX].data() + begin, streams[PositionY].data() + begin, streams[PositionZ].data() + begin,
+        streams[RotationX].data() + begin, streams[RotationY].data() + begin, streams[RotationZ].data() + begin, streams[RotationW].data() + begin,
+        streams[ScaleX].data() + begin, streams[ScaleY].data() + begin, streams[ScaleZ].data() + begin,
+    };
+#ifdef CHAOS_X86
+    if (useAVX)
+        composeAVX(s, end - begin, out);
+    else
+        composeSSE(s, end - begin, out);
+#else
+    composeScalar(s, end - begin, out);
+#endif
+}
+
+const char* TransformArrays::kernelName()
+{
+#ifdef CHAOS_X86
+    return useAVX ? "AVX" : "SSE";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,57 @@
+#ifndef TRANSFORM_ARRAYS_H
+#define TRANSFORM_ARRAYS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "AlignedAllocator.h"
+
+// Transformación local de un nodo: translate * rotate * scale.
+struct Transform {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+// Transformaciones en estructura de arrays: cada componente (x, y, z de la posición,
+// x, y, z, w del cuaternión y x, y, z de la escala) va en su propio array alineado a 32
+// bytes. compose() carga así 8 objetos por registro (4 con SSE) sin reordenar nada, y un
+// recorrido que solo lee posiciones no arrastra rotaciones ni escalas por la caché.
+class TransformArrays
+{
+public:
+    size_t size() const { return streams[0].size(); }
+
+    void push(const Transform& transform);
+    void set(size_t index, const Transform& transform);
+    Transform get(size_t index) const;
+
+    // Copia el elemento 'from' sobre 'to' (para compactar).
+    void copy(size_t from, size_t to);
+    void resize(size_t count);
+
+    // Deja en la posición i el elemento que estaba en order[i].
+    void permute(const std::vector<uint32_t>& order);
+
+    // Matrices de [begin, end) en out[0 .. end - begin). Bloques de 8 con AVX (de 4 con
+    // SSE); el resto, uno a uno.
+    void compose(size_t begin, size_t end, glm::mat4* out) const;
+
+    // Kernel en uso ("AVX", "SSE" o "scalar"), para las estadísticas de los benchmarks.
+    static const char* kernelName();
+
+private:
+    enum Stream {
+        PositionX, PositionY, PositionZ,
+        RotationX, RotationY, RotationZ, RotationW,
+        ScaleX, ScaleY, ScaleZ,
+        StreamCount
+    };
+    std::vector<float, AlignedAllocator<float, 32>> streams[StreamCount];
+};
+
+#endif // TRANSFORM_ARRAYS_H
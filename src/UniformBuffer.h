@@ -0,0 +1,84 @@
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <cstddef>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GLState.h"
+
+// Puntos de enlace fijos de los bloques uniform compartidos por todos los programas.
+// Shader enlaza cada bloque por nombre a su punto al terminar el enlace.
+enum UniformBlockBinding : GLuint {
+    FRAME_DATA_BINDING = 0,
+    LIGHT_DATA_BINDING = 1
+};
+
+// Debe coincidir con MAX_LIGHTS en los shaders que declaran LightData. GL 3.3 garantiza
+// bloques uniform de 16 KB: la cabecera (16 bytes) y 255 luces de 64 bytes caben justas.
+const int MAX_LIGHTS = 255;
+
+// Espejo en C++ del bloque "FrameData" (layout std140).
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 viewPos;      // w sin usar (std140 alinea vec3 a 16 bytes)
+};
+
+// Una luz tal como la lee el shader: cuatro vec4 para que el array no tenga relleno std140.
+struct PackedLight {
+    glm::vec4 position;     // xyz en mundo, w alcance (0 = sin límite)
+    glm::vec4 direction;    // xyz hacia donde apunta (foco y direccional), w LightType
+    glm::vec4 color;        // rgb color por intensidad, w 1 si proyecta sombras
+    glm::vec4 cone;         // x coseno del cono interior, y del exterior (foco)
+};
+
+// Espejo en C++ del bloque "LightData" (layout std140). La cuenta va delante para que
+// cada frame solo se suban las luces en uso (ver UniformBuffer::update(data, size)).
+struct LightData {
+    int count;
+    int padding[3];
+    PackedLight lights[MAX_LIGHTS];
+
+    GLsizeiptr usedSize() const { return (GLsizeiptr)(offsetof(LightData, lights) + count * sizeof(PackedLight)); }
+};
+
+// Buffer de uniforms enlazado a un punto fijo. Se actualiza una vez por frame y
+// todos los programas que declaran el bloque lo leen sin subidas por objeto.
+class UniformBuffer
+{
+public:
+    unsigned int ID = 0;
+
+    void create(GLsizeiptr size, GLuint binding)
+    {
+        glGenBuffers(1, &ID);
+        GLState::bindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+        GLState::bindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+    }
+
+    template <typename T>
+    void update(const T& data)
+    {
+        static_assert(sizeof(T) % 16 == 0, "std140 exige bloques múltiplos de 16 bytes");
+        GLState::bindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)sizeof(T), &data);
+    }
+
+    // Solo los primeros 'size' bytes; el resto del bloque conserva lo que tuviera.
+    void update(const void* data, GLsizeiptr size)
+    {
+        GLState::bindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+    }
+
+    void Delete()
+    {
+        GLState::deleteBuffer(ID);
+        ID = 0;
+    }
+};
+
+#endif // UNIFORM_BUFFER_H
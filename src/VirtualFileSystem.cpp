@@ -0,0 +1,172 @@
+#include "VirtualFileSystem.h"
+#include "AssetPack.h"
+#include "Lz4.h"
+
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <system_error>
+
+namespace
+{
+    struct MountedPack {
+        std::string path;
+        MappedFile file;
+        AssetPackView view;
+    };
+
+    // En orden de montaje; se busca del último al primero. Van en unique_ptr porque los
+    // AssetFile guardan un puntero al MappedFile de su paquete.
+    std::vector<std::unique_ptr<MountedPack>> packs;
+}
+
+void AssetFile::prefetch() const
+{
+    if (pack)
+        pack->prefetch((size_t)(bytes - pack->data()), length);
+    else if (file.isOpen())
+        file.prefetch(0, length);
+}
+
+void AssetFile::close()
+{
+    file.close();
+    buffer = std::vector<unsigned char>();
+    pack = nullptr;
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+}
+
+bool VirtualFileSystem::mount(const std::string& packPath)
+{
+    auto pack = std::make_unique<MountedPack>();
+    pack->path = packPath;
+    if (!pack->file.open(packPath))
+        return false;
+    std::string error;
+    if (!AssetPack::parse(pack->file.data(), pack->file.size(), pack->view, error))
+    {
+        std::cerr << "ERROR::VFS::INVALID_PACK\n" << "Path: " << packPath << " (" << error << ")" << std::endl;
+        return false;
+    }
+    // La tabla se recorre en cada búsqueda: que esté en memoria desde ya.
+    pack->file.prefetch(0, pack->view.header->names + pack->view.header->namesSize);
+    packs.push_back(std::move(pack));
+    return true;
+}
+
+void VirtualFileSystem::unmountAll()
+{
+    packs.clear();
+}
+
+bool VirtualFileSystem::exists(const std::string& path)
+{
+    const std::string normalized = AssetPack::normalizePath(path);
+    for (const auto& pack : packs)
+    {
+        if (AssetPack::find(pack->view, normalized))
+            return true;
+    }
+    std::error_code error;
+    return std::filesystem::is_regular_file(path, error);
+}
+
+bool VirtualFileSystem::open(const std::string& path, AssetFile& file)
+{
+    file.close();
+    const std::string normalized = AssetPack::normalizePath(path);
+    for (auto it = packs.rbegin(); it != packs.rend(); ++it)
+    {
+        const MountedPack& pack = **it;
+        const AssetPackEntry* entry = AssetPack::find(pack.view, normalized);
+        if (!entry)
+            continue;
+
+        const unsigned char* stored = pack.view.data + entry->offset;
+        if (entry->compression == (uint32_t)PackCompression::Store)
+        {
+            file.bytes = stored;
+            file.pack = &pack.file;
+        }
+        else
+        {
+            file.buffer.resize(entry->size);
+            if (!Lz4::decompress(stored, entry->storedSize, file.buffer.data(), file.buffer.size()))
+            {
+                std::cerr << "ERROR::VFS::CORRUPT_ENTRY\n" << "Path: " << path << " in " << pack.path << std::endl;
+                file.close();
+                return false;
+            }
+            file.bytes = file.buffer.data();
+        }
+        file.length = entry->size;
+        file.opened = true;
+        return true;
+    }
+
+    // Archivo suelto, como en desarrollo.
+    if (!file.file.open(path))
+        return false;
+    file.bytes = file.file.data();
+    file.length = file.file.size();
+    file.opened = true;
+    return true;
+}
+
+bool VirtualFileSystem::locate(const std::string& path, AssetLocation& location)
+{
+    const std::string normalized = AssetPack::normalizePath(path);
+    for (auto it = packs.rbegin(); it != packs.rend(); ++it)
+    {
+        const AssetPackEntry* entry = AssetPack::find((*it)->view, normalized);
+        if (!entry)
+            continue;
+        location.file = (*it)->path;
+        location.offset = entry->offset;
+        location.storedSize = entry->storedSize;
+        location.size = entry->size;
+        location.compressed = entry->compression != (uint32_t)PackCompression::Store;
+        return true;
+    }
+
+    std::error_code error;
+    const uintmax_t size = std::filesystem::file_size(path, error);
+    if (error)
+        return false;
+    location.file = path;
+    location.offset = 0;
+    location.storedSize = location.size = size;
+    location.compressed = false;
+    return true;
+}
+
+bool VirtualFileSystem::decode(const AssetLocation& location, std::vector<unsigned char>& bytes)
+{
+    if (!location.compressed)
+        return bytes.size() == location.size;
+    std::vector<unsigned char> decompressed(location.size);
+    if (!Lz4::decompress(bytes.data(), bytes.size(), decompressed.data(), decompressed.size()))
+        return false;
+    bytes = std::move(decompressed);
+    return true;
+}
+
+bool VirtualFileSystem::read(const std::string& path, std::vector<unsigned char>& bytes)
+{
+    AssetFile file;
+    if (!open(path, file))
+        return false;
+    bytes.assign(file.data(), file.data() + file.size());
+    return true;
+}
+
+bool VirtualFileSystem::read(const std::string& path, std::string& text)
+{
+    AssetFile file;
+    if (!open(path, file))
+        return false;
+    text.assign(reinterpret_cast<const char*>(file.data()), file.size());
+    return true;
+}
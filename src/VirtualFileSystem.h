@@ -0,0 +1,85 @@
+#ifndef VIRTUAL_FILE_SYSTEM_H
+#define VIRTUAL_FILE_SYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+// Contenido de un asset abierto con VirtualFileSystem. Si está guardado sin comprimir
+// (en un paquete o como archivo suelto) es una vista de la proyección en memoria, sin
+// copia; si estaba comprimido, un buffer propio con el resultado de descomprimirlo.
+class AssetFile
+{
+public:
+    AssetFile() = default;
+    AssetFile(AssetFile&&) = default;
+    AssetFile& operator=(AssetFile&&) = default;
+
+    bool isOpen() const { return opened; }
+    const unsigned char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+    // true si los bytes se leen directamente de la proyección del paquete o del archivo.
+    bool mapped() const { return opened && buffer.empty() && length > 0; }
+
+    // Igual que MappedFile::prefetch sobre el rango del asset.
+    void prefetch() const;
+
+    void close();
+
+private:
+    friend class VirtualFileSystem;
+
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
+    bool opened = false;
+    MappedFile file;                        // archivo suelto
+    const MappedFile* pack = nullptr;       // paquete del que sale una entrada sin comprimir
+    std::vector<unsigned char> buffer;      // entrada descomprimida
+};
+
+// Dónde están los bytes de un asset, para leerlos por otro camino (p. ej. AsyncIO): el
+// paquete o el archivo suelto, el rango guardado y cómo dejarlo como el original.
+struct AssetLocation {
+    std::string file;
+    uint64_t offset = 0;
+    uint64_t storedSize = 0;
+    uint64_t size = 0;
+    bool compressed = false;
+};
+
+// Sistema de archivos de los assets. Las rutas son las de siempre, relativas al
+// directorio de trabajo ("assets/shaders/basic.vert"): se buscan primero en los paquetes
+// montados (.pak de chaos-pack, ver AssetPack.h) y, si no están, en el disco, así que en
+// desarrollo todo sigue funcionando sin paquetes.
+//
+// mount() debe llamarse antes de empezar a cargar assets; después, las búsquedas son de
+// solo lectura y se pueden hacer desde cualquier hilo.
+class VirtualFileSystem
+{
+public:
+    // Proyecta y valida un paquete. Los montados después tienen prioridad.
+    static bool mount(const std::string& packPath);
+    static void unmountAll();
+
+    static bool exists(const std::string& path);
+
+    // Abre el asset entero; descomprime en el hilo que llama si hace falta.
+    static bool open(const std::string& path, AssetFile& file);
+
+    // Localiza el asset sin leerlo. De un archivo suelto solo consulta su tamaño.
+    static bool locate(const std::string& path, AssetLocation& location);
+
+    // Convierte los bytes guardados en 'location' (leídos por quien llama) en el contenido
+    // del asset, descomprimiendo si hace falta.
+    static bool decode(const AssetLocation& location, std::vector<unsigned char>& bytes);
+
+    // Copia el contenido del asset.
+    static bool read(const std::string& path, std::vector<unsigned char>& bytes);
+    static bool read(const std::string& path, std::string& text);
+};
+
+#endif // VIRTUAL_FILE_SYSTEM_H
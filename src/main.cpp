@@ -1,10 +1,14 @@
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
 #include <iostream>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
@@ -13,8 +17,27 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Shader.h"
+#include "ShaderLibrary.h"
+#include "ShaderCache.h"
+#include "ShaderCompiler.h"
+#include "StartupTimeline.h"
+#include "GLExtensions.h"
 #include "Camera.h"
-#include "GameObject.h"
+#include "EntityWorld.h"
+#include "Components.h"
+#include "UniformBuffer.h"
+#include "RenderQueue.h"
+#include "MeshBuilder.h"
+#include "Mesh.h"
+#include "GLState.h"
+#include "JobSystem.h"
+#include "AsyncIO.h"
+#include "TextureLoader.h"
+#include "ObjImporter.h"
+#include "GltfImporter.h"
+#include "CMeshFile.h"
+#include "MappedFile.h"
+#include "VirtualFileSystem.h"
 
 // Prototipos
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -22,8 +45,11 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow* window);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
-unsigned int loadTexture(const char* path);
 void DrawUI(Shader& uiShader, unsigned int uiVAO, unsigned int uiVBO);
+void drop_callback(GLFWwindow* window, int count, const char** paths);
+Shader& selectPbrShader(ShaderLibrary& shaders, const Material& material, VertexFormat format = VertexFormat::Compact);
+void requestModelImport(const std::string& path);
+void spawnImportedModels(RenderQueue& renderQueue);
 
 // --- Configuración ---
 int scr_width = 1280;
@@ -44,14 +70,53 @@ struct UIState {
 } uiState;
 
 // --- Gestión de la Escena ---
-std::vector<GameObject> sceneObjects;
-int selectedObjectIndex = -1;
-float lightIntensity = 150.0f;
-unsigned int nextId = 0;
-
-int main()
+// Las entidades y sus componentes viven en 'scene'; las transformaciones, en el grafo
+// de escena, al que apunta el TransformComponent de cada entidad.
+SceneGraph sceneGraph;
+EntityWorld scene;
+Entity selectedEntity = NO_ENTITY;
+
+// --- Importación de modelos ---
+// Los .obj, .gltf, .glb y .cmesh (arrastrados a la ventana o pasados por línea de
+// comandos) se importan en los hilos de trabajo; el hilo principal sube las mallas y
+// crea los objetos cuando el resultado está listo.
+enum class ModelFormat {
+    Obj,
+    Gltf,
+    CMesh
+};
+
+struct ModelImport {
+    std::string path;
+    ModelFormat format = ModelFormat::Obj;
+    ObjModel model;
+    GltfModel gltf;
+    MappedFile cmeshFile;
+    CMeshView cmesh;
+    std::string error;
+    bool ok = false;
+    double ms = 0.0;
+};
+std::mutex importMutex;
+std::vector<std::unique_ptr<ModelImport>> finishedImports;
+std::vector<Mesh> importedMeshes;
+std::vector<unsigned int> importedTextures;
+std::vector<unsigned int> importedBuffers;  // buffers de glTF y .cmesh compartidos por varias mallas
+
+// LODs de las mallas de un .cmesh, por el id de su LOD 0 en la cola de render. Se dibuja
+// el LOD más simple cuyo error proyectado no pasa de LOD_PIXEL_ERROR píxeles.
+struct MeshLods {
+    std::vector<uint16_t> meshes;
+    std::vector<float> errors;
+    glm::vec3 center;
+};
+std::unordered_map<int, MeshLods> meshLods;
+const float LOD_PIXEL_ERROR = 1.0f;
+
+int main(int argc, char** argv)
 {
     // --- Inicialización ---
+    StartupTimeline::begin("window + context");
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -63,81 +128,63 @@ int main()
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetDropCallback(window, drop_callback);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cerr << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
-
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_STENCIL_TEST);
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+    ShaderCache::init();
+    ShaderCompiler::init();
+    JobSystem::init();
+    AsyncIO::init();
+    std::cout << "AsyncIO: " << AsyncIO::backendName() << std::endl;
+    TextureLoader::init();
+    // Con el paquete de la build (CHAOS_PACK_ASSETS) los assets salen de un solo archivo;
+    // sin él se leen sueltos de la carpeta assets/.
+    if (VirtualFileSystem::mount("assets.pak"))
+        std::cout << "Assets: assets.pak" << std::endl;
+    StartupTimeline::end("window + context");
+
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_STENCIL_TEST);
 
     // --- Shaders ---
-    Shader pbrShader("assets/shaders/basic.vert", "assets/shaders/basic.frag");
+    // Solo se envía la compilación; el driver trabaja mientras se preparan la geometría
+    // y las texturas, y cada programa bloquea únicamente en su primer uso.
+    StartupTimeline::begin("shader submit");
+    // Permutaciones PBR: se adelantan las de textura ORM, con y sin normal map; el resto
+    // se compila bajo demanda. El número de luces no cambia de permutación: el shader
+    // recorre las que haya en LightData.
+    ShaderLibrary shaderLibrary;
+    shaderLibrary.get("assets/shaders/basic.vert", "assets/shaders/basic.frag", ShaderDefines().set("NORMAL_MAP").set("ORM_MAP"));
+    shaderLibrary.get("assets/shaders/basic.vert", "assets/shaders/basic.frag", ShaderDefines().set("ORM_MAP"));
     Shader lightCubeShader("assets/shaders/light_cube.vert", "assets/shaders/light_cube.frag");
     Shader gridShader("assets/shaders/grid.vert", "assets/shaders/grid.frag");
     Shader uiShader("assets/shaders/ui.vert", "assets/shaders/ui.frag");
     Shader highlightShader("assets/shaders/highlight.vert", "assets/shaders/highlight.frag");
     Shader pickingShader("assets/shaders/picking.vert", "assets/shaders/picking.frag");
-
-
-    // --- Geometría y VAOs (Cubo) ---
-    float cube_vertices[] = {
-        // positions          // normals           // texcoords  // tangent
-        -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-         0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-         0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-         0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-        -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-        -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-        -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f, -1.0f,  0.0f,  0.0f,
-         0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f,  0.0f,
-         0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f, -1.0f,  0.0f,  0.0f,
-         0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f, -1.0f,  0.0f,  0.0f,
-        -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 1.0f, -1.0f,  0.0f,  0.0f,
-        -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f, 0.0f, -1.0f,  0.0f,  0.0f,
-        -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,  0.0f,  0.0f,  1.0f,
-        -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 1.0f,  0.0f,  0.0f,  1.0f,
-        -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,  0.0f,  0.0f,  1.0f,
-        -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f, 0.0f,  0.0f,  0.0f,  1.0f,
-        -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 0.0f,  0.0f,  0.0f,  1.0f,
-        -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f, 1.0f,  0.0f,  0.0f,  1.0f,
-         0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,  0.0f,  0.0f, -1.0f,
-         0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f,  0.0f,  0.0f, -1.0f,
-         0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,  0.0f,  0.0f, -1.0f,
-         0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f,  0.0f,  0.0f, -1.0f,
-         0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 0.0f,  0.0f,  0.0f, -1.0f,
-         0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f, 1.0f,  0.0f,  0.0f, -1.0f,
-        -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-         0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-         0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-         0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-        -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-        -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-        -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-         0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-         0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-         0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-        -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-        -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,  1.0f,  0.0f,  0.0f
-    };
-    unsigned int VBO, cubeVAO;
-    glGenVertexArrays(1, &cubeVAO);
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cube_vertices), cube_vertices, GL_STATIC_DRAW);
-    glBindVertexArray(cubeVAO);
-    size_t stride = 11 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)(8 * sizeof(float)));
-    glEnableVertexAttribArray(3);
+    StartupTimeline::end("shader submit");
+
+    // --- Bloques uniform compartidos (vista/proyección y luces) ---
+    // Se suben una vez por frame; por objeto solo queda la matriz model.
+    UniformBuffer frameUBO, lightUBO;
+    frameUBO.create(sizeof(FrameData), FRAME_DATA_BINDING);
+    lightUBO.create(sizeof(LightData), LIGHT_DATA_BINDING);
+    FrameData frameData = {};
+    LightData lightData = {};
+
+    // --- Geometría de las formas básicas ---
+    // Todas pasan por MeshBuilder: vértices soldados, índices de 16 bits y orden
+    // optimizado para la caché de vértices.
+    Mesh shapeMeshes[(int)ShapeType::Count];
+    shapeMeshes[(int)ShapeType::Cube] = uploadMesh(MeshBuilder::cube());
+    shapeMeshes[(int)ShapeType::Sphere] = uploadMesh(MeshBuilder::sphere());
+    shapeMeshes[(int)ShapeType::Cylinder] = uploadMesh(MeshBuilder::cylinder());
+    shapeMeshes[(int)ShapeType::Plane] = uploadMesh(MeshBuilder::plane());
 
     // --- Geometría para la Grid ---
     unsigned int gridVAO, gridVBO;
@@ -151,8 +198,8 @@ int main()
         gridVertices.push_back((float)-gridSize); gridVertices.push_back(0.0f); gridVertices.push_back((float)i);
         gridVertices.push_back((float)gridSize); gridVertices.push_back(0.0f); gridVertices.push_back((float)i);
     }
-    glBindVertexArray(gridVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, gridVBO);
+    GLState::bindVertexArray(gridVAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, gridVBO);
     glBufferData(GL_ARRAY_BUFFER, gridVertices.size() * sizeof(float), &gridVertices[0], GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -161,32 +208,59 @@ int main()
     unsigned int uiVAO, uiVBO;
     glGenVertexArrays(1, &uiVAO);
     glGenBuffers(1, &uiVBO);
-    glBindVertexArray(uiVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, uiVBO);
+    GLState::bindVertexArray(uiVAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, uiVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 2, NULL, GL_DYNAMIC_DRAW);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
 
     // --- Carga de Texturas PBR ---
-    unsigned int albedoMap = loadTexture("assets/textures/albedo.png");
-    unsigned int normalMap = loadTexture("assets/textures/normal.png");
-    unsigned int metallicMap = loadTexture("assets/textures/metallic.png");
-    unsigned int roughnessMap = loadTexture("assets/textures/roughness.png");
-
-    pbrShader.use();
-    pbrShader.setInt("albedoMap", 0);
-    pbrShader.setInt("normalMap", 1);
-    pbrShader.setInt("metallicMap", 2);
-    pbrShader.setInt("roughnessMap", 3);
+    // Se decodifican en los hilos de trabajo; hasta que llegan, cada textura muestra su
+    // color provisional y luego gana mips frame a frame.
+    StartupTimeline::begin("texture submit");
+    unsigned int albedoMap = TextureLoader::load("assets/textures/albedo.png", TextureKind::Color);
+    unsigned int normalMap = TextureLoader::load("assets/textures/normal.png", TextureKind::Normal);
+    // Oclusión, rugosidad y metálico van empaquetados en una sola textura ORM: una lectura
+    // por fragmento en lugar de dos. Cocinada (chaos-texcook --orm) es un BC1 que ocupa la
+    // mitad que dos BC4; si no existe, se empaqueta al cargar.
+    unsigned int ormMap = TextureLoader::loadORM("assets/textures/orm.ktx2", "", "assets/textures/roughness.png",
+                                                 "assets/textures/metallic.png");
+    StartupTimeline::end("texture submit");
+    ShaderCompiler::poll();
+
+    // --- Cola de render ---
+    RenderQueue renderQueue;
+    uint16_t shapeMeshIds[(int)ShapeType::Count];
+    for (int shape = 0; shape < (int)ShapeType::Count; ++shape)
+        shapeMeshIds[shape] = renderQueue.addMesh(shapeMeshes[shape]);
+
+    Material pbrMaterial;
+    pbrMaterial.textures[ALBEDO_UNIT] = albedoMap;
+    pbrMaterial.textures[NORMAL_UNIT] = normalMap;
+    pbrMaterial.textures[ORM_UNIT] = ormMap;
+    pbrMaterial.layout = MaterialLayout::PackedORM;
+    const uint16_t pbrMaterialId = renderQueue.addMaterial(pbrMaterial);
+    const uint16_t unlitMaterialId = renderQueue.addMaterial(Material());
+    const uint16_t lightCubeShaderId = renderQueue.shaderId(lightCubeShader);
 
     // --- Gestión de la Escena ---
-    sceneObjects.emplace_back(nextId++, "Luz Principal", ShapeType::Cube);
-    sceneObjects[0].transform.position = glm::vec3(0.0f, 5.0f, 5.0f);
-    sceneObjects.emplace_back(nextId++, "Cubo 1", ShapeType::Cube);
-    sceneObjects[1].transform.position = glm::vec3(0.0f, 0.5f, 0.0f);
+    Transform lightTransform;
+    lightTransform.position = glm::vec3(0.0f, 5.0f, 5.0f);
+    scene.create(Name{ "Luz Principal" }, TransformComponent{ sceneGraph.create(lightTransform) }, Light());
+    Transform cubeTransform;
+    cubeTransform.position = glm::vec3(0.0f, 0.5f, 0.0f);
+    scene.create(Name{ "Cubo 1" }, TransformComponent{ sceneGraph.create(cubeTransform) },
+                 MeshRenderer{ shapeMeshIds[(int)ShapeType::Cube], pbrMaterialId });
+    for (int i = 1; i < argc; ++i)
+        requestModelImport(argv[i]);
 
     // --- Bucle de Renderizado ---
+    bool firstFrame = true;
+    bool timelineReported = false;
+    float lastStatsTime = 0.0f;
+    int framesSinceStats = 0;
+    StartupTimeline::begin("first frame");
     while (!glfwWindowShouldClose(window))
     {
         float currentFrame = static_cast<float>(glfwGetTime());
@@ -194,85 +268,162 @@ int main()
         lastFrame = currentFrame;
 
         processInput(window);
+        TextureLoader::update();
+        spawnImportedModels(renderQueue);
+        // Solo recalcula las matrices de los nodos movidos y de sus subárboles.
+        sceneGraph.update();
 
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // --- 1. RENDERIZAR LA ESCENA 3D ---
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)scr_width / (float)scr_height, 0.1f, 100.0f);
+        const float farPlane = 100.0f;
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)scr_width / (float)scr_height, 0.1f, farPlane);
         glm::mat4 view = camera.GetViewMatrix();
 
+        frameData.view = view;
+        frameData.projection = projection;
+        frameData.viewPos = glm::vec4(camera.Position, 1.0f);
+        frameUBO.update(frameData);
+
+        // Sistema de luces: solo recorre los bloques de entidades con Light y las empaqueta
+        // seguidas en LightData; se suben únicamente las que hay.
+        lightData.count = 0;
+        scene.each<TransformComponent, Light>([&](Entity, const TransformComponent& transform, const Light& light) {
+            if (lightData.count == MAX_LIGHTS)
+                return;
+            const glm::mat4& world = sceneGraph.world(transform.node);
+            PackedLight& packed = lightData.lights[lightData.count++];
+            packed.position = glm::vec4(glm::vec3(world[3]), light.range);
+            // Un nodo con escala nula no tiene eje z: se apunta hacia -z como sin transformar.
+            const glm::vec3 axis = glm::vec3(world[2]);
+            const float axisLength2 = glm::dot(axis, axis);
+            const glm::vec3 direction = axisLength2 > 1e-20f ? -axis / std::sqrt(axisLength2) : glm::vec3(0.0f, 0.0f, -1.0f);
+            packed.direction = glm::vec4(direction, (float)light.type);
+            packed.color = glm::vec4(light.color * light.intensity, light.castShadows ? 1.0f : 0.0f);
+            packed.cone = glm::vec4(std::cos(light.innerCone), std::cos(light.outerCone), 0.0f, 0.0f);
+        });
+        lightUBO.update(&lightData, lightData.usedSize());
+
         // Dibujar la grid
         gridShader.use();
-        gridShader.setMat4("view", view);
-        gridShader.setMat4("projection", projection);
-        glBindVertexArray(gridVAO);
+        GLState::bindVertexArray(gridVAO);
         glDrawArrays(GL_LINES, 0, gridVertices.size() / 3);
 
-        // Dibujar los objetos de la escena
-        for (const auto& object : sceneObjects)
-        {
-            if (object.name.find("Luz") != std::string::npos)
+        // Dibujar los objetos de la escena: cada entidad con MeshRenderer emite un paquete a
+        // la cola, que se ordena por estado y se envía con los cambios de programa/textura/VAO
+        // justos. Las luces se dibujan como cubos sin iluminar de su color.
+        renderQueue.begin(camera.Position, camera.Front, farPlane);
+        scene.each<TransformComponent, Light>([&](Entity, const TransformComponent& transform, const Light& light) {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3(sceneGraph.world(transform.node)[3]));
+            model = glm::scale(model, glm::vec3(0.5f));
+            renderQueue.push(RenderPass::Opaque, lightCubeShaderId, unlitMaterialId, shapeMeshIds[(int)ShapeType::Cube], model, glm::vec4(light.color, 1.0f));
+        });
+
+        // La variante PBR depende de los mapas del material y del formato de vértice de la
+        // malla; las entidades seguidas suelen repetirlos, así que se recuerda la última.
+        uint16_t lastMaterial = NO_RENDER_ID;
+        VertexFormat lastFormat = VertexFormat::Compact;
+        uint16_t lastShaderId = 0;
+        scene.each<TransformComponent, MeshRenderer>([&](Entity, const TransformComponent& transform, const MeshRenderer& renderer) {
+            const glm::mat4& model = sceneGraph.world(transform.node);
+            const float ao = 1.0f;
+            // Mallas o materiales que ya no cupieron en la cola de render.
+            if (renderer.mesh == NO_RENDER_ID || renderer.material == NO_RENDER_ID)
+                return;
+            uint16_t meshId = renderer.mesh;
+            auto lods = meshLods.find(renderer.mesh);
+            if (lods != meshLods.end())
             {
-                lightCubeShader.use();
-                lightCubeShader.setMat4("view", view);
-                lightCubeShader.setMat4("projection", projection);
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, object.transform.position);
-                model = glm::scale(model, glm::vec3(0.5f));
-                lightCubeShader.setMat4("model", model);
-                lightCubeShader.setVec3("lightColor", glm::vec3(1.0f));
-                glBindVertexArray(cubeVAO);
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                const float distance = glm::length(glm::vec3(model * glm::vec4(lods->second.center, 1.0f)) - camera.Position);
+                const float maxScale = glm::sqrt(glm::max(glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                                                          glm::max(glm::dot(glm::vec3(model[1]), glm::vec3(model[1])), glm::dot(glm::vec3(model[2]), glm::vec3(model[2])))));
+                const float pixelsPerUnit = scr_height / (2.0f * std::tan(glm::radians(camera.Zoom) * 0.5f) * glm::max(distance, 0.001f));
+                for (size_t level = 1; level < lods->second.meshes.size() && lods->second.errors[level] * maxScale * pixelsPerUnit <= LOD_PIXEL_ERROR; ++level)
+                    meshId = lods->second.meshes[level];
+                if (meshId == NO_RENDER_ID)
+                    return;
             }
-            else
+            const VertexFormat format = renderQueue.mesh(meshId).format;
+            if (renderer.material != lastMaterial || format != lastFormat)
             {
-                pbrShader.use();
-                pbrShader.setMat4("view", view);
-                pbrShader.setMat4("projection", projection);
-                pbrShader.setVec3("viewPos", camera.Position);
-                pbrShader.setVec3("lightPositions[0]", sceneObjects[0].transform.position);
-                pbrShader.setVec3("lightColors[0]", glm::vec3(lightIntensity));
-
-                glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, albedoMap);
-                glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, normalMap);
-                glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, metallicMap);
-                glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, roughnessMap);
-
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, object.transform.position);
-                model = glm::rotate(model, glm::radians(object.transform.rotation.x), glm::vec3(1, 0, 0));
-                model = glm::rotate(model, glm::radians(object.transform.rotation.y), glm::vec3(0, 1, 0));
-                model = glm::rotate(model, glm::radians(object.transform.rotation.z), glm::vec3(0, 0, 1));
-                model = glm::scale(model, object.transform.scale);
-                pbrShader.setMat4("model", model);
-                pbrShader.setFloat("ao", 1.0f);
-                glBindVertexArray(cubeVAO);
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                lastShaderId = renderQueue.shaderId(selectPbrShader(shaderLibrary, renderQueue.material(renderer.material), format));
+                lastMaterial = renderer.material;
+                lastFormat = format;
             }
-        }
+            renderQueue.push(RenderPass::Opaque, lastShaderId, renderer.material, meshId, model, glm::vec4(ao, 0.0f, 0.0f, 0.0f));
+        });
+        renderQueue.sort();
+        renderQueue.execute();
 
         // --- 2. RENDERIZAR LA INTERFAZ NATIVA ---
-        glDisable(GL_DEPTH_TEST);
+        GLState::disable(GL_DEPTH_TEST);
         DrawUI(uiShader, uiVAO, uiVBO);
-        glEnable(GL_DEPTH_TEST);
+        GLState::enable(GL_DEPTH_TEST);
 
         glfwSwapBuffers(window);
         glfwPollEvents();
+        GLState::endFrame();
+
+        // Estadísticas del frame en el título de la ventana, una vez por segundo.
+        framesSinceStats++;
+        if (currentFrame - lastStatsTime >= 1.0f)
+        {
+            const GLState::Stats& glStats = GLState::lastFrame();
+            const TextureLoader::Stats textureStats = TextureLoader::stats();
+            char title[320];
+            std::snprintf(title, sizeof(title), "Chaos Engine - Editor Nativo | %.0f fps | draws %d (%d instances) | GL calls %d issued, %d filtered | textures %zu/%zu MB (%d reduced)",
+                framesSinceStats / (currentFrame - lastStatsTime), renderQueue.stats().draws, renderQueue.stats().instances,
+                glStats.issued, glStats.filtered, textureStats.residentBytes >> 20, textureStats.memoryBudget >> 20, textureStats.reduced);
+            glfwSetWindowTitle(window, title);
+            lastStatsTime = currentFrame;
+            framesSinceStats = 0;
+        }
+
+        if (firstFrame)
+        {
+            StartupTimeline::end("first frame");
+            firstFrame = false;
+        }
+        // La línea de tiempo se imprime cuando todas las texturas están en la GPU.
+        if (!timelineReported && TextureLoader::pending() == 0)
+        {
+            ShaderCompiler::reportTimeline(std::cout);
+            timelineReported = true;
+        }
     }
 
     // --- Limpieza ---
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteVertexArrays(1, &gridVAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &gridVBO);
-    pbrShader.Delete();
+    TextureLoader::release(albedoMap);
+    TextureLoader::release(normalMap);
+    TextureLoader::release(ormMap);
+    for (Mesh& mesh : shapeMeshes)
+        deleteMesh(mesh);
+    for (Mesh& mesh : importedMeshes)
+        deleteMesh(mesh);
+    for (unsigned int texture : importedTextures)
+        TextureLoader::release(texture);
+    for (unsigned int buffer : importedBuffers)
+        GLState::deleteBuffer(buffer);
+    GLState::deleteVertexArray(gridVAO);
+    GLState::deleteVertexArray(uiVAO);
+    GLState::deleteBuffer(gridVBO);
+    GLState::deleteBuffer(uiVBO);
+    frameUBO.Delete();
+    lightUBO.Delete();
+    shaderLibrary.Delete();
+    renderQueue.Delete();
     lightCubeShader.Delete();
+    AsyncIO::shutdown();
+    JobSystem::shutdown();
+    TextureLoader::shutdown();
+    VirtualFileSystem::unmountAll();
     glfwTerminate();
     return 0;
 }
 
-// ... El resto de las funciones (loadTexture, etc.) no cambian ...
+// ... El resto de las funciones no cambian ...
 
 void processInput(GLFWwindow* window)
 {
@@ -327,44 +478,6 @@ void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
     }
 }
 
-unsigned int loadTexture(char const* path)
-{
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-        std::cout << "Texture loaded successfully: " << path << std::endl;
-    }
-    else
-    {
-        std::cout << "ERROR::TEXTURE::LOAD_FAILED\n" << "Path: " << path << std::endl;
-        stbi_image_free(data);
-        return 0;
-    }
-
-    return textureID;
-}
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 {
     camera.ProcessMouseScroll(static_cast<float>(yoffset));
@@ -378,9 +491,13 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 
 void DrawUI(Shader& uiShader, unsigned int uiVAO, unsigned int uiVBO)
 {
+    // Hashes calculados en compilación: la búsqueda no construye strings cada frame.
+    static constexpr UniformName projectionName("projection");
+    static constexpr UniformName colorName("color");
+
     glm::mat4 ortho = glm::ortho(0.0f, (float)scr_width, 0.0f, (float)scr_height);
     uiShader.use();
-    uiShader.setMat4("projection", ortho);
+    uiShader.setMat4(uiShader.getUniform(projectionName), ortho);
 
     // Panel de fondo
     float panelWidth = 300.0f;
@@ -397,10 +514,371 @@ void DrawUI(Shader& uiShader, unsigned int uiVAO, unsigned int uiVBO)
         panelX + panelWidth, panelY + panelHeight
     };
 
-    glBindVertexArray(uiVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, uiVBO);
+    GLState::bindVertexArray(uiVAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, uiVBO);
     glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
 
-    uiShader.setVec3("color", 0.2f, 0.2f, 0.2f);
+    uiShader.setVec3(uiShader.getUniform(colorName), 0.2f, 0.2f, 0.2f);
     glDrawArrays(GL_TRIANGLES, 0, 6);
 }
+
+void drop_callback(GLFWwindow* window, int count, const char** paths)
+{
+    for (int i = 0; i < count; ++i)
+        requestModelImport(paths[i]);
+}
+
+Shader& selectPbrShader(ShaderLibrary& shaders, const Material& material, VertexFormat format)
+{
+    ShaderDefines defines;
+    if (material.textures[NORMAL_UNIT] != 0)
+        defines.set("NORMAL_MAP");
+    if (material.layout == MaterialLayout::PackedORM)
+        defines.set("ORM_MAP");
+    else if (material.layout == MaterialLayout::MetallicRoughness)
+        defines.set("METALLIC_ROUGHNESS_MAP");
+    if (format == VertexFormat::Float)
+        defines.set("FLOAT_VERTEX");
+
+    Shader& shader = shaders.get("assets/shaders/basic.vert", "assets/shaders/basic.frag", defines);
+
+    // Los samplers se configuran una única vez, en el primer uso de cada permutación
+    // (hacerlo al crearla bloquearía esperando a que el driver termine de compilar).
+    static std::unordered_set<const Shader*> configured;
+    if (configured.insert(&shader).second)
+    {
+        shader.use();
+        shader.setInt("albedoMap", ALBEDO_UNIT);
+        shader.setInt("normalMap", NORMAL_UNIT);
+        if (material.layout != MaterialLayout::Separate)
+        {
+            shader.setInt("ormMap", ORM_UNIT);
+        }
+        else
+        {
+            shader.setInt("metallicMap", METALLIC_UNIT);
+            shader.setInt("roughnessMap", ROUGHNESS_UNIT);
+        }
+    }
+    return shader;
+}
+
+void requestModelImport(const std::string& path)
+{
+    const size_t dot = path.find_last_of('.');
+    std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+    for (char& c : extension)
+        c = (char)std::tolower((unsigned char)c);
+    ModelFormat format;
+    if (extension == "obj")
+        format = ModelFormat::Obj;
+    else if (extension == "gltf" || extension == "glb")
+        format = ModelFormat::Gltf;
+    else if (extension == "cmesh")
+        format = ModelFormat::CMesh;
+    else
+    {
+        std::cout << "ERROR::MODEL::UNSUPPORTED_FORMAT\n" << "Path: " << path << std::endl;
+        return;
+    }
+
+    JobSystem::submit([path, format] {
+        auto import = std::make_unique<ModelImport>();
+        import->path = path;
+        import->format = format;
+        const double start = StartupTimeline::now();
+        if (format == ModelFormat::Obj)
+        {
+            import->ok = ObjImporter::load(path, import->model, import->error);
+        }
+        else if (format == ModelFormat::Gltf)
+        {
+            import->ok = GltfImporter::load(path, import->gltf, import->error);
+        }
+        else if (!import->cmeshFile.open(path))
+        {
+            import->error = "cannot open " + path;
+        }
+        else
+        {
+            // El checksum recorre el archivo entero: de paso lo deja en memoria para la subida.
+            import->ok = CMeshFile::parse(import->cmeshFile.data(), import->cmeshFile.size(), import->cmesh, import->error);
+            if (!import->ok)
+                import->error = path + ": " + import->error;
+        }
+        import->ms = StartupTimeline::now() - start;
+
+        std::lock_guard<std::mutex> lock(importMutex);
+        finishedImports.push_back(std::move(import));
+    });
+}
+
+// Material de la cola de render para un material del .mtl (layout Separate). Los valores
+// sin mapa van en texturas de 1x1; el albedo se codifica en sRGB porque basic.frag lo
+// linealiza al leerlo.
+uint16_t addImportedMaterial(RenderQueue& renderQueue, const ObjMaterial& source)
+{
+    auto solid = [](float value) {
+        return TextureLoader::loadSolid((unsigned char)(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f), 0, 0);
+    };
+    const glm::vec3 albedo = glm::pow(glm::clamp(source.diffuse, 0.0f, 1.0f), glm::vec3(1.0f / 2.2f)) * 255.0f + 0.5f;
+
+    Material material;
+    material.layout = MaterialLayout::Separate;
+    material.textures[ALBEDO_UNIT] = source.diffuseMap.empty()
+        ? TextureLoader::loadSolid((unsigned char)albedo.r, (unsigned char)albedo.g, (unsigned char)albedo.b)
+        : TextureLoader::load(source.diffuseMap, TextureKind::Color);
+    if (!source.normalMap.empty())
+        material.textures[NORMAL_UNIT] = TextureLoader::load(source.normalMap, TextureKind::Normal);
+    material.textures[METALLIC_UNIT] = source.metallicMap.empty() ? solid(source.metallic) : TextureLoader::load(source.metallicMap, TextureKind::Data);
+    material.textures[ROUGHNESS_UNIT] = source.roughnessMap.empty() ? solid(source.roughness) : TextureLoader::load(source.roughnessMap, TextureKind::Data);
+
+    for (unsigned int texture : material.textures)
+    {
+        if (texture != 0)
+            importedTextures.push_back(texture);
+    }
+    return renderQueue.addMaterial(material);
+}
+
+// Material de la cola de render para un material pbrMetallicRoughness de glTF. Si la
+// oclusión va en la misma imagen que metálico/rugosidad se usa como ORM; si no, la
+// oclusión se descarta. Con textura, los factores van al material y multiplican lo que
+// se lee; sin ella, se guardan en una textura de 1x1 y el factor del material queda a 1.
+uint16_t addGltfMaterial(RenderQueue& renderQueue, const GltfModel& model, int index)
+{
+    const GltfMaterial source = index >= 0 ? model.materials[index] : GltfMaterial();
+    auto image = [&](int imageIndex, TextureKind kind) {
+        const GltfImage& image = model.images[imageIndex];
+        return image.bytes ? TextureLoader::loadEncoded(image.key, image.bytes, kind) : TextureLoader::load(image.path, kind);
+    };
+    auto solid = [](float value) {
+        return TextureLoader::loadSolid((unsigned char)(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f), 0, 0);
+    };
+
+    Material material;
+    if (source.baseColorTexture >= 0)
+    {
+        material.textures[ALBEDO_UNIT] = image(source.baseColorTexture, TextureKind::Color);
+        material.baseColorFactor = glm::vec3(source.baseColor);
+    }
+    else
+    {
+        const glm::vec3 albedo = glm::pow(glm::clamp(glm::vec3(source.baseColor), 0.0f, 1.0f), glm::vec3(1.0f / 2.2f)) * 255.0f + 0.5f;
+        material.textures[ALBEDO_UNIT] = TextureLoader::loadSolid((unsigned char)albedo.r, (unsigned char)albedo.g, (unsigned char)albedo.b);
+    }
+    if (source.normalTexture >= 0)
+        material.textures[NORMAL_UNIT] = image(source.normalTexture, TextureKind::Normal);
+    if (source.metallicRoughnessTexture >= 0)
+    {
+        material.layout = source.occlusionTexture == source.metallicRoughnessTexture ? MaterialLayout::PackedORM : MaterialLayout::MetallicRoughness;
+        material.textures[ORM_UNIT] = image(source.metallicRoughnessTexture, TextureKind::ORM);
+        material.metallicFactor = source.metallic;
+        material.roughnessFactor = source.roughness;
+    }
+    else
+    {
+        material.layout = MaterialLayout::Separate;
+        material.textures[METALLIC_UNIT] = solid(source.metallic);
+        material.textures[ROUGHNESS_UNIT] = solid(source.roughness);
+    }
+
+    for (unsigned int texture : material.textures)
+    {
+        if (texture != 0)
+            importedTextures.push_back(texture);
+    }
+    return renderQueue.addMaterial(material);
+}
+
+// Posición, rotación y escala de una matriz afín sin cizalla. Con algún eje de escala
+// nula la rotación no se puede recuperar y queda la identidad.
+Transform decomposeTransform(const glm::mat4& matrix)
+{
+    Transform transform;
+    transform.position = glm::vec3(matrix[3]);
+    transform.scale = glm::vec3(glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2])));
+    if (glm::determinant(glm::mat3(matrix)) < 0.0f)
+        transform.scale.x = -transform.scale.x;
+
+    if (glm::any(glm::lessThan(glm::abs(transform.scale), glm::vec3(1e-20f))))
+        return transform;
+    const glm::mat3 rotation(glm::vec3(matrix[0]) / transform.scale.x, glm::vec3(matrix[1]) / transform.scale.y, glm::vec3(matrix[2]) / transform.scale.z);
+    transform.rotation = glm::quat_cast(rotation);
+    return transform;
+}
+
+// Sube un modelo glTF: cada buffer usado por primitivas directas va entero a un buffer de
+// GL de una vez, desde la proyección del archivo, y sus mallas solo crean el VAO que
+// apunta dentro; el resto se sube como las mallas del .obj. La jerarquía de nodos pasa
+// al grafo de escena y cada nodo con malla da un objeto de escena por primitiva, todos
+// sobre el nodo.
+void spawnGltfModel(RenderQueue& renderQueue, const GltfModel& model)
+{
+    std::vector<GLuint> buffers(model.buffers.size(), 0);
+    for (size_t i = 0; i < model.buffers.size(); ++i)
+    {
+        if (model.buffers[i].size == 0)
+            continue;
+        glGenBuffers(1, &buffers[i]);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, model.buffers[i].size, model.buffers[i].bytes, GL_STATIC_DRAW);
+        importedBuffers.push_back(buffers[i]);
+    }
+
+    std::vector<std::vector<uint16_t>> meshIds(model.meshes.size());
+    for (size_t m = 0; m < model.meshes.size(); ++m)
+    {
+        for (const GltfPrimitive& primitive : model.meshes[m].primitives)
+        {
+            if (primitive.direct)
+            {
+                VertexStream streams[4];
+                for (int i = 0; i < 4; ++i)
+                {
+                    const GltfStream& source = primitive.attributes[i];
+                    streams[i].buffer = buffers[source.buffer];
+                    streams[i].offset = source.offset;
+                    streams[i].components = source.components;
+                    streams[i].type = source.componentType;
+                    streams[i].normalized = source.normalized ? GL_TRUE : GL_FALSE;
+                    streams[i].stride = source.stride;
+                }
+                importedMeshes.push_back(createStreamMesh(streams, buffers[primitive.indices.buffer], primitive.indices.offset, primitive.indices.componentType,
+                                                          primitive.indexCount, primitive.vertexCount, primitive.boundsMin, primitive.boundsMax));
+            }
+            else
+            {
+                importedMeshes.push_back(uploadMesh(primitive.data));
+            }
+            meshIds[m].push_back(renderQueue.addMesh(importedMeshes.back()));
+        }
+    }
+
+    // Los padres de glTF pueden ir detrás de sus hijos: primero se crean todos los nodos
+    // y luego se enlazan (el grafo se reordena en su próximo update()).
+    std::vector<SceneNode> nodes(model.nodes.size());
+    for (size_t i = 0; i < model.nodes.size(); ++i)
+        nodes[i] = sceneGraph.create(decomposeTransform(model.nodes[i].local));
+    for (size_t i = 0; i < model.nodes.size(); ++i)
+    {
+        if (model.nodes[i].parent >= 0)
+            sceneGraph.setParent(nodes[i], nodes[model.nodes[i].parent]);
+    }
+
+    // Las primitivas sin material usan el material por defecto de glTF (blanco, metálico y rugosidad 1).
+    std::vector<int> materialIds(model.materials.size() + 1, -1);
+    for (size_t n = 0; n < model.nodes.size(); ++n)
+    {
+        const GltfNode& node = model.nodes[n];
+        if (node.mesh < 0)
+            continue;
+        const GltfMesh& mesh = model.meshes[node.mesh];
+        for (size_t p = 0; p < mesh.primitives.size(); ++p)
+        {
+            const int materialIndex = mesh.primitives[p].material;
+            const size_t materialSlot = materialIndex >= 0 ? (size_t)materialIndex : model.materials.size();
+            if (materialIds[materialSlot] < 0)
+                materialIds[materialSlot] = addGltfMaterial(renderQueue, model, materialIndex);
+
+            scene.create(Name{ !node.name.empty() ? node.name : !mesh.name.empty() ? mesh.name : "Modelo" }, TransformComponent{ nodes[n] },
+                         MeshRenderer{ meshIds[node.mesh][p], (uint16_t)materialIds[materialSlot] });
+        }
+    }
+}
+
+// Sube un .cmesh: sus secciones de vértices e índices van tal cual del archivo proyectado
+// a dos buffers de GL y cada LOD de cada submalla es una malla que apunta a su rango. Un
+// objeto de escena por submalla, con el material gris por defecto (el formato no guarda
+// materiales).
+void spawnCMeshModel(RenderQueue& renderQueue, const CMeshView& view)
+{
+    const CMeshHeader& header = *view.header;
+    GLuint buffers[2];
+    glGenBuffers(2, buffers);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, header.vertices.size, view.vertices, GL_STATIC_DRAW);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ARRAY_BUFFER, header.indices.size, view.indices, GL_STATIC_DRAW);
+    importedBuffers.insert(importedBuffers.end(), buffers, buffers + 2);
+
+    const GLenum indexType = header.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    const int material = addImportedMaterial(renderQueue, ObjMaterial());
+    for (uint32_t i = 0; i < header.submeshCount; ++i)
+    {
+        const CMeshSubmesh& submesh = view.submeshes[i];
+        const glm::vec3 boundsMin(submesh.boundsMin[0], submesh.boundsMin[1], submesh.boundsMin[2]);
+        const glm::vec3 boundsExtent(submesh.boundsExtent[0], submesh.boundsExtent[1], submesh.boundsExtent[2]);
+        MeshLods lods;
+        lods.center = glm::vec3(submesh.sphere[0], submesh.sphere[1], submesh.sphere[2]);
+        for (uint32_t level = 0; level < submesh.lodCount; ++level)
+        {
+            const CMeshLod& lod = view.lods[submesh.firstLod + level];
+            importedMeshes.push_back(createCompactMesh(buffers[0], submesh.firstVertex * sizeof(CompactVertex), (GLsizei)submesh.vertexCount, buffers[1],
+                                                       lod.firstIndex * header.indexSize, indexType, (GLsizei)lod.indexCount, boundsMin, boundsExtent));
+            lods.meshes.push_back(renderQueue.addMesh(importedMeshes.back()));
+            lods.errors.push_back(lod.error);
+        }
+
+        scene.create(Name{ view.name(submesh)[0] != '\0' ? view.name(submesh) : "Modelo" }, TransformComponent{ sceneGraph.create() },
+                     MeshRenderer{ lods.meshes[0], (uint16_t)material });
+        if (lods.meshes.size() > 1)
+            meshLods[lods.meshes[0]] = lods;
+    }
+}
+
+// Recoge las importaciones terminadas: sube cada malla y crea sus objetos de escena (los
+// del .obj, uno por malla en el origen).
+void spawnImportedModels(RenderQueue& renderQueue)
+{
+    std::vector<std::unique_ptr<ModelImport>> imports;
+    {
+        std::lock_guard<std::mutex> lock(importMutex);
+        imports.swap(finishedImports);
+    }
+
+    for (const auto& import : imports)
+    {
+        if (!import->ok)
+        {
+            std::cout << "ERROR::MODEL::IMPORT_FAILED\n" << import->error << std::endl;
+            continue;
+        }
+        if (!import->error.empty())
+            std::cout << "WARNING::MODEL::IMPORT\n" << import->error << std::endl;
+
+        if (import->format == ModelFormat::Gltf)
+        {
+            spawnGltfModel(renderQueue, import->gltf);
+            std::cout << "Model imported: " << import->path << " (" << import->gltf.meshes.size() << " meshes, " << import->gltf.nodes.size() << " nodes, "
+                      << import->gltf.triangles << " triangles, " << (int)import->ms << " ms)" << std::endl;
+            continue;
+        }
+        if (import->format == ModelFormat::CMesh)
+        {
+            const double uploadStart = StartupTimeline::now();
+            spawnCMeshModel(renderQueue, import->cmesh);
+            std::cout << "Model imported: " << import->path << " (" << import->cmesh.header->submeshCount << " submeshes, " << (import->cmeshFile.size() >> 20)
+                      << " MB, validated in " << (int)import->ms << " ms, uploaded in " << (int)(StartupTimeline::now() - uploadStart) << " ms)" << std::endl;
+            continue;
+        }
+
+        const ObjModel& model = import->model;
+        std::vector<int> materialIds(model.materials.size() + 1, -1);
+        for (const ObjMesh& objMesh : model.meshes)
+        {
+            if (objMesh.data.indices.empty())
+                continue;
+            // Las mallas sin material usan un ObjMaterial por defecto (gris, rugosidad 0.5).
+            const size_t materialSlot = objMesh.material >= 0 ? (size_t)objMesh.material : model.materials.size();
+            if (materialIds[materialSlot] < 0)
+                materialIds[materialSlot] = addImportedMaterial(renderQueue, objMesh.material >= 0 ? model.materials[objMesh.material] : ObjMaterial());
+
+            importedMeshes.push_back(uploadMesh(objMesh.data));
+            scene.create(Name{ objMesh.name.empty() ? "Modelo" : objMesh.name }, TransformComponent{ sceneGraph.create() },
+                         MeshRenderer{ renderQueue.addMesh(importedMeshes.back()), (uint16_t)materialIds[materialSlot] });
+        }
+        std::cout << "Model imported: " << import->path << " (" << model.meshes.size() << " meshes, " << model.triangles << " triangles, "
+                  << (int)import->ms << " ms)" << std::endl;
+    }
+}
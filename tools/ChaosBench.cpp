@@ -0,0 +1,983 @@
+// chaos-bench: microbenchmarks de los sistemas del motor que no necesitan contexto GL.
+// Uso: chaos-bench <prueba>   (sin argumentos ejecuta todas)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "AssetPack.h"
+#include "AsyncIO.h"
+#include "CMeshFile.h"
+#include "Components.h"
+#include "EntityWorld.h"
+#include "GltfImporter.h"
+#include "MappedFile.h"
+#include "JobSystem.h"
+#include "Lz4.h"
+#include "MeshBuilder.h"
+#include "MipGenerator.h"
+#include "ObjImporter.h"
+#include "SceneGraph.h"
+#include "VirtualFileSystem.h"
+
+namespace
+{
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void reportMesh(const char* name, const std::vector<Vertex>& triangles)
+    {
+        // Antes: la sopa de triángulos tal cual, soldada pero en el orden de generación.
+        MeshData welded = MeshBuilder::weld(triangles);
+        VertexCacheStats before = MeshBuilder::analyze(welded.indices, welded.vertices.size());
+
+        auto start = std::chrono::steady_clock::now();
+        MeshData optimized = MeshBuilder::build(triangles);
+        double buildMs = elapsedMs(start);
+        VertexCacheStats after = MeshBuilder::analyze(optimized.indices, optimized.vertices.size());
+
+        const size_t soupBytes = triangles.size() * sizeof(Vertex);
+        const size_t indexSize = optimized.vertices.size() <= 0x10000 ? 2 : 4;
+        const size_t indexedBytes = optimized.vertices.size() * sizeof(Vertex) + optimized.indices.size() * indexSize;
+
+        std::printf("%-22s %8zu tris %8zu -> %7zu verts %9zu -> %8zu bytes  ACMR %.3f -> %.3f  ATVR %.3f -> %.3f  (%.2f ms)\n",
+            name, triangles.size() / 3, triangles.size(), optimized.vertices.size(), soupBytes, indexedBytes,
+            before.acmr, after.acmr, before.atvr, after.atvr, buildMs);
+    }
+
+    void benchMesh()
+    {
+        std::printf("--- mesh: weld + vertex cache (Forsyth, %d entries) + vertex fetch ---\n", MeshBuilder::CACHE_SIZE);
+        reportMesh("cube", MeshBuilder::cubeTriangles());
+        reportMesh("sphere 32x16", MeshBuilder::sphereTriangles(32, 16));
+        reportMesh("cylinder 32", MeshBuilder::cylinderTriangles(32));
+        reportMesh("plane 64x64", MeshBuilder::planeTriangles(64));
+        reportMesh("sphere 512x256", MeshBuilder::sphereTriangles(512, 256));
+
+        // Peor caso: los triángulos de una esfera en orden aleatorio, como suele llegar
+        // una malla importada sin optimizar.
+        std::vector<Vertex> shuffled = MeshBuilder::sphereTriangles(256, 128);
+        std::vector<size_t> order(shuffled.size() / 3);
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+        std::vector<Vertex> triangles;
+        triangles.reserve(shuffled.size());
+        for (size_t t : order)
+            triangles.insert(triangles.end(), shuffled.begin() + t * 3, shuffled.begin() + t * 3 + 3);
+        reportMesh("sphere 256x128 shuffled", triangles);
+    }
+
+    // Filtro de caja 2x2 sobre bytes, tal como se generaban los mips antes de
+    // MipGenerator (sin espacio lineal ni SIMD). Sirve de referencia de tiempo y de valores.
+    std::vector<unsigned char> referenceMips(const unsigned char* pixels, int width, int height, int channels)
+    {
+        std::vector<unsigned char> result(pixels, pixels + (size_t)width * height * channels);
+        size_t srcOffset = 0;
+        int srcWidth = width, srcHeight = height;
+        while (srcWidth > 1 || srcHeight > 1)
+        {
+            const int dstWidth = std::max(1, srcWidth / 2), dstHeight = std::max(1, srcHeight / 2);
+            const size_t dstOffset = result.size();
+            result.resize(dstOffset + (size_t)dstWidth * dstHeight * channels);
+            const unsigned char* src = result.data() + srcOffset;
+            unsigned char* dst = result.data() + dstOffset;
+            for (int y = 0; y < dstHeight; ++y)
+            {
+                const int y0 = std::min(y * 2, srcHeight - 1), y1 = std::min(y * 2 + 1, srcHeight - 1);
+                for (int x = 0; x < dstWidth; ++x)
+                {
+                    const int x0 = std::min(x * 2, srcWidth - 1), x1 = std::min(x * 2 + 1, srcWidth - 1);
+                    for (int c = 0; c < channels; ++c)
+                    {
+                        const int sum = src[((size_t)y0 * srcWidth + x0) * channels + c] + src[((size_t)y0 * srcWidth + x1) * channels + c]
+                                      + src[((size_t)y1 * srcWidth + x0) * channels + c] + src[((size_t)y1 * srcWidth + x1) * channels + c];
+                        dst[((size_t)y * dstWidth + x) * channels + c] = (unsigned char)((sum + 2) / 4);
+                    }
+                }
+            }
+            srcOffset = dstOffset;
+            srcWidth = dstWidth;
+            srcHeight = dstHeight;
+        }
+        return result;
+    }
+
+    template <typename Function>
+    double bestOf(int runs, Function function)
+    {
+        double best = 1e30;
+        for (int run = 0; run < runs; ++run)
+        {
+            auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min(best, elapsedMs(start));
+        }
+        return best;
+    }
+
+    void benchMips()
+    {
+        const int size = 2048;
+        const int channels = 4;
+        std::vector<unsigned char> image((size_t)size * size * channels);
+        std::mt19937 random(7);
+        for (unsigned char& value : image)
+            value = (unsigned char)(random() & 0xFF);
+
+        std::printf("--- mips: %dx%d RGBA8, full chain, kernel %s ---\n", size, size, MipGenerator::kernelName());
+
+        std::vector<unsigned char> reference;
+        const double referenceMs = bestOf(3, [&] { reference = referenceMips(image.data(), size, size, channels); });
+        std::printf("%-34s %8.2f ms\n", "reference byte box filter", referenceMs);
+
+        MipChain linear;
+        const double singleMs = bestOf(3, [&] { linear = MipGenerator::build(image.data(), size, size, channels); });
+        std::printf("%-34s %8.2f ms\n", "MipGenerator linear, 1 thread", singleMs);
+
+        // El filtro lineal coincide con la referencia salvo redondeo: la referencia
+        // cuantiza a 8 bits en cada nivel y MipGenerator solo al final.
+        int maxDifference = 0;
+        for (size_t i = 0; i < reference.size(); ++i)
+            maxDifference = std::max(maxDifference, std::abs((int)reference[i] - (int)linear.pixels[i]));
+
+        JobSystem::init();
+        const double threadedMs = bestOf(3, [&] { linear = MipGenerator::build(image.data(), size, size, channels); });
+        std::printf("%-34s %8.2f ms  (%u workers)\n", "MipGenerator linear, threaded", threadedMs, JobSystem::threadCount());
+
+        MipOptions srgb;
+        srgb.srgb = true;
+        std::printf("%-34s %8.2f ms\n", "MipGenerator sRGB, threaded", bestOf(3, [&] { MipGenerator::build(image.data(), size, size, channels, srgb); }));
+
+        MipOptions normals;
+        normals.normalMap = true;
+        std::printf("%-34s %8.2f ms\n", "MipGenerator normal map, threaded", bestOf(3, [&] { MipGenerator::build(image.data(), size, size, channels, normals); }));
+
+        MipOptions coverage;
+        coverage.alphaCoverageCutoff = 0.5f;
+        std::printf("%-34s %8.2f ms\n", "MipGenerator alpha coverage, thr.", bestOf(3, [&] { MipGenerator::build(image.data(), size, size, channels, coverage); }));
+        JobSystem::shutdown();
+
+        std::printf("max difference linear vs reference: %d (of 255)\n", maxDifference);
+    }
+
+    // Rejilla ondulada de 'quads' x 'quads' cuadrados con v/vt/vn, escrita como la
+    // exportaría un programa de modelado (índices v/vt/vn iguales, seis decimales).
+    bool writeGridObj(const char* path, int quads)
+    {
+        FILE* file = std::fopen(path, "wb");
+        if (!file)
+            return false;
+        std::fprintf(file, "# chaos-bench\no grid\n");
+        const int side = quads + 1;
+        for (int y = 0; y < side; ++y)
+        {
+            for (int x = 0; x < side; ++x)
+                std::fprintf(file, "v %.6f %.6f %.6f\n", x * 0.01f, 0.05f * std::sin(x * 0.1f) * std::cos(y * 0.1f), y * 0.01f);
+        }
+        for (int y = 0; y < side; ++y)
+        {
+            for (int x = 0; x < side; ++x)
+                std::fprintf(file, "vt %.6f %.6f\n", (float)x / quads, (float)y / quads);
+        }
+        for (int y = 0; y < side; ++y)
+        {
+            for (int x = 0; x < side; ++x)
+                std::fprintf(file, "vn %.6f %.6f %.6f\n", 0.0f, 1.0f, 0.0f);
+        }
+        for (int y = 0; y < quads; ++y)
+        {
+            for (int x = 0; x < quads; ++x)
+            {
+                const int a = y * side + x + 1, b = a + 1, c = a + side + 1, d = a + side;
+                std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d, d, d);
+            }
+        }
+        std::fclose(file);
+        return true;
+    }
+
+    void benchObj()
+    {
+        const char* path = "chaos-bench-grid.obj";
+        const int quads = 1000;
+        if (!writeGridObj(path, quads))
+        {
+            std::printf("--- obj: cannot write %s ---\n", path);
+            return;
+        }
+        FILE* file = std::fopen(path, "rb");
+        std::fseek(file, 0, SEEK_END);
+        const double megabytes = std::ftell(file) / (1024.0 * 1024.0);
+        std::fclose(file);
+        std::printf("--- obj: %d triangles, %.1f MB ---\n", quads * quads * 2, megabytes);
+
+        auto run = [&](const char* name, bool optimize) {
+            ObjImportOptions options;
+            options.optimize = optimize;
+            ObjModel model;
+            std::string error;
+            auto start = std::chrono::steady_clock::now();
+            const bool ok = ObjImporter::load(path, model, error, options);
+            const double ms = elapsedMs(start);
+            if (!ok)
+            {
+                std::printf("%-34s failed: %s\n", name, error.c_str());
+                return;
+            }
+            const size_t vertices = model.meshes.empty() ? 0 : model.meshes[0].data.vertices.size();
+            std::printf("%-34s %8.2f ms  %6.0f MB/s  %zu tris, %zu verts\n", name, ms, megabytes / (ms / 1000.0), model.triangles, vertices);
+        };
+
+        run("parse + dedup, 1 thread", false);
+        run("parse + dedup + optimize, 1 thread", true);
+        JobSystem::init();
+        run("parse + dedup, threaded", false);
+        run("parse + dedup + optimize, threaded", true);
+        JobSystem::shutdown();
+        std::remove(path);
+    }
+
+    // La misma rejilla como .glb de un exportador típico: un bufferView por atributo
+    // (float, con tangentes), índices de 32 bits y un nodo padre con la malla en un hijo.
+    bool writeGridGlb(const char* path, int quads)
+    {
+        const int side = quads + 1;
+        const size_t vertexCount = (size_t)side * side;
+        const size_t indexCount = (size_t)quads * quads * 6;
+        std::vector<float> positions, normals, texCoords, tangents;
+        positions.reserve(vertexCount * 3);
+        for (int y = 0; y < side; ++y)
+        {
+            for (int x = 0; x < side; ++x)
+            {
+                positions.insert(positions.end(), { x * 0.01f, 0.05f * std::sin(x * 0.1f) * std::cos(y * 0.1f), y * 0.01f });
+                normals.insert(normals.end(), { 0.0f, 1.0f, 0.0f });
+                texCoords.insert(texCoords.end(), { (float)x / quads, (float)y / quads });
+                tangents.insert(tangents.end(), { 1.0f, 0.0f, 0.0f, 1.0f });
+            }
+        }
+        std::vector<uint32_t> indices;
+        indices.reserve(indexCount);
+        for (int y = 0; y < quads; ++y)
+        {
+            for (int x = 0; x < quads; ++x)
+            {
+                const uint32_t a = y * side + x, b = a + 1, c = a + side + 1, d = a + side;
+                indices.insert(indices.end(), { a, d, c, a, c, b });
+            }
+        }
+
+        const size_t sizes[5] = { positions.size() * 4, normals.size() * 4, texCoords.size() * 4, tangents.size() * 4, indices.size() * 4 };
+        const void* data[5] = { positions.data(), normals.data(), texCoords.data(), tangents.data(), indices.data() };
+        size_t offsets[5];
+        size_t binLength = 0;
+        for (int i = 0; i < 5; ++i)
+        {
+            offsets[i] = binLength;
+            binLength += sizes[i];
+        }
+
+        char json[2048];
+        const float maxCoord = quads * 0.01f;
+        int jsonLength = std::snprintf(json, sizeof(json),
+            "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+            "\"nodes\":[{\"name\":\"root\",\"children\":[1],\"translation\":[0,1,0]},{\"name\":\"grid\",\"mesh\":0,\"scale\":[2,2,2]}],"
+            "\"meshes\":[{\"name\":\"grid\",\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2,\"TANGENT\":3},\"indices\":4}]}],"
+            "\"accessors\":["
+            "{\"bufferView\":0,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\",\"min\":[0,-0.05,0],\"max\":[%g,0.05,%g]},"
+            "{\"bufferView\":1,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\"},"
+            "{\"bufferView\":2,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC2\"},"
+            "{\"bufferView\":3,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC4\"},"
+            "{\"bufferView\":4,\"componentType\":5125,\"count\":%zu,\"type\":\"SCALAR\"}],"
+            "\"bufferViews\":["
+            "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu},{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu},"
+            "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu},{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu},"
+            "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu}],"
+            "\"buffers\":[{\"byteLength\":%zu}]}",
+            vertexCount, maxCoord, maxCoord, vertexCount, vertexCount, vertexCount, indexCount,
+            offsets[0], sizes[0], offsets[1], sizes[1], offsets[2], sizes[2], offsets[3], sizes[3], offsets[4], sizes[4], binLength);
+        while (jsonLength % 4 != 0)
+            json[jsonLength++] = ' ';
+
+        FILE* file = std::fopen(path, "wb");
+        if (!file)
+            return false;
+        const uint32_t header[5] = { 0x46546C67, 2, (uint32_t)(12 + 8 + jsonLength + 8 + binLength), (uint32_t)jsonLength, 0x4E4F534A };
+        std::fwrite(header, sizeof(header), 1, file);
+        std::fwrite(json, 1, jsonLength, file);
+        const uint32_t binHeader[2] = { (uint32_t)binLength, 0x004E4942 };
+        std::fwrite(binHeader, sizeof(binHeader), 1, file);
+        for (int i = 0; i < 5; ++i)
+            std::fwrite(data[i], 1, sizes[i], file);
+        std::fclose(file);
+        return true;
+    }
+
+    // Importar un .glb debería costar lo que cuesta leerlo del disco: se compara con
+    // leer el archivo entero a un buffer (la subida a GL necesita contexto y no se mide).
+    void benchGltf()
+    {
+        const char* path = "chaos-bench-grid.glb";
+        const int quads = 1500;
+        if (!writeGridGlb(path, quads))
+        {
+            std::printf("--- gltf: cannot write %s ---\n", path);
+            return;
+        }
+        FILE* file = std::fopen(path, "rb");
+        std::fseek(file, 0, SEEK_END);
+        const size_t bytes = (size_t)std::ftell(file);
+        std::fclose(file);
+        const double megabytes = bytes / (1024.0 * 1024.0);
+        std::printf("--- gltf: %d triangles, %.1f MB ---\n", quads * quads * 2, megabytes);
+
+        std::vector<unsigned char> contents(bytes);
+        const double readMs = bestOf(3, [&] {
+            FILE* input = std::fopen(path, "rb");
+            const size_t read = std::fread(contents.data(), 1, bytes, input);
+            std::fclose(input);
+            (void)read;
+        });
+        std::printf("%-34s %8.2f ms  %6.0f MB/s\n", "fread whole file (baseline)", readMs, megabytes / (readMs / 1000.0));
+
+        GltfModel model;
+        std::string error;
+        bool ok = true;
+        const double loadMs = bestOf(3, [&] { ok = GltfImporter::load(path, model, error); });
+        if (!ok)
+        {
+            std::printf("%-34s failed: %s\n", "GltfImporter::load", error.c_str());
+        }
+        else
+        {
+            size_t direct = 0, uploadBytes = 0;
+            for (const GltfMesh& mesh : model.meshes)
+            {
+                for (const GltfPrimitive& primitive : mesh.primitives)
+                    direct += primitive.direct ? 1 : 0;
+            }
+            for (const GltfBuffer& buffer : model.buffers)
+                uploadBytes += buffer.size;
+            std::printf("%-34s %8.2f ms  %6.0f MB/s  %zu tris, %zu direct primitives, %.1f MB to upload, %zu nodes\n", "GltfImporter::load (mmap)",
+                        loadMs, megabytes / (loadMs / 1000.0), model.triangles, direct, uploadBytes / (1024.0 * 1024.0), model.nodes.size());
+        }
+        model = GltfModel();
+        std::remove(path);
+    }
+
+    // Rejilla ondulada indexada de 'quads' x 'quads' cuadrados, desplazada en x.
+    MeshData gridMesh(int quads, float offset)
+    {
+        MeshData mesh;
+        const int side = quads + 1;
+        mesh.vertices.reserve((size_t)side * side);
+        for (int y = 0; y < side; ++y)
+        {
+            for (int x = 0; x < side; ++x)
+            {
+                Vertex vertex;
+                vertex.position = glm::vec3(offset + x * 0.01f, 0.05f * std::sin(x * 0.1f) * std::cos(y * 0.1f), y * 0.01f);
+                vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+                vertex.texCoords = glm::vec2((float)x / quads, (float)y / quads);
+                vertex.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+                mesh.vertices.push_back(vertex);
+            }
+        }
+        for (int y = 0; y < quads; ++y)
+        {
+            for (int x = 0; x < quads; ++x)
+            {
+                const uint32_t a = y * side + x, b = a + 1, c = a + side + 1, d = a + side;
+                mesh.indices.insert(mesh.indices.end(), { a, d, c, a, c, b });
+            }
+        }
+        return mesh;
+    }
+
+    // El .cmesh se valida y se deja listo para subir: lo que queda por medir es lo que
+    // cuesta recorrerlo para el checksum frente a leerlo del disco.
+    void benchCMesh()
+    {
+        const char* path = "chaos-bench-scene.cmesh";
+        const int submeshCount = 48;
+        const int quads = 250;     // 63001 vértices: índices de 16 bits
+        std::vector<CMeshSource> meshes(submeshCount);
+        for (int i = 0; i < submeshCount; ++i)
+        {
+            meshes[i].name = "grid" + std::to_string(i);
+            meshes[i].data = gridMesh(quads, i * 3.0f);
+        }
+
+        JobSystem::init();
+        std::string error;
+        auto start = std::chrono::steady_clock::now();
+        if (!CMeshFile::write(path, meshes, error))
+        {
+            std::printf("--- cmesh: %s ---\n", error.c_str());
+            JobSystem::shutdown();
+            return;
+        }
+        const double writeMs = elapsedMs(start);
+
+        MappedFile file;
+        file.open(path);
+        const double megabytes = file.size() / (1024.0 * 1024.0);
+        CMeshView view;
+        CMeshFile::parse(file.data(), file.size(), view, error, false);
+        std::printf("--- cmesh: %u submeshes, %.1f MB, written in %.0f ms ---\n", view.header->submeshCount, megabytes, writeMs);
+        std::printf("LOD triangles of submesh 0:");
+        for (uint32_t level = 0; level < view.submeshes[0].lodCount; ++level)
+            std::printf(" %u", view.lods[view.submeshes[0].firstLod + level].indexCount / 3);
+        std::printf("\n");
+
+        std::vector<unsigned char> contents(file.size());
+        const double readMs = bestOf(3, [&] {
+            FILE* input = std::fopen(path, "rb");
+            const size_t read = std::fread(contents.data(), 1, contents.size(), input);
+            std::fclose(input);
+            (void)read;
+        });
+        std::printf("%-34s %8.2f ms  %6.0f MB/s\n", "fread whole file (baseline)", readMs, megabytes / (readMs / 1000.0));
+
+        bool ok = true;
+        const double headerMs = bestOf(3, [&] { ok = CMeshFile::parse(file.data(), file.size(), view, error, false); });
+        std::printf("%-34s %8.3f ms\n", "parse, tables + index ranges", headerMs);
+        const double checksumMs = bestOf(3, [&] { ok = CMeshFile::parse(file.data(), file.size(), view, error, true) && ok; });
+        std::printf("%-34s %8.2f ms  %6.0f MB/s  (%.0f ms per GB)%s\n", "parse + checksum, threaded", checksumMs, megabytes / (checksumMs / 1000.0),
+                    checksumMs * 1024.0 / megabytes, ok ? "" : "  FAILED");
+        JobSystem::shutdown();
+
+        file.close();
+        std::remove(path);
+    }
+
+    // Muchos archivos pequeños (fuentes de shader sintéticos) sueltos frente al mismo
+    // árbol en un paquete: lo que se ahorra es abrir cada archivo.
+    void benchPack()
+    {
+        const char* directory = "chaos-bench-assets";
+        const char* packPath = "chaos-bench-assets.pak";
+        const int fileCount = 2000;
+        const char* words[] = { "uniform", "vec3", "vec4", "float", "normalize(", "dot(", "texture(", "material.",
+                                "light", "position", "*", "+", "=", ";\n", "    ", "0.5", "1.0", "#include \"common/lighting.glsl\"\n" };
+        std::mt19937 random(11);
+        std::filesystem::create_directories(directory);
+        std::vector<std::string> paths;
+        size_t totalBytes = 0;
+        for (int i = 0; i < fileCount; ++i)
+        {
+            std::string text;
+            while (text.size() < 3000)
+                text += std::string(words[random() % (sizeof(words) / sizeof(words[0]))]) + " ";
+            paths.push_back(std::string(directory) + "/shader" + std::to_string(i) + ".glsl");
+            FILE* file = std::fopen(paths.back().c_str(), "wb");
+            std::fwrite(text.data(), 1, text.size(), file);
+            std::fclose(file);
+            totalBytes += text.size();
+        }
+
+        std::vector<AssetPackSource> sources;
+        for (const std::string& path : paths)
+            sources.push_back({ path, path, false });
+        std::string error;
+        JobSystem::init();
+        auto start = std::chrono::steady_clock::now();
+        const bool written = AssetPack::write(packPath, sources, error);
+        const double writeMs = elapsedMs(start);
+        JobSystem::shutdown();
+        if (!written)
+        {
+            std::printf("--- pack: %s ---\n", error.c_str());
+            return;
+        }
+        const size_t packBytes = (size_t)std::filesystem::file_size(packPath);
+        std::printf("--- pack: %d files, %.0f KB -> %.0f KB packed in %.0f ms ---\n", fileCount, totalBytes / 1024.0,
+                    packBytes / 1024.0, writeMs);
+
+        std::string text;
+        size_t readBytes = 0;
+        const double looseMs = bestOf(3, [&] {
+            readBytes = 0;
+            for (const std::string& path : paths)
+            {
+                VirtualFileSystem::read(path, text);
+                readBytes += text.size();
+            }
+        });
+        std::printf("%-34s %8.2f ms  (%zu bytes)\n", "loose files, open + read each", looseMs, readBytes);
+
+        const double packedMs = bestOf(3, [&] {
+            VirtualFileSystem::mount(packPath);
+            readBytes = 0;
+            for (const std::string& path : paths)
+            {
+                VirtualFileSystem::read(path, text);
+                readBytes += text.size();
+            }
+            VirtualFileSystem::unmountAll();
+        });
+        std::printf("%-34s %8.2f ms  (%zu bytes)\n", "pack, mount + lookup + LZ4 each", packedMs, readBytes);
+
+        std::vector<uint8_t> all;
+        for (const std::string& path : paths)
+        {
+            VirtualFileSystem::read(path, text);
+            all.insert(all.end(), text.begin(), text.end());
+        }
+        std::vector<uint8_t> compressed(Lz4::compressBound(all.size()));
+        size_t compressedSize = 0;
+        const double compressMs = bestOf(3, [&] { compressedSize = Lz4::compress(all.data(), all.size(), compressed.data(), compressed.size()); });
+        std::vector<uint8_t> restored(all.size());
+        bool ok = true;
+        const double decompressMs = bestOf(3, [&] { ok = Lz4::decompress(compressed.data(), compressedSize, restored.data(), restored.size()); });
+        ok = ok && restored == all;
+        const double megabytes = all.size() / (1024.0 * 1024.0);
+        std::printf("%-34s %8.2f ms  %6.0f MB/s  (ratio %.2f)\n", "LZ4 compress", compressMs, megabytes / (compressMs / 1000.0),
+                    (double)all.size() / compressedSize);
+        std::printf("%-34s %8.2f ms  %6.0f MB/s%s\n", "LZ4 decompress", decompressMs, megabytes / (decompressMs / 1000.0), ok ? "" : "  FAILED");
+
+        std::filesystem::remove_all(directory);
+        std::remove(packPath);
+    }
+
+    // Muchas lecturas de 1 MB: en serie con fread frente a AsyncIO con cada backend. Los
+    // archivos acaban de escribirse y están en la caché de páginas, así que se mide sobre
+    // todo el coste de las llamadas al sistema y de repartir el trabajo; con el disco frío
+    // la diferencia la marcan las lecturas en vuelo a la vez.
+    void benchIO()
+    {
+        const char* directory = "chaos-bench-io";
+        const int fileCount = 128;
+        const size_t fileSize = 1 << 20;
+        std::filesystem::create_directories(directory);
+        std::vector<std::string> paths;
+        std::vector<unsigned char> content(fileSize);
+        std::mt19937 random(5);
+        for (int i = 0; i < fileCount; ++i)
+        {
+            for (unsigned char& byte : content)
+                byte = (unsigned char)random();
+            paths.push_back(std::string(directory) + "/blob" + std::to_string(i) + ".bin");
+            FILE* file = std::fopen(paths.back().c_str(), "wb");
+            std::fwrite(content.data(), 1, content.size(), file);
+            std::fclose(file);
+        }
+        const double megabytes = fileCount * (double)fileSize / (1024.0 * 1024.0);
+        std::printf("--- io: %d files x %zu KB ---\n", fileCount, fileSize / 1024);
+
+        std::vector<unsigned char> buffer(fileSize);
+        size_t readBytes = 0;
+        const double freadMs = bestOf(3, [&] {
+            readBytes = 0;
+            for (const std::string& path : paths)
+            {
+                FILE* file = std::fopen(path.c_str(), "rb");
+                if (!file)
+                    continue;
+                readBytes += std::fread(buffer.data(), 1, buffer.size(), file);
+                std::fclose(file);
+            }
+        });
+        std::printf("%-34s %8.2f ms  %6.0f MB/s  (%zu bytes)\n", "fread, one file after another", freadMs,
+                    megabytes / (freadMs / 1000.0), readBytes);
+
+        JobSystem::init();
+        const IOBackend backends[] = { IOBackend::Threads, IOBackend::IoUring };
+        for (IOBackend backend : backends)
+        {
+            AsyncIO::init(64, backend);
+            std::atomic<size_t> asyncBytes(0);
+            std::atomic<int> completed(0);
+            double submitMs = 0.0;
+            const double asyncMs = bestOf(3, [&] {
+                asyncBytes = 0;
+                completed = 0;
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < fileCount; ++i)
+                {
+                    const IOPriority priority = i % 4 == 0 ? IOPriority::Urgent : IOPriority::Normal;
+                    AsyncIO::read(paths[i], 0, AsyncIO::WHOLE_FILE, priority, [&asyncBytes, &completed](bool ok, std::vector<unsigned char>& bytes) {
+                        if (ok)
+                            asyncBytes += bytes.size();
+                        completed++;
+                    });
+                }
+                submitMs = elapsedMs(start);
+                // Los callbacks corren en JobSystem: se espera a que hayan llegado todos.
+                AsyncIO::waitIdle();
+                while (completed.load() < fileCount)
+                    std::this_thread::yield();
+            });
+            char label[64];
+            std::snprintf(label, sizeof(label), "AsyncIO (%s)", AsyncIO::backendName());
+            std::printf("%-34s %8.2f ms  %6.0f MB/s  (%zu bytes, %.2f ms to submit)\n", label, asyncMs,
+                        megabytes / (asyncMs / 1000.0), asyncBytes.load(), submitMs);
+            AsyncIO::shutdown();
+        }
+        JobSystem::shutdown();
+
+        std::filesystem::remove_all(directory);
+    }
+
+    // Transformación como la guardaba GameObject antes del grafo de escena: ángulos de
+    // Euler en grados, compuestos con glm::rotate.
+    struct EulerTransform {
+        glm::vec3 position;
+        glm::vec3 rotation;
+        glm::vec3 scale;
+    };
+
+    EulerTransform randomTransform(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        EulerTransform transform;
+        transform.position = glm::vec3(unit(random), unit(random), unit(random)) * 10.0f;
+        transform.rotation = glm::vec3(unit(random), unit(random), unit(random)) * 180.0f;
+        transform.scale = glm::vec3(1.0f + 0.1f * unit(random));
+        return transform;
+    }
+
+    glm::mat4 rotateChain(const EulerTransform& transform)
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, transform.position);
+        model = glm::rotate(model, glm::radians(transform.rotation.x), glm::vec3(1, 0, 0));
+        model = glm::rotate(model, glm::radians(transform.rotation.y), glm::vec3(0, 1, 0));
+        model = glm::rotate(model, glm::radians(transform.rotation.z), glm::vec3(0, 0, 1));
+        return glm::scale(model, transform.scale);
+    }
+
+    // La misma rotación Rx * Ry * Rz como cuaternión.
+    Transform toQuaternion(const EulerTransform& euler)
+    {
+        const glm::vec3 angles = glm::radians(euler.rotation);
+        Transform transform;
+        transform.position = euler.position;
+        transform.rotation = glm::angleAxis(angles.x, glm::vec3(1, 0, 0)) * glm::angleAxis(angles.y, glm::vec3(0, 1, 0)) *
+                             glm::angleAxis(angles.z, glm::vec3(0, 0, 1));
+        transform.scale = euler.scale;
+        return transform;
+    }
+
+    float maxDifference(const glm::mat4& a, const glm::mat4& b)
+    {
+        float difference = 0.0f;
+        for (int column = 0; column < 4; ++column)
+        {
+            const glm::vec4 d = glm::abs(a[column] - b[column]);
+            difference = std::max(difference, std::max(std::max(d.x, d.y), std::max(d.z, d.w)));
+        }
+        return difference;
+    }
+
+    // 1M matrices de modelo: el bucle de antes (objetos con nombre y transformación de
+    // Euler intercalados, glm::rotate por eje) frente a cuaterniones en un array de
+    // Transform y frente a TransformArrays con su kernel SIMD.
+    void benchTransforms()
+    {
+        struct LegacyObject {
+            unsigned int id;
+            std::string name;
+            EulerTransform transform;
+            int mesh;
+            int material;
+        };
+        const size_t count = 1000000;
+        std::mt19937 random(9);
+        std::vector<LegacyObject> objects;
+        std::vector<Transform> quaternions;
+        TransformArrays arrays;
+        objects.reserve(count);
+        quaternions.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            objects.push_back({ (unsigned int)i, "Objeto importado " + std::to_string(i), randomTransform(random), -1, -1 });
+            quaternions.push_back(toQuaternion(objects.back().transform));
+            arrays.push(quaternions.back());
+        }
+        std::printf("--- transforms: %zu objects ---\n", count);
+
+        std::vector<glm::mat4> reference(count);
+        const double chainMs = bestOf(3, [&] {
+            for (size_t i = 0; i < count; ++i)
+                reference[i] = rotateChain(objects[i].transform);
+        });
+        std::printf("%-34s %8.2f ms\n", "GameObject + glm::rotate chain", chainMs);
+
+        std::vector<glm::mat4> matrices(count);
+        const double quaternionMs = bestOf(3, [&] {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Transform& transform = quaternions[i];
+                glm::mat4 model = glm::mat4_cast(transform.rotation);
+                model[0] *= transform.scale.x;
+                model[1] *= transform.scale.y;
+                model[2] *= transform.scale.z;
+                model[3] = glm::vec4(transform.position, 1.0f);
+                matrices[i] = model;
+            }
+        });
+        std::printf("%-34s %8.2f ms  (%.1fx)\n", "Transform array + glm::mat4_cast", quaternionMs, chainMs / quaternionMs);
+
+        const double arraysMs = bestOf(3, [&] { arrays.compose(0, count, matrices.data()); });
+        float error = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+            error = std::max(error, maxDifference(matrices[i], reference[i]));
+        char label[64];
+        std::snprintf(label, sizeof(label), "TransformArrays::compose (%s)", TransformArrays::kernelName());
+        std::printf("%-34s %8.2f ms  (%.1fx, max error %.2g)\n", label, arraysMs, chainMs / arraysMs, error);
+    }
+
+    // 100k nodos en 1000 árboles de 100 (cadenas cortas con ramas): reconstruir todas
+    // las matrices cada frame como hacía el bucle de render frente a SceneGraph::update()
+    // con la escena quieta, con un árbol movido y con todo sucio.
+    void benchScene()
+    {
+        const int treeCount = 1000;
+        const int treeSize = 100;
+        std::mt19937 random(3);
+        SceneGraph graph;
+        std::vector<SceneNode> nodes;
+        std::vector<SceneNode> roots;
+        std::vector<EulerTransform> transforms;
+        std::vector<Transform> quaternions;
+        std::vector<int> parents;
+        for (int tree = 0; tree < treeCount; ++tree)
+        {
+            for (int i = 0; i < treeSize; ++i)
+            {
+                const EulerTransform transform = randomTransform(random);
+                const int parent = i == 0 ? -1 : (int)transforms.size() - 1 - (int)(random() % std::min(i, 4));
+                const SceneNode node = graph.create(toQuaternion(transform), parent >= 0 ? nodes[parent] : NO_SCENE_NODE);
+                nodes.push_back(node);
+                if (i == 0)
+                    roots.push_back(node);
+                transforms.push_back(transform);
+                quaternions.push_back(toQuaternion(transform));
+                parents.push_back(parent);
+            }
+        }
+        std::printf("--- scene: %zu nodes ---\n", transforms.size());
+
+        std::vector<glm::mat4> worlds(transforms.size());
+        const double rebuildMs = bestOf(5, [&] {
+            for (size_t i = 0; i < transforms.size(); ++i)
+            {
+                const glm::mat4 model = rotateChain(transforms[i]);
+                worlds[i] = parents[i] >= 0 ? worlds[parents[i]] * model : model;
+            }
+        });
+        std::printf("%-34s %8.3f ms\n", "rebuild every matrix (old loop)", rebuildMs);
+
+        graph.update();
+        float maxError = 0.0f;
+        for (size_t i = 0; i < transforms.size(); ++i)
+            maxError = std::max(maxError, maxDifference(graph.world(nodes[i]), worlds[i]));
+
+        size_t updated = 0;
+        const double staticMs = bestOf(5, [&] { updated = graph.update(); });
+        std::printf("%-34s %8.3f ms  (%zu matrices)\n", "update, static scene", staticMs, updated);
+
+        Transform moved = graph.local(roots[treeCount / 2]);
+        const double oneTreeMs = bestOf(5, [&] {
+            moved.position.x += 0.01f;
+            graph.setLocal(roots[treeCount / 2], moved);
+            updated = graph.update();
+        });
+        std::printf("%-34s %8.3f ms  (%zu matrices)\n", "update, one tree moved", oneTreeMs, updated);
+
+        const double allMs = bestOf(5, [&] {
+            for (size_t i = 0; i < transforms.size(); ++i)
+                graph.setLocal(nodes[i], quaternions[i]);
+            updated = graph.update();
+        });
+        std::printf("%-34s %8.3f ms  (%zu matrices, max error vs glm %.2g)\n", "update, everything dirty", allMs, updated, maxError);
+    }
+
+    // 1M objetos con malla y 16 luces: los sistemas de render y de luces sobre el vector
+    // de GameObject de antes (las luces se reconocían por el nombre) frente a EntityWorld,
+    // donde cada sistema solo recorre los bloques de su arquetipo.
+    void benchEcs()
+    {
+        struct LegacyObject {
+            unsigned int id;
+            std::string name;
+            SceneNode node;
+            ShapeType shape;
+            int mesh;
+            int material;
+        };
+        const size_t objectCount = 1000000;
+        const size_t lightCount = 16;
+        std::vector<LegacyObject> objects;
+        EntityWorld world;
+        objects.reserve(objectCount + lightCount);
+        for (size_t i = 0; i < objectCount + lightCount; ++i)
+        {
+            const bool light = i % (objectCount / lightCount) == 0 && i / (objectCount / lightCount) < lightCount;
+            std::string name = light ? "Luz " + std::to_string(i) : "Objeto importado " + std::to_string(i);
+            const SceneNode node = { (uint32_t)i, 0 };
+            objects.push_back({ (unsigned int)i, name, node, ShapeType::Cube, light ? -1 : (int)(i & 0xFFF), light ? -1 : (int)(i & 0xF) });
+            if (light)
+                world.create(Name{ name }, TransformComponent{ node }, Light());
+            else
+                world.create(Name{ name }, TransformComponent{ node }, MeshRenderer{ (uint16_t)(i & 0xFFF), (uint16_t)(i & 0xF) });
+        }
+        std::printf("--- ecs: %zu entities, %zu archetypes ---\n", world.size(), world.archetypeCount());
+
+        size_t found = 0;
+        const double legacyLightsMs = bestOf(5, [&] {
+            found = 0;
+            for (const LegacyObject& object : objects)
+                found += object.name.find("Luz") != std::string::npos ? object.node.index : 0;
+        });
+        std::printf("%-34s %8.3f ms  (%zu)\n", "lights, name.find over objects", legacyLightsMs, found);
+        const double lightsMs = bestOf(5, [&] {
+            found = 0;
+            world.each<TransformComponent, Light>([&found](Entity, const TransformComponent& transform, const Light&) { found += transform.node.index; });
+        });
+        std::printf("%-34s %8.3f ms  (%zu)\n", "lights, Light query", lightsMs, found);
+
+        const double legacyMeshesMs = bestOf(5, [&] {
+            found = 0;
+            for (const LegacyObject& object : objects)
+            {
+                if (object.mesh >= 0)
+                    found += object.node.index + (size_t)object.mesh + (size_t)object.material;
+            }
+        });
+        std::printf("%-34s %8.3f ms  (%zu)\n", "meshes, vector<GameObject>", legacyMeshesMs, found);
+        const double meshesMs = bestOf(5, [&] {
+            found = 0;
+            world.each<TransformComponent, MeshRenderer>([&found](Entity, const TransformComponent& transform, const MeshRenderer& renderer) {
+                found += transform.node.index + renderer.mesh + renderer.material;
+            });
+        });
+        std::printf("%-34s %8.3f ms  (%zu)\n", "meshes, MeshRenderer query", meshesMs, found);
+    }
+
+    // Escena de 100k objetos de la que se borran y se crean 2000 por frame en posiciones
+    // al azar, como al cargar y descargar sectores: el vector de GameObject de antes
+    // (erase desplaza todo lo que va detrás y las referencias se buscaban por id) frente a
+    // EntityWorld con handles. Al final cuenta cuántos handles guardados se detectan como
+    // caducados.
+    void benchHandles()
+    {
+        struct LegacyObject {
+            unsigned int id;
+            std::string name;
+            SceneNode node;
+            int mesh;
+            int material;
+        };
+        const size_t objectCount = 100000;
+        const size_t churn = 2000;
+        const int frames = 20;
+        std::printf("--- handles: %zu objects, %zu destroyed and created per frame ---\n", objectCount, churn);
+
+        std::mt19937 random(5);
+        std::vector<LegacyObject> objects;
+        unsigned int nextId = 0;
+        for (size_t i = 0; i < objectCount; ++i)
+            objects.push_back({ nextId++, "Objeto " + std::to_string(i), NO_SCENE_NODE, (int)(i & 0xFFF), (int)(i & 0xF) });
+        // Como selectedObjectIndex: una referencia a un objeto que hay que volver a buscar.
+        const unsigned int selectedId = objects[objectCount / 2].id;
+        size_t legacyFound = 0;
+        const auto legacyStart = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            for (size_t i = 0; i < churn; ++i)
+                objects.erase(objects.begin() + random() % objects.size());
+            for (size_t i = 0; i < churn; ++i)
+                objects.push_back({ nextId++, "Objeto", NO_SCENE_NODE, 0, 0 });
+            for (const LegacyObject& object : objects)
+                legacyFound += object.id == selectedId;
+        }
+        const double legacyMs = elapsedMs(legacyStart) / frames;
+        std::printf("%-34s %8.3f ms/frame  (selected found %zu frames)\n", "vector<GameObject> erase + id", legacyMs, legacyFound);
+
+        random.seed(5);
+        EntityWorld world;
+        std::vector<Entity> entities;
+        for (size_t i = 0; i < objectCount; ++i)
+            entities.push_back(world.create(Name{ "Objeto " + std::to_string(i) }, TransformComponent(), MeshRenderer{ (uint16_t)(i & 0xFFF), (uint16_t)(i & 0xF) }));
+        const std::vector<Entity> original = entities;
+        const Entity selected = entities[objectCount / 2];
+        size_t found = 0;
+        const auto worldStart = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            for (size_t i = 0; i < churn; ++i)
+            {
+                const size_t index = random() % entities.size();
+                world.destroy(entities[index]);
+                entities[index] = entities.back();
+                entities.pop_back();
+            }
+            for (size_t i = 0; i < churn; ++i)
+                entities.push_back(world.create(Name{ "Objeto" }, TransformComponent(), MeshRenderer()));
+            found += world.get<MeshRenderer>(selected) != nullptr;
+        }
+        const double worldMs = elapsedMs(worldStart) / frames;
+        size_t stale = 0;
+        for (Entity entity : original)
+            stale += !world.alive(entity);
+        std::printf("%-34s %8.3f ms/frame  (%.1fx, selected found %zu frames, %zu of %zu old handles stale)\n", "EntityWorld destroy + handle", worldMs,
+                    legacyMs / worldMs, found, stale, original.size());
+    }
+
+    struct Benchmark
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    const Benchmark benchmarks[] = {
+        { "mesh", benchMesh },
+        { "mips", benchMips },
+        { "obj", benchObj },
+        { "gltf", benchGltf },
+        { "cmesh", benchCMesh },
+        { "pack", benchPack },
+        { "io", benchIO },
+        { "transforms", benchTransforms },
+        { "scene", benchScene },
+        { "ecs", benchEcs },
+        { "handles", benchHandles },
+    };
+}
+
+int main(int argc, char** argv)
+{
+    bool ranAny = false;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (argc > 1 && std::strcmp(argv[1], benchmark.name) != 0)
+            continue;
+        benchmark.run();
+        ranAny = true;
+    }
+
+    if (!ranAny)
+    {
+        std::fprintf(stderr, "Unknown benchmark '%s'. Available:", argv[1]);
+        for (const Benchmark& benchmark : benchmarks)
+            std::fprintf(stderr, " %s", benchmark.name);
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+    return 0;
+}
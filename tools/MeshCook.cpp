@@ -0,0 +1,173 @@
+// chaos-meshcook: convierte modelos importados (.obj, .gltf, .glb) al formato .cmesh, que
+// el editor proyecta en memoria y sube sin analizar ni convertir nada (ver CMeshFile.h).
+// Uso: chaos-meshcook [--lods <1-8>] <modelo>...
+// Cada modelo se escribe junto al original con extensión .cmesh: una submalla por malla
+// del .obj o por primitiva de cada nodo del glTF, con la transformación del nodo ya
+// aplicada. Los materiales no se guardan.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "CMeshFile.h"
+#include "GltfImporter.h"
+#include "JobSystem.h"
+#include "ObjImporter.h"
+
+namespace
+{
+    std::string extensionOf(const std::string& path)
+    {
+        const size_t dot = path.find_last_of('.');
+        std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+        for (char& c : extension)
+            c = (char)std::tolower((unsigned char)c);
+        return extension;
+    }
+
+    std::string outputPath(const std::string& input)
+    {
+        const size_t slash = input.find_last_of("/\\");
+        const size_t dot = input.find_last_of('.');
+        const std::string stem = dot != std::string::npos && (slash == std::string::npos || dot > slash) ? input.substr(0, dot) : input;
+        return stem + ".cmesh";
+    }
+
+    // Dirección normalizada, o 'fallback' si la transformación la ha dejado sin longitud.
+    glm::vec3 normalizedOr(const glm::vec3& value, const glm::vec3& fallback)
+    {
+        const float length2 = glm::dot(value, value);
+        return length2 > 1e-20f ? value / std::sqrt(length2) : fallback;
+    }
+
+    // Primitiva con la transformación de su nodo aplicada. Las normales usan la matriz de
+    // cofactores (la inversa transpuesta sin dividir por el determinante), que no se rompe
+    // con escala nula; una matriz que refleja invierte el orden de los triángulos y la
+    // orientación de la bitangente. Lo que quede sin longitud conserva la dirección original.
+    MeshData transformed(const MeshData& source, const glm::mat4& world)
+    {
+        MeshData result = source;
+        const glm::mat3 linear(world);
+        const bool mirrored = glm::determinant(linear) < 0.0f;
+        const glm::mat3 normalMatrix = glm::mat3(glm::cross(linear[1], linear[2]), glm::cross(linear[2], linear[0]), glm::cross(linear[0], linear[1])) *
+                                       (mirrored ? -1.0f : 1.0f);
+        for (Vertex& vertex : result.vertices)
+        {
+            vertex.position = glm::vec3(world * glm::vec4(vertex.position, 1.0f));
+            vertex.normal = normalizedOr(normalMatrix * vertex.normal, vertex.normal);
+            const glm::vec3 tangent = normalizedOr(linear * glm::vec3(vertex.tangent), glm::vec3(vertex.tangent));
+            vertex.tangent = glm::vec4(tangent, mirrored ? -vertex.tangent.w : vertex.tangent.w);
+        }
+        if (mirrored)
+        {
+            for (size_t i = 0; i + 2 < result.indices.size(); i += 3)
+                std::swap(result.indices[i + 1], result.indices[i + 2]);
+        }
+        return result;
+    }
+
+    bool gather(const std::string& input, std::vector<CMeshSource>& meshes)
+    {
+        std::string error;
+        const std::string extension = extensionOf(input);
+        if (extension == "obj")
+        {
+            ObjModel model;
+            if (!ObjImporter::load(input, model, error))
+            {
+                std::fprintf(stderr, "%s: %s\n", input.c_str(), error.c_str());
+                return false;
+            }
+            for (ObjMesh& mesh : model.meshes)
+            {
+                if (!mesh.data.indices.empty())
+                    meshes.push_back({ mesh.name, std::move(mesh.data) });
+            }
+        }
+        else if (extension == "gltf" || extension == "glb")
+        {
+            GltfModel model;
+            GltfImportOptions options;
+            options.direct = false;
+            if (!GltfImporter::load(input, model, error, options))
+            {
+                std::fprintf(stderr, "%s: %s\n", input.c_str(), error.c_str());
+                return false;
+            }
+            for (const GltfNode& node : model.nodes)
+            {
+                if (node.mesh < 0)
+                    continue;
+                const GltfMesh& mesh = model.meshes[node.mesh];
+                for (const GltfPrimitive& primitive : mesh.primitives)
+                    meshes.push_back({ !node.name.empty() ? node.name : mesh.name, transformed(primitive.data, node.world) });
+            }
+        }
+        else
+        {
+            std::fprintf(stderr, "%s: unsupported format\n", input.c_str());
+            return false;
+        }
+        if (!error.empty())
+            std::fprintf(stderr, "%s", error.c_str());
+        return true;
+    }
+
+    bool cook(const std::string& input, const CMeshWriteOptions& options)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<CMeshSource> meshes;
+        if (!gather(input, meshes))
+            return false;
+
+        const std::string output = outputPath(input);
+        std::string error;
+        if (!CMeshFile::write(output, meshes, error, options))
+        {
+            std::fprintf(stderr, "%s: %s\n", input.c_str(), error.c_str());
+            return false;
+        }
+
+        size_t triangles = 0;
+        for (const CMeshSource& mesh : meshes)
+            triangles += mesh.data.indices.size() / 3;
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%s -> %s (%zu submeshes, %zu triangles, %.0f ms)\n", input.c_str(), output.c_str(), meshes.size(), triangles, ms);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    CMeshWriteOptions options;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--lods" && i + 1 < argc)
+            options.maxLods = std::max(1, std::min(8, std::atoi(argv[++i])));
+        else
+            inputs.push_back(arg);
+    }
+
+    if (inputs.empty())
+    {
+        std::fprintf(stderr, "Usage: chaos-meshcook [--lods <1-8>] <model.obj|model.gltf|model.glb>...\n");
+        return 1;
+    }
+
+    JobSystem::init();
+    int failures = 0;
+    for (const std::string& input : inputs)
+    {
+        if (!cook(input, options))
+            failures++;
+    }
+    JobSystem::shutdown();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// chaos-pack: empaqueta carpetas de assets en un .pak que el motor monta con
+// VirtualFileSystem (ver AssetPack.h).
+// Uso: chaos-pack [--store] <salida.pak> <carpeta|archivo>...
+// Cada archivo entra con su ruta tal como se pasa (p. ej. "assets/shaders/basic.vert"),
+// que es la ruta con la que el motor lo pide, así que se ejecuta desde el directorio de
+// trabajo del motor. Las entradas se comprimen con LZ4 salvo los formatos que ya vienen
+// comprimidos o que se suben directamente desde la proyección (.png, .jpg, .ktx2,
+// .cmesh); --store no comprime nada.
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "AssetPack.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+
+namespace
+{
+    bool storeByExtension(const std::string& path)
+    {
+        const size_t dot = path.find_last_of('.');
+        std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+        for (char& c : extension)
+            c = (char)std::tolower((unsigned char)c);
+        for (const char* stored : { "png", "jpg", "jpeg", "ktx2", "cmesh" })
+        {
+            if (extension == stored)
+                return true;
+        }
+        return false;
+    }
+
+    bool gather(const std::string& input, bool storeAll, std::vector<AssetPackSource>& sources)
+    {
+        std::error_code error;
+        auto add = [&](const std::filesystem::path& path) {
+            AssetPackSource source;
+            source.name = path.generic_string();
+            source.path = path.string();
+            source.store = storeAll || storeByExtension(source.name);
+            sources.push_back(source);
+        };
+
+        if (std::filesystem::is_regular_file(input, error))
+        {
+            add(input);
+            return true;
+        }
+        if (!std::filesystem::is_directory(input, error))
+        {
+            std::fprintf(stderr, "%s: not found\n", input.c_str());
+            return false;
+        }
+        for (std::filesystem::recursive_directory_iterator it(input, error), end; it != end; it.increment(error))
+        {
+            if (it->is_regular_file(error))
+                add(it->path());
+        }
+        if (error)
+        {
+            std::fprintf(stderr, "%s: %s\n", input.c_str(), error.message().c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool storeAll = false;
+    std::string output;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--store")
+            storeAll = true;
+        else if (output.empty())
+            output = arg;
+        else
+            inputs.push_back(arg);
+    }
+
+    if (output.empty() || inputs.empty())
+    {
+        std::fprintf(stderr, "Usage: chaos-pack [--store] <output.pak> <directory|file>...\n");
+        return 1;
+    }
+
+    std::vector<AssetPackSource> sources;
+    for (const std::string& input : inputs)
+    {
+        if (!gather(input, storeAll, sources))
+            return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    JobSystem::init();
+    std::string error;
+    const bool written = AssetPack::write(output, sources, error);
+    JobSystem::shutdown();
+    if (!written)
+    {
+        std::fprintf(stderr, "%s: %s\n", output.c_str(), error.c_str());
+        return 1;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Resumen leído del propio paquete.
+    MappedFile pack;
+    AssetPackView view;
+    if (!pack.open(output) || !AssetPack::parse(pack.data(), pack.size(), view, error))
+    {
+        std::fprintf(stderr, "%s: %s\n", output.c_str(), error.c_str());
+        return 1;
+    }
+    uint64_t originalBytes = 0;
+    uint32_t compressed = 0;
+    for (uint32_t i = 0; i < view.header->entryCount; ++i)
+    {
+        originalBytes += view.entries[i].size;
+        if (view.entries[i].compression == (uint32_t)PackCompression::Lz4)
+            compressed++;
+    }
+    std::printf("%s: %u files (%u compressed), %.1f KB -> %.1f KB, %.0f ms\n", output.c_str(), view.header->entryCount, compressed,
+                originalBytes / 1024.0, pack.size() / 1024.0, ms);
+    return 0;
+}
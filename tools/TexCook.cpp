@@ -0,0 +1,211 @@
+// chaos-texcook: convierte imágenes fuente en texturas KTX2 comprimidas por bloques con
+// toda la cadena de mips, listas para subirse sin decodificar (ver TextureLoader).
+// Uso: chaos-texcook [--kind color|normal|data] [--format bc1|bc3|bc4|bc5] [--alpha-cutoff <0-1>] <imagen>...
+//      chaos-texcook --orm <salida.ktx2> <oclusión|-> <rugosidad|-> <metálico|->
+// Cada imagen se escribe junto a la original con extensión .ktx2. --orm empaqueta tres
+// mapas de un canal en una textura ORM (r = oclusión, g = rugosidad, b = metálico).
+// Los mips de color se filtran en lineal y los de normales se renormalizan; con
+// --alpha-cutoff cada mip conserva la cobertura del alpha test de la imagen original.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BlockCompression.h"
+#include "ChannelPacker.h"
+#include "JobSystem.h"
+#include "KtxFile.h"
+#include "MipGenerator.h"
+
+namespace
+{
+    enum class Kind { Auto, Color, Normal, Data };
+
+    const char* formatName(BlockFormat format)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1: return "BC1";
+        case BlockFormat::BC3: return "BC3";
+        case BlockFormat::BC4: return "BC4";
+        case BlockFormat::BC5: return "BC5";
+        }
+        return "?";
+    }
+
+    // Sin --kind se deduce del nombre: *normal* es un normal map y metallic, roughness,
+    // ao u occlusion son datos de un canal.
+    Kind guessKind(const std::string& path)
+    {
+        std::string name = path.substr(path.find_last_of("/\\") + 1);
+        for (char& c : name)
+            c = (char)std::tolower((unsigned char)c);
+        if (name.find("normal") != std::string::npos)
+            return Kind::Normal;
+        for (const char* data : { "metallic", "roughness", "occlusion", "ao." , "_ao" })
+        {
+            if (name.find(data) != std::string::npos)
+                return Kind::Data;
+        }
+        return Kind::Color;
+    }
+
+    bool hasAlpha(const unsigned char* rgba, int width, int height)
+    {
+        for (size_t i = 0; i < (size_t)width * height; ++i)
+        {
+            if (rgba[i * 4 + 3] != 255)
+                return true;
+        }
+        return false;
+    }
+
+    std::string outputPath(const std::string& input)
+    {
+        const size_t slash = input.find_last_of("/\\");
+        const size_t dot = input.find_last_of('.');
+        const std::string stem = dot != std::string::npos && (slash == std::string::npos || dot > slash) ? input.substr(0, dot) : input;
+        return stem + ".ktx2";
+    }
+
+    // Genera los mips, comprime cada nivel y escribe el KTX2.
+    bool cookPixels(const unsigned char* pixels, int width, int height, int channels, BlockFormat format, const MipOptions& options,
+                    const std::string& label, const std::string& output, std::chrono::steady_clock::time_point start)
+    {
+        const MipChain chain = MipGenerator::build(pixels, width, height, channels, options);
+
+        std::vector<std::vector<uint8_t>> levels;
+        size_t compressedBytes = 0;
+        for (int level = 0; level < chain.levels(); ++level)
+        {
+            levels.push_back(BlockCompression::compress(chain.level(level), chain.levelWidth(level), chain.levelHeight(level), channels, format));
+            compressedBytes += levels.back().size();
+        }
+
+        if (!KtxFile::write(output, format, (uint32_t)width, (uint32_t)height, levels))
+        {
+            std::fprintf(stderr, "%s: could not write %s\n", label.c_str(), output.c_str());
+            return false;
+        }
+
+        // Comparado con la imagen sin comprimir y su cadena de mips.
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const double sourceMB = chain.pixels.size() / (1024.0 * 1024.0);
+        const double cookedMB = compressedBytes / (1024.0 * 1024.0);
+        std::printf("%s -> %s: %s %dx%d, %d mips, %.2f MB -> %.2f MB (x%.1f), %.0f ms\n", label.c_str(), output.c_str(),
+            formatName(format), width, height, chain.levels(), sourceMB, cookedMB, sourceMB / cookedMB, ms);
+        return true;
+    }
+
+    bool cook(const std::string& input, Kind kind, bool forceFormat, BlockFormat forcedFormat, float alphaCutoff)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(input.c_str(), &width, &height, &channels, 4);
+        if (!pixels)
+        {
+            std::fprintf(stderr, "%s: %s\n", input.c_str(), stbi_failure_reason());
+            return false;
+        }
+
+        if (kind == Kind::Auto)
+            kind = guessKind(input);
+        BlockFormat format = BlockFormat::BC1;
+        if (forceFormat)
+            format = forcedFormat;
+        else if (kind == Kind::Normal)
+            format = BlockFormat::BC5;
+        else if (kind == Kind::Data)
+            format = BlockFormat::BC4;
+        else if (hasAlpha(pixels, width, height))
+            format = BlockFormat::BC3;
+
+        MipOptions options;
+        options.srgb = kind == Kind::Color;
+        options.normalMap = kind == Kind::Normal;
+        options.alphaCoverageCutoff = alphaCutoff;
+        const bool cooked = cookPixels(pixels, width, height, 4, format, options, input, outputPath(input), start);
+        stbi_image_free(pixels);
+        return cooked;
+    }
+
+    // Los tres canales se codifican juntos en BC1 (5:6:5 bits), como el resto del color.
+    bool cookORM(const std::string& output, const std::string& occlusion, const std::string& roughness, const std::string& metallic)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        PackedImage packed;
+        std::string error;
+        if (!ChannelPacker::packORM(occlusion == "-" ? "" : occlusion, roughness == "-" ? "" : roughness,
+                                    metallic == "-" ? "" : metallic, packed, error))
+        {
+            std::fprintf(stderr, "--orm: %s\n", error.c_str());
+            return false;
+        }
+        return cookPixels(packed.pixels.data(), packed.width, packed.height, packed.channels, BlockFormat::BC1, MipOptions(), "ORM", output, start);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Kind kind = Kind::Auto;
+    bool forceFormat = false;
+    BlockFormat format = BlockFormat::BC1;
+    float alphaCutoff = 0.0f;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--kind" && i + 1 < argc)
+        {
+            const std::string value = argv[++i];
+            kind = value == "normal" ? Kind::Normal : value == "data" ? Kind::Data : Kind::Color;
+        }
+        else if (arg == "--orm" && i + 4 < argc)
+        {
+            JobSystem::init();
+            const bool cooked = cookORM(argv[i + 1], argv[i + 2], argv[i + 3], argv[i + 4]);
+            JobSystem::shutdown();
+            return cooked ? 0 : 1;
+        }
+        else if (arg == "--alpha-cutoff" && i + 1 < argc)
+        {
+            alphaCutoff = (float)std::atof(argv[++i]);
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            const std::string value = argv[++i];
+            forceFormat = true;
+            format = value == "bc3" ? BlockFormat::BC3 : value == "bc4" ? BlockFormat::BC4 : value == "bc5" ? BlockFormat::BC5 : BlockFormat::BC1;
+        }
+        else
+        {
+            inputs.push_back(arg);
+        }
+    }
+
+    if (inputs.empty())
+    {
+        std::fprintf(stderr, "Usage: chaos-texcook [--kind color|normal|data] [--format bc1|bc3|bc4|bc5] [--alpha-cutoff <0-1>] <image>...\n"
+                             "       chaos-texcook --orm <output.ktx2> <occlusion|-> <roughness|-> <metallic|->\n");
+        return 1;
+    }
+
+    JobSystem::init();
+    int failures = 0;
+    for (const std::string& input : inputs)
+    {
+        if (!cook(input, kind, forceFormat, format, alphaCutoff))
+            failures++;
+    }
+    JobSystem::shutdown();
+    return failures == 0 ? 0 : 1;
+}